@@ -0,0 +1,346 @@
+/**
+ * @file sensor_bench.cpp
+ * @brief Reproducible micro and macro benchmarks for ingest, processing and statistics
+ *
+ * Every benchmark runs over the same synthetic dataset, generated from a
+ * fixed seed with a configurable row count and sensor cardinality, and is
+ * repeated to report min/median/mean wall time. Results are written as JSON
+ * or CSV so runs from different commits can be diffed or plotted.
+ */
+
+#include "DataIngester.h"
+#include "ReadingBatch.h"
+#include "SensorDataProcessor.h"
+#include "ValueKernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BenchConfig {
+    size_t rows = 1000000;
+    size_t sensors = 100;
+    size_t repeat = 5;
+    size_t threads = 1;
+    unsigned seed = 42;
+    std::string format = "json";
+    std::string outputPath;
+    std::string filter;
+    std::string scratchFile = "sensor_bench_data.csv";
+};
+
+struct BenchResult {
+    std::string name;
+    size_t rows;
+    size_t bytes;  // 0 when throughput in bytes is not meaningful
+    double minMs;
+    double medianMs;
+    double meanMs;
+};
+
+// Keeps results observable so the optimizer cannot drop the measured work
+volatile double benchSink = 0.0;
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [OPTIONS]\n"
+              << "Options:\n"
+              << "      --rows <num>       Rows in the synthetic dataset (default 1000000)\n"
+              << "      --sensors <num>    Distinct sensor IDs (default 100)\n"
+              << "      --repeat <num>     Timed runs per benchmark (default 5)\n"
+              << "      --threads <num>    Processor threads, 0 = all cores (default 1)\n"
+              << "      --seed <num>       Dataset seed (default 42)\n"
+              << "      --format <f>       json (default) or csv\n"
+              << "  -o, --output <path>    Write results to a file instead of stdout\n"
+              << "      --filter <text>    Run only benchmarks whose name contains <text>\n"
+              << "      --scratch <path>   Temporary CSV used by the file benchmarks\n"
+              << "  -h, --help             Show this help message\n";
+}
+
+/**
+ * @brief Deterministic dataset: per-type value ranges, ~1% outliers, increasing timestamps
+ */
+ReadingBatch makeDataset(const BenchConfig& config) {
+    std::mt19937_64 gen(config.seed);
+    std::uniform_int_distribution<size_t> sensor(0, std::max<size_t>(1, config.sensors) - 1);
+    std::uniform_int_distribution<int> type(0, 5);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double base[] = {22.0, 1013.0, 150.0, 5000.0, 0.5, 0.1};
+    const double spread[] = {2.0, 5.0, 10.0, 200.0, 0.2, 0.05};
+
+    std::vector<ReadingBatch::SensorKey> keys(std::max<size_t>(1, config.sensors));
+    for (size_t i = 0; i < keys.size(); ++i) {
+        std::ostringstream id;
+        id << "BENCH_" << std::setw(5) << std::setfill('0') << i;
+        keys[i] = SensorIdTable::global().intern(id.str());
+    }
+
+    ReadingBatch batch;
+    batch.reserve(config.rows);
+    int64_t timestamp = 1704067200000;
+    for (size_t row = 0; row < config.rows; ++row) {
+        int code = type(gen);
+        double value = base[code] + spread[code] * noise(gen);
+        if (unit(gen) < 0.01) {
+            value *= 10.0;  // Outlier
+        }
+        timestamp += 10;
+        batch.append(keys[sensor(gen)], static_cast<SensorReading::SensorType>(code),
+                     value, timestamp);
+    }
+    return batch;
+}
+
+/**
+ * @brief Time @p body @p repeat times; @p setup runs before each timed call, untimed
+ */
+BenchResult measure(const std::string& name, size_t rows, size_t bytes, size_t repeat,
+                    const std::function<void()>& setup, const std::function<void()>& body) {
+    std::vector<double> samples;
+    samples.reserve(repeat);
+    for (size_t run = 0; run < repeat; ++run) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto stop = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    BenchResult result;
+    result.name = name;
+    result.rows = rows;
+    result.bytes = bytes;
+    result.minMs = samples.front();
+    size_t mid = samples.size() / 2;
+    result.medianMs = samples.size() % 2 ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2.0;
+    result.meanMs = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    return result;
+}
+
+double rowsPerSecond(const BenchResult& result) {
+    return result.medianMs > 0.0 ? result.rows / (result.medianMs / 1000.0) : 0.0;
+}
+
+double megabytesPerSecond(const BenchResult& result) {
+    return result.medianMs > 0.0 ? (result.bytes / 1048576.0) / (result.medianMs / 1000.0) : 0.0;
+}
+
+void writeJson(std::ostream& out, const BenchConfig& config, const std::vector<BenchResult>& results) {
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n"
+        << "  \"config\": {\"rows\": " << config.rows
+        << ", \"sensors\": " << config.sensors
+        << ", \"repeat\": " << config.repeat
+        << ", \"threads\": " << config.threads
+        << ", \"seed\": " << config.seed
+        << ", \"isa\": \"" << ValueKernels::isaName(ValueKernels::activeIsa()) << "\"},\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\""
+            << ", \"rows\": " << r.rows
+            << ", \"bytes\": " << r.bytes
+            << ", \"min_ms\": " << r.minMs
+            << ", \"median_ms\": " << r.medianMs
+            << ", \"mean_ms\": " << r.meanMs
+            << ", \"rows_per_sec\": " << rowsPerSecond(r)
+            << ", \"mb_per_sec\": " << megabytesPerSecond(r) << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+void writeCsv(std::ostream& out, const std::vector<BenchResult>& results) {
+    out << std::setprecision(6) << std::fixed;
+    out << "name,rows,bytes,min_ms,median_ms,mean_ms,rows_per_sec,mb_per_sec\n";
+    for (const BenchResult& r : results) {
+        out << r.name << "," << r.rows << "," << r.bytes << "," << r.minMs << ","
+            << r.medianMs << "," << r.meanMs << "," << rowsPerSecond(r) << ","
+            << megabytesPerSecond(r) << "\n";
+    }
+}
+
+size_t fileSize(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file ? static_cast<size_t>(file.tellg()) : 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "-h" || arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            } else if (arg == "--rows" && hasValue) {
+                config.rows = std::stoul(argv[++i]);
+            } else if (arg == "--sensors" && hasValue) {
+                config.sensors = std::stoul(argv[++i]);
+            } else if (arg == "--repeat" && hasValue) {
+                config.repeat = std::max<size_t>(1, std::stoul(argv[++i]));
+            } else if (arg == "--threads" && hasValue) {
+                config.threads = std::stoul(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                config.seed = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--format" && hasValue) {
+                config.format = argv[++i];
+            } else if ((arg == "-o" || arg == "--output") && hasValue) {
+                config.outputPath = argv[++i];
+            } else if (arg == "--filter" && hasValue) {
+                config.filter = argv[++i];
+            } else if (arg == "--scratch" && hasValue) {
+                config.scratchFile = argv[++i];
+            } else {
+                std::cerr << "Unknown or incomplete option: " << arg << "\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Error: numeric option expected a number\n";
+        return 1;
+    }
+    if (config.format != "json" && config.format != "csv") {
+        std::cerr << "Error: --format requires json or csv\n";
+        return 1;
+    }
+
+    std::cerr << "Generating " << config.rows << " readings over " << config.sensors
+              << " sensors (seed " << config.seed << ")...\n";
+    const ReadingBatch dataset = makeDataset(config);
+    const std::vector<SensorReading> readings = dataset.toReadings();
+
+    DataIngester ingester;
+    SensorDataProcessor processor;
+    processor.setThreadCount(config.threads);
+    config.threads = processor.getThreadCount();
+
+    std::vector<BenchResult> results;
+    auto selected = [&config](const std::string& name) {
+        return config.filter.empty() || name.find(config.filter) != std::string::npos;
+    };
+    auto run = [&](const std::string& name, size_t rows, size_t bytes,
+                   const std::function<void()>& setup, const std::function<void()>& body) {
+        if (!selected(name)) {
+            return;
+        }
+        std::cerr << "  " << name << "...\n";
+        results.push_back(measure(name, rows, bytes, config.repeat, setup, body));
+    };
+    const auto noSetup = []() {};
+
+    try {
+        // File benchmarks share one CSV rendering of the dataset
+        if (!ingester.writeToFile(dataset, config.scratchFile)) {
+            std::cerr << "Error: cannot write scratch file " << config.scratchFile << "\n";
+            return 1;
+        }
+        const size_t csvBytes = fileSize(config.scratchFile);
+
+        std::vector<std::string> lines;
+        if (selected("parseCSVLine")) {
+            std::ifstream file(config.scratchFile);
+            std::string line;
+            std::getline(file, line);  // Header
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+        }
+        run("parseCSVLine", lines.size(), csvBytes, noSetup, [&]() {
+            SensorReading reading;
+            double total = 0.0;
+            for (const auto& line : lines) {
+                if (ingester.parseCSVLine(line, reading) == DataIngester::ParseStatus::OK) {
+                    total += reading.getValue();
+                }
+            }
+            benchSink = total;
+        });
+        std::vector<std::string>().swap(lines);
+
+        run("readFromFile", config.rows, csvBytes, noSetup, [&]() {
+            benchSink = static_cast<double>(ingester.readFromFile(config.scratchFile).size());
+        });
+        run("readBatchFromFile", config.rows, csvBytes, noSetup, [&]() {
+            benchSink = static_cast<double>(ingester.readBatchFromFile(config.scratchFile).size());
+        });
+        run("readBatchFromMappedFile", config.rows, csvBytes, noSetup, [&]() {
+            benchSink = static_cast<double>(
+                ingester.readBatchFromMappedFile(config.scratchFile, config.threads).size());
+        });
+        run("writeToFile", config.rows, csvBytes, noSetup, [&]() {
+            benchSink = ingester.writeToFile(dataset, config.scratchFile) ? 1.0 : 0.0;
+        });
+        std::remove(config.scratchFile.c_str());
+
+        // In-memory processing; inputs are copied in the untimed setup
+        ReadingBatch work;
+        auto copyDataset = [&]() { work = dataset; };
+        run("process", config.rows, 0, copyDataset, [&]() {
+            benchSink = static_cast<double>(processor.process(std::move(work)).size());
+        });
+        run("removeOutliers", config.rows, 0, noSetup, [&]() {
+            benchSink = static_cast<double>(processor.removeOutliers(dataset).size());
+        });
+        run("calculateStatistics", config.rows, 0, noSetup, [&]() {
+            benchSink = processor.calculateStatistics(dataset).mean;
+        });
+        run("calculateStatisticsByType", config.rows, 0, noSetup, [&]() {
+            benchSink = static_cast<double>(processor.calculateStatisticsByType(dataset).size());
+        });
+        run("calculateStatisticsBySensorId", config.rows, 0, noSetup, [&]() {
+            benchSink = static_cast<double>(processor.calculateStatisticsBySensorId(dataset).size());
+        });
+        run("calculateGroupedStatistics.typeAndSensor", config.rows, 0, noSetup, [&]() {
+            benchSink = static_cast<double>(
+                processor.calculateGroupedStatistics(dataset, GroupBy::TYPE_AND_SENSOR).size());
+        });
+        run("normalizeValues", config.rows, 0, copyDataset, [&]() {
+            processor.normalizeValues(work);
+            benchSink = work.values()[0];
+        });
+
+        // The vector-of-readings API, for comparison with the columnar one
+        std::vector<SensorReading> workReadings;
+        run("process.vector", config.rows, 0, [&]() { workReadings = readings; }, [&]() {
+            benchSink = static_cast<double>(processor.process(std::move(workReadings)).size());
+        });
+        run("calculateStatistics.vector", config.rows, 0, noSetup, [&]() {
+            benchSink = processor.calculateStatistics(readings).mean;
+        });
+    } catch (const std::exception& e) {
+        std::remove(config.scratchFile.c_str());
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!config.outputPath.empty()) {
+        file.open(config.outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Error: cannot write " << config.outputPath << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = config.outputPath.empty() ? std::cout : file;
+    if (config.format == "csv") {
+        writeCsv(out, results);
+    } else {
+        writeJson(out, config, results);
+    }
+    return 0;
+}
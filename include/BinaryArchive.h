@@ -0,0 +1,186 @@
+#ifndef BINARY_ARCHIVE_H
+#define BINARY_ARCHIVE_H
+
+#include "SensorReading.h"
+#include "ReadingBatch.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Binary columnar sensor archive (.sdb) and the primitives it shares
+ * with the compressed archive (.sdc)
+ *
+ * Layout: a header with the column schema, the type-name dictionary and the
+ * sensor-ID dictionary, followed by row groups of fixed-width value,
+ * timestamp, type-code and sensor-index columns. Numbers are stored in
+ * native byte order with a byte-order mark.
+ */
+namespace BinaryArchive {
+
+const uint32_t kByteOrderMark = 0x01020304;
+
+template <typename T>
+void writePod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief Write a length-prefixed string
+ */
+void writeString(std::ostream& out, const std::string& str);
+
+/**
+ * @brief Write the type-name dictionary: count, then every name by code
+ */
+void writeTypeDictionary(std::ostream& out);
+
+/**
+ * @brief Write a sensor-ID dictionary: count, then every ID in order
+ */
+void writeSensorDictionary(std::ostream& out, const std::vector<SensorReading::SensorKey>& sensors);
+
+/**
+ * @brief Bounds-checked cursor over a mapped archive
+ *
+ * Every read throws std::runtime_error naming the file if it would run past
+ * the end of the range.
+ */
+class Cursor {
+public:
+    Cursor(const char* data, size_t size, const std::string& filepath)
+        : data_(data), size_(size), offset_(0), filepath_(filepath) {}
+
+    const char* take(size_t bytes) {
+        if (bytes > size_ - offset_) {
+            throw std::runtime_error("Truncated sensor archive: " + filepath_);
+        }
+        const char* ptr = data_ + offset_;
+        offset_ += bytes;
+        return ptr;
+    }
+
+    template <typename T>
+    T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string_view readString() {
+        uint32_t length = read<uint32_t>();
+        return std::string_view(take(length), length);
+    }
+
+    size_t remaining() const { return size_ - offset_; }
+
+    /**
+     * @brief Reject a header count before allocating for it
+     *
+     * @p count entries of at least @p minBytes each must fit in the unread
+     * part of the range.
+     */
+    void requireFits(uint64_t count, size_t minBytes) const {
+        if (count > remaining() / minBytes) {
+            throw std::runtime_error("Truncated sensor archive: " + filepath_);
+        }
+    }
+
+    const std::string& filepath() const { return filepath_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t offset_;
+    const std::string& filepath_;
+};
+
+/**
+ * @brief Read a type-name dictionary into types indexed by file code
+ *
+ * Types are matched by name so archives survive enum reordering.
+ * @throws std::runtime_error on an unknown name or truncated data
+ */
+std::vector<SensorReading::SensorType> readTypeDictionary(Cursor& cursor);
+
+/**
+ * @brief Read a sensor-ID dictionary, interning every ID
+ * @throws std::runtime_error on truncated data
+ */
+std::vector<SensorReading::SensorKey> readSensorDictionary(Cursor& cursor);
+
+/**
+ * @brief Read a binary columnar sensor archive (.sdb)
+ *
+ * The file is memory-mapped and the value and timestamp columns are copied
+ * straight into the batch; only type codes and sensor indexes are translated.
+ * @throws std::runtime_error if file cannot be opened or is not a valid archive
+ */
+ReadingBatch read(const std::string& filepath);
+
+}  // namespace BinaryArchive
+
+/**
+ * @brief Writes a binary sensor archive (.sdb) incrementally, one batch at a time
+ *
+ * Produces the same layout as DataIngester::writeBinaryFile, so data larger
+ * than memory can be archived as it is produced. The sensor dictionary sits
+ * in the header ahead of the row groups, so it is fixed when the writer is
+ * opened; the row and row-group counts are patched into the header by close().
+ */
+class BinaryArchiveWriter {
+public:
+    /**
+     * @brief Open @p filepath and write the header; check isOpen() afterwards
+     * @param sensors Every sensor key the rows may carry, in dictionary order
+     * @param rowGroupRows Maximum rows per row group
+     */
+    BinaryArchiveWriter(const std::string& filepath,
+                        const std::vector<SensorReading::SensorKey>& sensors,
+                        size_t rowGroupRows = 1 << 16);
+
+    /**
+     * @brief Close the archive if close() was not called
+     */
+    ~BinaryArchiveWriter();
+
+    BinaryArchiveWriter(const BinaryArchiveWriter&) = delete;
+    BinaryArchiveWriter& operator=(const BinaryArchiveWriter&) = delete;
+
+    bool isOpen() const { return file_.is_open(); }
+
+    /**
+     * @brief Append a batch as one or more row groups
+     * @return true if the stream is still good
+     * @throws std::invalid_argument if a row's sensor is not in the dictionary
+     */
+    bool write(const ReadingBatch& batch);
+
+    /**
+     * @brief Record the final row counts and close the file
+     * @return true if everything was written successfully
+     */
+    bool close();
+
+    uint64_t rowCount() const { return rowCount_; }
+
+private:
+    static constexpr uint32_t kUnassigned = UINT32_MAX;
+
+    std::ofstream file_;
+    std::vector<uint32_t> localIndex_;  // Global sensor key -> dictionary index
+    size_t rowGroupRows_;
+    uint64_t rowCount_;
+    uint64_t rowGroupCount_;
+    std::streampos countsOffset_;
+    std::vector<uint8_t> typeCodes_;      // Per-group column scratch
+    std::vector<uint32_t> sensorIndexes_;
+};
+
+#endif // BINARY_ARCHIVE_H
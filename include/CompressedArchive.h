@@ -0,0 +1,155 @@
+#ifndef COMPRESSED_ARCHIVE_H
+#define COMPRESSED_ARCHIVE_H
+
+#include "SensorReading.h"
+#include "ReadingBatch.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Writes a compressed sensor archive (.sdc) incrementally
+ *
+ * Incoming rows are routed to per-(sensor, type) streams; whenever a stream
+ * holds blockRows rows it is encoded with TimeSeriesCodec and written out
+ * as one block. Layout: a short header (magic, version, byte order), the
+ * blocks, then a footer with the type-name and sensor-ID dictionaries and a
+ * block directory (stream, row count, timestamp and value range, offset,
+ * size), and finally the footer offset and magic. Keeping the dictionaries
+ * in the footer means the sensor set need not be known up front; memory is
+ * bounded by one partial block per stream.
+ */
+class CompressedArchiveWriter {
+public:
+    static constexpr size_t kDefaultBlockRows = 4096;
+    static constexpr size_t kMaxBlockRows = 1 << 20;  // Readers reject larger blocks
+
+    /**
+     * @brief Open @p filepath and write the header; check isOpen() afterwards
+     * @param blockRows Maximum rows per block, clamped to [1, kMaxBlockRows]
+     */
+    explicit CompressedArchiveWriter(const std::string& filepath,
+                                     size_t blockRows = kDefaultBlockRows);
+
+    /**
+     * @brief Close the archive if close() was not called
+     */
+    ~CompressedArchiveWriter();
+
+    CompressedArchiveWriter(const CompressedArchiveWriter&) = delete;
+    CompressedArchiveWriter& operator=(const CompressedArchiveWriter&) = delete;
+
+    bool isOpen() const { return file_.is_open(); }
+
+    /**
+     * @brief Route a batch's rows to their streams, writing every full block
+     * @return true if the stream is still good
+     */
+    bool write(const ReadingBatch& batch);
+
+    /**
+     * @brief Write the partial blocks and the footer, then close the file
+     * @return true if everything was written successfully
+     */
+    bool close();
+
+    uint64_t rowCount() const { return rowCount_; }
+
+private:
+    static constexpr uint32_t kUnassigned = UINT32_MAX;
+
+    struct Stream {
+        SensorReading::SensorKey sensorKey;
+        SensorReading::SensorType type;
+        std::vector<int64_t> timestamps;
+        std::vector<double> values;
+    };
+
+    struct BlockEntry {
+        uint32_t stream;
+        uint32_t rows;
+        int64_t minTimestamp;
+        int64_t maxTimestamp;
+        double minValue;
+        double maxValue;
+        uint64_t offset;
+        uint32_t bytes;
+    };
+
+    /**
+     * @brief Encode and write the pending rows of a stream as one block
+     */
+    void flushStream(uint32_t stream);
+
+    std::ofstream file_;
+    size_t blockRows_;
+    uint64_t rowCount_;
+    uint64_t offset_;                    // Bytes written so far
+    std::vector<uint32_t> streamIndex_;  // Sensor key * type count + type -> stream
+    std::vector<Stream> streams_;        // In first-seen order
+    std::vector<BlockEntry> blocks_;
+    std::vector<uint8_t> encoded_;       // Block scratch
+};
+
+/**
+ * @brief Random access to the blocks of a compressed sensor archive (.sdc)
+ *
+ * Opening the archive maps the file and reads only the footer; blocks are
+ * decoded on demand, so a caller can use the block summaries to pick the
+ * blocks it needs and feed them to SensorDataProcessor as a ReadingBatch.
+ */
+class CompressedArchiveReader {
+public:
+    /**
+     * @brief Summary of one block, taken from the archive footer
+     */
+    struct Block {
+        SensorReading::SensorKey sensorKey;
+        SensorReading::SensorType type;
+        uint32_t rows;
+        int64_t minTimestamp;
+        int64_t maxTimestamp;
+        double minValue;
+        double maxValue;
+    };
+
+    /**
+     * @brief Map @p filepath and read its footer
+     * @throws std::runtime_error if file cannot be opened or is not a valid archive
+     */
+    explicit CompressedArchiveReader(const std::string& filepath);
+
+    const std::vector<Block>& blocks() const { return blocks_; }
+    uint64_t rowCount() const { return rowCount_; }
+    size_t fileSize() const { return mapped_.size(); }
+
+    /**
+     * @brief Decode block @p index and append its rows to @p batch
+     * @throws std::runtime_error if the block is corrupt
+     */
+    void decodeBlock(size_t index, ReadingBatch& batch) const;
+
+    /**
+     * @brief Decode every block, in directory order, into one batch
+     * @param threadCount Number of decoder threads (0 = hardware concurrency)
+     */
+    ReadingBatch readAll(size_t threadCount = 1) const;
+
+private:
+    /**
+     * @brief Decode block @p index into rows starting at @p row of @p batch
+     */
+    void decodeInto(size_t index, ReadingBatch& batch, size_t row) const;
+
+    std::string filepath_;
+    MappedFile mapped_;
+    std::vector<Block> blocks_;
+    std::vector<uint64_t> offsets_;  // Block byte offsets and sizes, parallel to blocks_
+    std::vector<uint32_t> sizes_;
+    uint64_t rowCount_;
+};
+
+#endif // COMPRESSED_ARCHIVE_H
@@ -0,0 +1,81 @@
+#ifndef CSV_WRITER_H
+#define CSV_WRITER_H
+
+#include "SensorReading.h"
+#include "ReadingBatch.h"
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @brief Buffered CSV formatter for readings
+ *
+ * Rows are formatted into large reusable buffers with std::to_chars (shortest
+ * representation that parses back to the same double, no locale) and a
+ * static type-name table, then handed to the stream in one write() per chunk
+ * of rows, so a file is written with a few large writes rather than one
+ * formatted insertion per field. Sensor IDs are resolved once per key.
+ *
+ * With more than one thread, chunks of a batch are formatted in parallel and
+ * written in order, so the output is identical for every thread count.
+ */
+class CsvWriter {
+public:
+    /**
+     * @brief Write to @p out, which must outlive the writer
+     */
+    explicit CsvWriter(std::ostream& out);
+    ~CsvWriter();
+
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    /**
+     * @brief Threads used to format each batch (0 = hardware concurrency, 1 = serial)
+     */
+    void setThreadCount(size_t threadCount);
+
+    /**
+     * @brief Write the CSV header line to @p out
+     */
+    static void writeHeader(std::ostream& out);
+
+    /**
+     * @brief Append a batch as CSV rows (no header)
+     * @return true if the stream is still good
+     */
+    bool write(const ReadingBatch& batch);
+
+    /**
+     * @brief Append readings as CSV rows (no header)
+     * @return true if the stream is still good
+     */
+    bool write(const std::vector<SensorReading>& readings);
+
+    /**
+     * @brief Bytes handed to the stream so far
+     */
+    size_t bytesWritten() const { return bytesWritten_; }
+
+private:
+    // Rows per formatted chunk: about 1.5 MB of text, one write() each
+    static constexpr size_t kChunkRows = size_t(1) << 16;
+
+    template <typename KeyFn, typename TypeFn, typename ValueFn, typename TimeFn>
+    size_t formatRows(size_t begin, size_t end, KeyFn sensorKey, TypeFn type,
+                      ValueFn value, TimeFn timestamp, std::vector<char>& buffer) const;
+    void refreshNames();
+
+    std::ostream& out_;
+    std::vector<std::string_view> names_;  // Sensor key -> ID, views into the ID table
+    std::vector<std::vector<char>> buffers_;  // One per in-flight chunk, reused
+    std::vector<size_t> used_;
+    size_t bytesWritten_;
+    std::shared_ptr<ThreadPool> pool_;  // Null when serial
+};
+
+#endif // CSV_WRITER_H
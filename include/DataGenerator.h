@@ -0,0 +1,124 @@
+#ifndef DATA_GENERATOR_H
+#define DATA_GENERATOR_H
+
+#include "SensorReading.h"
+#include "ReadingBatch.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @brief Shape of a generated dataset
+ */
+struct GeneratorOptions {
+    uint64_t seed;
+    size_t sensorCount;
+    std::vector<SensorReading::SensorType> types;  // Assigned to sensors round-robin
+    int64_t startTimestamp;   // Milliseconds
+    int64_t intervalMs;       // Sampling period of each sensor
+    double noiseFraction;     // Noise standard deviation, as a fraction of the type's range
+    double driftFraction;     // Largest baseline drift per hour, as a fraction of the type's range
+    double outlierRate;       // Probability that a reading is an injected spike
+
+    GeneratorOptions()
+        : seed(1), sensorCount(4),
+          types{SensorReading::SensorType::TEMPERATURE, SensorReading::SensorType::PRESSURE,
+                SensorReading::SensorType::DEPTH, SensorReading::SensorType::SONAR},
+          startTimestamp(1704067200000), intervalMs(1000),
+          noiseFraction(0.01), driftFraction(0.02), outlierRate(0.001) {}
+};
+
+/**
+ * @brief Deterministic, parallel generator of realistic sensor time series
+ *
+ * Row i belongs to sensor i % sensorCount and is that sensor's
+ * (i / sensorCount)-th sample, so timestamps rise monotonically per sensor
+ * and across the dataset. Each sensor has its own baseline, linear drift and
+ * daily cycle; every reading adds Gaussian noise and, at outlierRate, a spike
+ * several ranges away from the baseline.
+ *
+ * All randomness comes from a counter-based generator: a value is a hash of
+ * (seed, stream, row), not the next state of a sequential engine. Any range
+ * of rows can therefore be generated independently, on any thread, and the
+ * output for a seed is identical for every thread count and chunk size.
+ */
+class DataGenerator {
+public:
+    static constexpr size_t kDefaultChunkRows = size_t(1) << 20;
+
+    /**
+     * @brief Prepare per-sensor profiles and intern sensor IDs SENSOR_000, SENSOR_001, ...
+     * @throws std::invalid_argument if sensorCount is 0, types is empty or intervalMs <= 0
+     */
+    explicit DataGenerator(const GeneratorOptions& options);
+    ~DataGenerator();
+
+    DataGenerator(const DataGenerator&) = delete;
+    DataGenerator& operator=(const DataGenerator&) = delete;
+
+    /**
+     * @brief Threads used to fill each batch (0 = hardware concurrency, 1 = serial)
+     */
+    void setThreadCount(size_t threadCount);
+
+    /**
+     * @brief Replace @p batch with rows [firstRow, firstRow + count) of the dataset
+     */
+    void generate(uint64_t firstRow, size_t count, ReadingBatch& batch) const;
+
+    /**
+     * @brief The first @p count rows of the dataset
+     */
+    ReadingBatch generate(size_t count) const;
+
+    /**
+     * @brief Stream the first @p count rows to a CSV file, or a .sdb or .sdc archive by extension
+     *
+     * Rows are generated and written chunk by chunk, so memory use is bounded
+     * by @p chunkRows whatever the row count.
+     * @return Rows written
+     * @throws std::runtime_error if the file cannot be written
+     */
+    uint64_t writeFile(const std::string& filepath, uint64_t count,
+                       size_t chunkRows = kDefaultChunkRows) const;
+
+    /**
+     * @brief Interned key of every generated sensor, in sensor order
+     */
+    const std::vector<SensorReading::SensorKey>& sensorKeys() const { return sensorKeys_; }
+
+    /**
+     * @brief 64 random bits for position @p counter of stream @p key
+     *
+     * A SplitMix64-style finalizer over the key-offset counter: a bijective
+     * mix, so distinct counters never collide within a stream.
+     */
+    static uint64_t counterRandom(uint64_t key, uint64_t counter);
+
+private:
+    struct SensorProfile {
+        SensorReading::SensorType type;
+        double baseline;
+        double driftPerSample;
+        double cycleAmplitude;
+        double cyclePhase;
+        double noiseSigma;
+        double span;  // Width of the type's nominal value range
+    };
+
+    double uniform(uint64_t stream, uint64_t counter) const;
+    void fillRows(uint64_t firstRow, size_t begin, size_t end, ReadingBatch& batch) const;
+
+    GeneratorOptions options_;
+    std::vector<uint64_t> streamKeys_;  // Per random stream, derived from the seed
+    std::vector<SensorProfile> profiles_;
+    std::vector<SensorReading::SensorKey> sensorKeys_;
+    double cycleStep_;  // Daily-cycle phase advance per sample
+    std::shared_ptr<ThreadPool> pool_;  // Null when serial
+};
+
+#endif // DATA_GENERATOR_H
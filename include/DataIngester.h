@@ -2,9 +2,15 @@
 #define DATA_INGESTER_H
 
 #include "SensorReading.h"
+#include "ReadingBatch.h"
+#include "TimeIndexedStore.h"
 #include <vector>
 #include <string>
+#include <string_view>
 #include <fstream>
+#include <ostream>
+#include <functional>
+#include <cstdint>
 
 /**
  * @brief Handles ingestion of sensor data from various sources
@@ -14,19 +20,125 @@
  */
 class DataIngester {
 public:
+    /**
+     * @brief Outcome of parsing a single CSV record
+     */
+    enum class ParseStatus {
+        OK,
+        MISSING_COLUMNS,
+        INVALID_VALUE,
+        INVALID_TIMESTAMP
+    };
+
+    /**
+     * @brief On-disk format of a readings file
+     */
+    enum class FileFormat {
+        CSV,
+        BINARY_ARCHIVE,     // .sdb
+        COMPRESSED_ARCHIVE  // .sdc
+    };
+
+    /**
+     * @brief Row counters from the most recent file read
+     */
+    struct IngestStats {
+        size_t rowsAccepted;
+        size_t rowsRejected;  // Malformed records plus invalid readings
+
+        IngestStats() : rowsAccepted(0), rowsRejected(0) {}
+    };
+
     DataIngester();
     ~DataIngester() = default;
 
+    /**
+     * @brief Format of @p filepath by extension: .sdb and .sdc are archives,
+     * anything else is CSV
+     */
+    static FileFormat formatOf(const std::string& filepath);
+
     /**
      * @brief Read sensor readings from a CSV file
      * @param filepath Path to CSV file
      * @return Vector of sensor readings
-     * @throws std::runtime_error if file cannot be opened or parsed
+     * @throws std::runtime_error if file cannot be opened
      */
     std::vector<SensorReading> readFromFile(const std::string& filepath);
 
+    /**
+     * @brief Read sensor readings from a CSV file straight into columns
+     * @param filepath Path to CSV file
+     * @return Columnar batch of sensor readings
+     * @throws std::runtime_error if file cannot be opened
+     */
+    ReadingBatch readBatchFromFile(const std::string& filepath);
+
+    /**
+     * @brief Read sensor readings from a memory-mapped CSV file
+     *
+     * Scans the mapped file in place with string_view tokens, so no memory is
+     * allocated per line. Accepts the same format as readFromFile. With more
+     * than one thread the file is parsed in parallel (see readShardsFromMappedFile)
+     * and the shards are concatenated, so rows keep their file order.
+     * @param filepath Path to CSV file
+     * @param threadCount Number of parser threads (0 = hardware concurrency)
+     * @return Columnar batch of sensor readings
+     * @throws std::runtime_error if file cannot be opened or mapped
+     */
+    ReadingBatch readBatchFromMappedFile(const std::string& filepath,
+                                         size_t threadCount = 1);
+
+    /**
+     * @brief Parse a memory-mapped CSV file in parallel, one shard per thread
+     *
+     * The file is split into byte ranges aligned to newline boundaries and
+     * each range is parsed on its own thread. Shard i holds the rows of the
+     * i-th range, so reading the shards in order gives the file order.
+     * @param filepath Path to CSV file
+     * @param threadCount Number of parser threads (0 = hardware concurrency)
+     * @return Shards in file order
+     * @throws std::runtime_error if file cannot be opened or mapped
+     */
+    std::vector<ReadingBatch> readShardsFromMappedFile(const std::string& filepath,
+                                                       size_t threadCount);
+
+    /**
+     * @brief Stream a CSV file through a callback in fixed-size batches
+     *
+     * Only one batch is held in memory at a time, so files larger than RAM
+     * can be processed. The batch passed to @p callback is reused after the
+     * call returns.
+     * @param filepath Path to CSV file
+     * @param batchRows Maximum rows per batch
+     * @param callback Invoked for every batch, in file order
+     * @throws std::runtime_error if file cannot be opened
+     */
+    void streamFromFile(const std::string& filepath, size_t batchRows,
+                        const std::function<void(const ReadingBatch&)>& callback);
+
+    /**
+     * @brief Parse a single CSV record without allocating or throwing
+     *
+     * Numbers are parsed with std::from_chars (locale-independent) and must
+     * span the whole field. Unknown type names fall back to TEMPERATURE, as
+     * in SensorReading::stringToType.
+     * @param line CSV record (no trailing newline)
+     * @param reading Set to the parsed reading when OK is returned
+     * @return OK, or the reason the record was rejected
+     */
+    ParseStatus parseCSVLine(std::string_view line, SensorReading& reading) const;
+
+    /**
+     * @brief Counters for the most recent readFromFile/readBatchFrom* call
+     */
+    const IngestStats& getLastIngestStats() const { return lastStats_; }
+
     /**
      * @brief Generate simulated sensor data
+     *
+     * Readings are random and unseeded; DataGenerator produces reproducible,
+     * realistic time series and scales to datasets larger than memory.
      * @param count Number of readings to generate
      * @param sensorIds Vector of sensor IDs to use
      * @param types Vector of sensor types to use
@@ -46,23 +158,123 @@ public:
     bool writeToFile(const std::vector<SensorReading>& readings,
                      const std::string& filepath) const;
 
+    /**
+     * @brief Write a columnar batch to CSV file
+     *
+     * Rows are formatted by CsvWriter; values are written in their shortest
+     * round-trip form.
+     * @param batch Readings to write
+     * @param filepath Output file path
+     * @param threadCount Threads formatting chunks of rows (0 = hardware concurrency)
+     * @return true if successful, false otherwise
+     */
+    bool writeToFile(const ReadingBatch& batch,
+                     const std::string& filepath, size_t threadCount = 1) const;
+
+    /**
+     * @brief Write the CSV header line
+     */
+    static void writeCSVHeader(std::ostream& out);
+
+    /**
+     * @brief Check whether a first line is the CSV header
+     */
+    static bool isHeaderLine(std::string_view line);
+
+    /**
+     * @brief Append a batch as CSV rows (no header), for incremental output
+     * @return true if the stream is still good
+     */
+    bool writeCSVRows(const ReadingBatch& batch, std::ostream& out) const;
+
+    /**
+     * @brief Write a batch in the binary columnar sensor archive format (.sdb)
+     *
+     * See BinaryArchive for the layout.
+     * @param batch Readings to write
+     * @param filepath Output file path
+     * @param rowGroupRows Rows per row group
+     * @return true if successful, false otherwise
+     */
+    bool writeBinaryFile(const ReadingBatch& batch, const std::string& filepath,
+                         size_t rowGroupRows = 1 << 16) const;
+
+    /**
+     * @brief Read a binary columnar sensor archive (.sdb)
+     *
+     * See BinaryArchive::read.
+     * @param filepath Path to .sdb file
+     * @return Columnar batch of sensor readings
+     * @throws std::runtime_error if file cannot be opened or is not a valid archive
+     */
+    ReadingBatch readBinaryFile(const std::string& filepath);
+
+    /**
+     * @brief Write a batch as a compressed sensor archive (.sdc)
+     *
+     * Rows are split into per-(sensor, type) streams and each stream is cut
+     * into blocks encoded by TimeSeriesCodec. See CompressedArchiveWriter.
+     * @param batch Readings to write
+     * @param filepath Output file path
+     * @param blockRows Maximum rows per block
+     * @return true if successful, false otherwise
+     */
+    bool writeCompressedFile(const ReadingBatch& batch, const std::string& filepath,
+                             size_t blockRows = 4096) const;
+
+    /**
+     * @brief Read a compressed sensor archive (.sdc)
+     *
+     * Rows come back block by block in the order the blocks were written;
+     * each block holds consecutive readings of one stream, so the original
+     * order is kept within a stream but not across streams.
+     * @param filepath Path to .sdc file
+     * @param threadCount Number of decoder threads (0 = hardware concurrency)
+     * @return Columnar batch of sensor readings
+     * @throws std::runtime_error if file cannot be opened or is not a valid archive
+     */
+    ReadingBatch readCompressedFile(const std::string& filepath, size_t threadCount = 1);
+
+    /**
+     * @brief Load a CSV, .sdb or .sdc file into a store ordered and indexed by timestamp
+     *
+     * Files ending in .sdb or .sdc are read as binary or compressed
+     * archives; anything else is parsed as CSV with the memory-mapped reader.
+     * @param filepath Path to the input file
+     * @param threadCount Number of CSV parser threads (0 = hardware concurrency)
+     * @param blockRows Rows per block summary
+     * @throws std::runtime_error if file cannot be opened or parsed
+     */
+    TimeIndexedStore readTimeIndexedFile(const std::string& filepath, size_t threadCount = 1,
+                                         size_t blockRows = TimeIndexedStore::kDefaultBlockRows);
+
 private:
     /**
-     * @brief Parse a single line from CSV file
-     * @param line CSV line
-     * @return SensorReading object
+     * @brief Invoke @p sink for every valid reading parsed from a CSV file
+     * @throws std::runtime_error if file cannot be opened
      */
-    SensorReading parseCSVLine(const std::string& line);
+    template <typename Sink>
+    void forEachCSVReading(const std::string& filepath, Sink&& sink);
 
     /**
-     * @brief Get current timestamp in milliseconds
+     * @brief Parse one record, update counters and pass valid readings to @p sink
      */
-    int64_t getCurrentTimestamp() const;
+    template <typename Sink>
+    void ingestRecord(std::string_view line, IngestStats& stats, Sink& sink) const;
 
     /**
-     * @brief Generate random value within range
+     * @brief Parse every record in [begin, end) of a mapped file into @p batch
+     * @param skipHeader Check the first line for a header (start of file only)
      */
-    double generateRandomValue(double min, double max) const;
+    void parseMappedRange(const char* begin, const char* end, bool skipHeader,
+                          ReadingBatch& batch, IngestStats& stats) const;
+
+    /**
+     * @brief Get current timestamp in milliseconds
+     */
+    int64_t getCurrentTimestamp() const;
+
+    IngestStats lastStats_;
 };
 
 #endif // DATA_INGESTER_H
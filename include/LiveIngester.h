@@ -0,0 +1,82 @@
+#ifndef LIVE_INGESTER_H
+#define LIVE_INGESTER_H
+
+#include "DataIngester.h"
+#include "ReadingBatch.h"
+#include "SpscRing.h"
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <istream>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Reads newline-delimited CSV readings from a live stream on a dedicated thread
+ *
+ * The reader thread parses each line of the input (stdin, a named pipe or a
+ * growing file) with the same rules as DataIngester and pushes valid readings
+ * into a lock-free SpscRing. The processing thread drains the ring with poll()
+ * in batches. When the ring is full the reader waits, so memory stays bounded
+ * and a fast writer is throttled through the pipe rather than buffered here.
+ */
+class LiveIngester {
+public:
+    static constexpr size_t kDefaultRingCapacity = 1 << 16;
+
+    /**
+     * @brief Start the reader thread on @p input
+     * @param input Stream read until end of file; must outlive the ingester
+     * @param ringCapacity Readings buffered between reader and consumer
+     */
+    explicit LiveIngester(std::istream& input, size_t ringCapacity = kDefaultRingCapacity);
+
+    /**
+     * @brief Stop the reader and wait for it
+     *
+     * A reader blocked waiting for input is only released by the input
+     * delivering a line or ending, so destroy the ingester after finished().
+     */
+    ~LiveIngester();
+
+    LiveIngester(const LiveIngester&) = delete;
+    LiveIngester& operator=(const LiveIngester&) = delete;
+
+    /**
+     * @brief Move up to @p maxRows queued readings onto the end of @p batch without blocking
+     * @return Number of readings appended (0 if none are queued yet)
+     * @throws Whatever stopped the reader thread, once every reading before it was drained
+     */
+    size_t poll(ReadingBatch& batch, size_t maxRows);
+
+    /**
+     * @brief True once the input has ended and every reading has been polled
+     */
+    bool finished() const;
+
+    size_t rowsAccepted() const { return rowsAccepted_.load(std::memory_order_relaxed); }
+    size_t rowsRejected() const { return rowsRejected_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Times the reader found the ring full and had to wait for the consumer
+     */
+    size_t fullWaits() const { return fullWaits_.load(std::memory_order_relaxed); }
+
+private:
+    void readLoop();
+    bool push(const SensorReading& reading);
+
+    std::istream& input_;
+    DataIngester parser_;
+    SpscRing<SensorReading> ring_;
+    std::vector<SensorReading> drained_;  // Consumer-side staging for tryPopBulk
+    std::atomic<bool> inputDone_;
+    std::atomic<bool> stop_;
+    std::atomic<size_t> rowsAccepted_;
+    std::atomic<size_t> rowsRejected_;
+    std::atomic<size_t> fullWaits_;
+    std::exception_ptr error_;  // Written by the reader before inputDone_ is set
+    std::thread reader_;
+};
+
+#endif // LIVE_INGESTER_H
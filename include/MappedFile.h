@@ -0,0 +1,52 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * Lets the ingester scan file contents in place through string_views instead
+ * of copying each line into a std::string. Pipes and other files that cannot
+ * be mapped, and every file on platforms without mmap, are read into a
+ * single buffer instead, so callers see the same API.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Map a file for reading
+     * @param filepath Path to file
+     * @throws std::runtime_error if file cannot be opened, mapped or read
+     */
+    explicit MappedFile(const std::string& filepath);
+    ~MappedFile();
+
+    /**
+     * @brief Whether @p filepath names a regular file, which is mapped in place
+     *
+     * Anything else (pipes, devices, missing paths) gives false.
+     */
+    static bool isRegularFile(const std::string& filepath);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Whole file contents as a view
+     */
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+private:
+    const char* data_;
+    size_t size_;
+    bool mapped_;
+    std::vector<char> buffer_;  // Contents when the file is not mapped
+};
+
+#endif // MAPPED_FILE_H
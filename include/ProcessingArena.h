@@ -0,0 +1,66 @@
+#ifndef PROCESSING_ARENA_H
+#define PROCESSING_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @brief Monotonic memory arena for the scratch buffers of a processing run
+ *
+ * Wraps std::pmr::monotonic_buffer_resource over one buffer allocated up
+ * front: allocation bumps a pointer, deallocation is a no-op, and release()
+ * rewinds to the start of the buffer so the next phase or batch reuses the
+ * same, already faulted-in, memory. Requests that do not fit spill to the
+ * heap in geometrically growing chunks, all freed by the next release().
+ *
+ * Not thread-safe: only the thread driving the processor may allocate from
+ * it, which is how SensorDataProcessor uses its scratch resource.
+ */
+class ProcessingArena {
+public:
+    /**
+     * @brief Allocate the arena's buffer
+     * @param capacityBytes Size of the up-front buffer (at least 4 KB)
+     */
+    explicit ProcessingArena(size_t capacityBytes);
+
+    ProcessingArena(const ProcessingArena&) = delete;
+    ProcessingArena& operator=(const ProcessingArena&) = delete;
+
+    /**
+     * @brief Resource to hand to SensorDataProcessor::setScratchResource
+     */
+    std::pmr::memory_resource* resource() { return &arena_; }
+
+    /**
+     * @brief Drop every allocation at once and rewind to the up-front buffer
+     */
+    void release() { arena_.release(); }
+
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Heap chunks the arena needed beyond its buffer, over its lifetime
+     */
+    size_t spillCount() const { return spill_.count; }
+
+private:
+    /**
+     * @brief Heap resource that counts the chunks it hands out
+     */
+    struct SpillResource : std::pmr::memory_resource {
+        size_t count = 0;
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    size_t capacity_;
+    std::unique_ptr<std::byte[]> buffer_;
+    SpillResource spill_;
+    std::pmr::monotonic_buffer_resource arena_;
+};
+
+#endif // PROCESSING_ARENA_H
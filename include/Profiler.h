@@ -0,0 +1,156 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#ifndef SENSOR_PROFILING
+#define SENSOR_PROFILING 0
+#endif
+
+/**
+ * @brief Process-wide stage timers and counters behind --profile
+ *
+ * Instrumentation points use the PROFILE_SCOPE and PROFILE_COUNT macros. Each
+ * point resolves its named site once (a function-local static), so a timed
+ * scope afterwards costs one relaxed load of the enabled flag, plus two clock
+ * reads and two relaxed atomic adds while profiling is on. Stage times are
+ * inclusive: a stage nested in another counts toward both.
+ *
+ * Building with SENSOR_PROFILING=0 (CMake option ENABLE_PROFILING=OFF) turns
+ * both macros into nothing and drops the allocation counter.
+ */
+class Profiler {
+public:
+    enum class Kind {
+        STAGE,
+        COUNTER
+    };
+
+    struct Site {
+        std::string name;
+        Kind kind;
+        std::atomic<uint64_t> calls;
+        std::atomic<uint64_t> total;  // Nanoseconds for stages, summed amount for counters
+
+        Site(const std::string& siteName, Kind siteKind)
+            : name(siteName), kind(siteKind), calls(0), total(0) {}
+    };
+
+    static Profiler& instance();
+
+    /**
+     * @brief Whether instrumentation was compiled in
+     */
+    static constexpr bool compiledIn() { return SENSOR_PROFILING != 0; }
+
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Site registered under @p name, created on first use
+     */
+    Site& site(const char* name, Kind kind);
+
+    /**
+     * @brief Zero every site's calls and totals
+     */
+    void reset();
+
+    /**
+     * @brief Operator new calls and bytes since start-up (0 when not compiled in)
+     */
+    static uint64_t allocationCount();
+    static uint64_t allocatedBytes();
+
+    /**
+     * @brief Peak resident set size of the process, or 0 where unavailable
+     */
+    static size_t peakRssBytes();
+
+    /**
+     * @brief Print stages, counters, allocations and peak RSS as an aligned table
+     */
+    void writeTable(std::ostream& out) const;
+
+    /**
+     * @brief Write the same report as a JSON object
+     */
+    void writeJson(std::ostream& out) const;
+
+private:
+    Profiler();
+
+    mutable std::mutex mutex_;
+    std::deque<Site> sites_;  // Deque: sites never move once handed out
+    std::atomic<bool> enabled_;
+};
+
+/**
+ * @brief Adds the lifetime of a scope to a stage site while profiling is enabled
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Profiler::Site& site)
+        : site_(Profiler::instance().enabled() ? &site : nullptr) {
+        if (site_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedTimer() {
+        if (site_) {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            site_->calls.fetch_add(1, std::memory_order_relaxed);
+            site_->total.fetch_add(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                std::memory_order_relaxed);
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Profiler::Site* site_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#if SENSOR_PROFILING
+
+#define SENSOR_PROFILE_CONCAT_(a, b) a##b
+#define SENSOR_PROFILE_CONCAT(a, b) SENSOR_PROFILE_CONCAT_(a, b)
+
+// Time the rest of the enclosing scope as stage @p name
+#define PROFILE_SCOPE(name) \
+    static Profiler::Site& SENSOR_PROFILE_CONCAT(profileSite_, __LINE__) = \
+        Profiler::instance().site(name, Profiler::Kind::STAGE); \
+    ScopedTimer SENSOR_PROFILE_CONCAT(profileTimer_, __LINE__)( \
+        SENSOR_PROFILE_CONCAT(profileSite_, __LINE__))
+
+// Add @p amount to counter @p name; @p amount is evaluated only while enabled
+#define PROFILE_COUNT(name, amount) \
+    do { \
+        if (Profiler::instance().enabled()) { \
+            static Profiler::Site& profileSite_ = \
+                Profiler::instance().site(name, Profiler::Kind::COUNTER); \
+            profileSite_.calls.fetch_add(1, std::memory_order_relaxed); \
+            profileSite_.total.fetch_add(static_cast<uint64_t>(amount), \
+                                         std::memory_order_relaxed); \
+        } \
+    } while (0)
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_COUNT(name, amount) ((void)0)
+
+#endif // SENSOR_PROFILING
+
+#endif // PROFILER_H
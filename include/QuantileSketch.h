@@ -0,0 +1,117 @@
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief Mergeable approximate-quantile sketch (KLL)
+ *
+ * Values enter the lowest of a stack of compactors; a compactor that reaches
+ * its capacity sorts itself and promotes every other item (random offset) to
+ * the next level, where each item stands for twice as many values.
+ * Capacities shrink geometrically (by 2/3) below the top level, so the sketch
+ * keeps O(k) values for any stream length while any quantile is answered
+ * within a normalized rank error of about rankError() (1.3% for the default
+ * k = 200). Sketches over disjoint data merge by concatenating levels and
+ * compacting, with the same error bound, so they combine across threads,
+ * shards and files. Until the first compaction every value is kept and
+ * quantiles are exact. The compaction coin is a fixed-seed generator, so the
+ * same adds and merges in the same order give the same sketch.
+ */
+class QuantileSketch {
+public:
+    static constexpr uint32_t kDefaultK = 200;
+    static constexpr uint32_t kMinK = 8;
+    static constexpr uint32_t kMaxK = 65535;
+
+    /**
+     * @brief Empty sketch; @p k is clamped to [kMinK, kMaxK]
+     */
+    explicit QuantileSketch(uint32_t k = kDefaultK);
+
+    /**
+     * @brief Smallest k whose rankError() is at most @p epsilon
+     */
+    static uint32_t kForRankError(double epsilon);
+
+    /**
+     * @brief Normalized rank error of a quantile at about 99% confidence
+     */
+    double rankError() const;
+
+    /**
+     * @brief Add one value; NaN is ignored
+     */
+    void add(double value);
+
+    /**
+     * @brief Add a contiguous run of values
+     */
+    void add(const double* values, size_t count);
+
+    /**
+     * @brief Fold another sketch into this one; the result keeps the smaller k
+     */
+    void merge(const QuantileSketch& other);
+
+    uint32_t k() const { return k_; }
+    uint64_t count() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    double min() const { return count_ ? min_ : 0.0; }
+    double max() const { return count_ ? max_ : 0.0; }
+
+    /**
+     * @brief Number of values the sketch currently stores
+     */
+    size_t retained() const { return retained_; }
+
+    /**
+     * @brief Estimate of quantile @p q in [0, 1]; 0 when empty
+     *
+     * Interpolates between neighbouring ranks like the exact median, so an
+     * uncompacted sketch returns the exact median of an even count.
+     */
+    double quantile(double q) const;
+
+    /**
+     * @brief Estimates for several quantiles, sorting the stored values once
+     */
+    std::vector<double> quantiles(const std::vector<double>& qs) const;
+
+    /**
+     * @brief Write the sketch in native byte order
+     */
+    void serialize(std::ostream& out) const;
+
+    /**
+     * @brief Read a sketch written by serialize()
+     * @throws std::runtime_error if the data is truncated or inconsistent
+     */
+    static QuantileSketch deserialize(std::istream& in);
+
+private:
+    /**
+     * @brief Capacity of @p level given the current number of levels
+     */
+    size_t capacity(size_t level) const;
+
+    void updateCapacity();
+    void compress();
+    void compact(size_t level);
+    bool nextCoin();
+
+    uint32_t k_;
+    uint64_t count_;
+    double min_;
+    double max_;
+    std::vector<std::vector<double>> levels_;  // Level h items each weigh 2^h
+    size_t retained_;
+    size_t totalCapacity_;
+    uint64_t coinState_;
+};
+
+#endif // QUANTILE_SKETCH_H
@@ -0,0 +1,132 @@
+#ifndef READING_BATCH_H
+#define READING_BATCH_H
+
+#include "SensorReading.h"
+#include "ValueKernels.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief Columnar (structure-of-arrays) container for sensor readings
+ *
+ * Stores values, timestamps, types and sensor keys in separate contiguous
+ * columns so that value-only scans touch 8 bytes per row instead of a whole
+ * SensorReading. Each row carries the dense 32-bit sensor key interned in
+ * SensorIdTable::global(); IDs are resolved only when needed for output.
+ */
+class ReadingBatch {
+public:
+    using SensorKey = SensorReading::SensorKey;
+
+    ReadingBatch();
+    ~ReadingBatch() = default;
+
+    /**
+     * @brief Build a batch from row-oriented readings
+     * @param readings Input readings
+     * @return Columnar batch with the same rows in the same order
+     */
+    static ReadingBatch fromReadings(const std::vector<SensorReading>& readings);
+
+    /**
+     * @brief Convert the batch back to row-oriented readings
+     */
+    std::vector<SensorReading> toReadings() const;
+
+    /**
+     * @brief Append a single row
+     */
+    void append(const std::string& sensorId, SensorReading::SensorType type,
+                double value, int64_t timestamp);
+    void append(const SensorReading& reading);
+
+    /**
+     * @brief Append a row whose sensor ID is already interned
+     */
+    void append(SensorKey sensorKey, SensorReading::SensorType type,
+                double value, int64_t timestamp) {
+        pushRow(value, timestamp, type, sensorKey);
+    }
+
+    /**
+     * @brief Append all rows of another batch
+     */
+    void append(const ReadingBatch& other);
+
+    /**
+     * @brief Append row @p row of another batch
+     */
+    void appendRow(const ReadingBatch& other, size_t row);
+
+    /**
+     * @brief Materialize a single row as a SensorReading
+     */
+    SensorReading at(size_t row) const;
+
+    /**
+     * @brief Copy the contiguous rows [begin, end) into a new batch
+     */
+    ReadingBatch slice(size_t begin, size_t end) const;
+
+    /**
+     * @brief Build a batch from the rows listed in a selection vector
+     * @param rows Row indexes, normally ascending
+     */
+    ReadingBatch gather(const std::vector<size_t>& rows) const;
+
+    /**
+     * @brief Keep only the rows set in a row bitmap, compacting in place
+     */
+    void compact(const ValueKernels::RowMask& mask, size_t selected);
+
+    size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+    void reserve(size_t count);
+    void clear();
+
+    /**
+     * @brief Resize every column (new rows are zeroed, to be filled in by column)
+     */
+    void resize(size_t count);
+
+    // Column access
+    const std::vector<double>& values() const { return values_; }
+    std::vector<double>& values() { return values_; }
+    const std::vector<int64_t>& timestamps() const { return timestamps_; }
+    std::vector<int64_t>& timestamps() { return timestamps_; }
+    const std::vector<SensorReading::SensorType>& types() const { return types_; }
+    std::vector<SensorReading::SensorType>& types() { return types_; }
+    const std::vector<SensorKey>& sensorKeys() const { return sensorKeys_; }
+    std::vector<SensorKey>& sensorKeys() { return sensorKeys_; }
+
+    /**
+     * @brief Sensor ID of a row
+     */
+    const std::string& sensorId(size_t row) const {
+        return SensorIdTable::global().resolve(sensorKeys_[row]);
+    }
+
+    /**
+     * @brief Same validity rule as SensorReading::isValid for a row
+     */
+    bool isValid(size_t row) const {
+        return sensorKeys_[row] != SensorIdTable::kEmptyKey && timestamps_[row] > 0;
+    }
+
+private:
+    void pushRow(double value, int64_t timestamp,
+                 SensorReading::SensorType type, SensorKey key) {
+        values_.push_back(value);
+        timestamps_.push_back(timestamp);
+        types_.push_back(type);
+        sensorKeys_.push_back(key);
+    }
+
+    std::vector<double> values_;
+    std::vector<int64_t> timestamps_;
+    std::vector<SensorReading::SensorType> types_;
+    std::vector<SensorKey> sensorKeys_;
+};
+
+#endif // READING_BATCH_H
@@ -0,0 +1,80 @@
+#ifndef READING_INDEX_H
+#define READING_INDEX_H
+
+#include "SensorReading.h"
+#include "ReadingBatch.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Rows of one posting list, ascending
+ */
+struct PostingList {
+    const uint32_t* first;
+    const uint32_t* last;
+
+    const uint32_t* begin() const { return first; }
+    const uint32_t* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
+/**
+ * @brief Posting lists of row numbers by sensor key and by sensor type
+ *
+ * Built once over a dataset with a counting sort (two passes per key), the
+ * index lets per-sensor and per-type queries touch only the matching rows.
+ * Each list is ascending, so selections keep the dataset's row order.
+ *
+ * The index holds no reference to its dataset: callers pass it explicitly
+ * to the SensorDataProcessor overloads that take one, alongside the dataset
+ * it was built over. Values may change under the index, sensor keys and
+ * types must not; rebuild it after any other change.
+ */
+class ReadingIndex {
+public:
+    /**
+     * @brief Index a columnar batch
+     * @throws std::length_error if the batch has more than 2^32 - 1 rows
+     */
+    explicit ReadingIndex(const ReadingBatch& batch);
+
+    /**
+     * @brief Index a vector of readings
+     * @throws std::length_error if there are more than 2^32 - 1 readings
+     */
+    explicit ReadingIndex(const std::vector<SensorReading>& readings);
+
+    size_t rowCount() const { return rowCount_; }
+
+    /**
+     * @brief Rows carrying a sensor key (empty for keys the dataset never uses)
+     */
+    PostingList rowsOfSensor(SensorReading::SensorKey key) const;
+
+    /**
+     * @brief Rows of a sensor type
+     */
+    PostingList rowsOfType(SensorReading::SensorType type) const;
+
+    /**
+     * @brief One past the largest sensor key with rows in the index
+     */
+    size_t sensorKeyLimit() const { return sensorOffsets_.size() - 1; }
+
+private:
+    template <typename KeyFn, typename TypeFn>
+    void build(KeyFn sensorKey, TypeFn type);
+
+    static void countingSort(const std::vector<uint32_t>& keys, size_t keyCount,
+                             std::vector<uint32_t>& offsets, std::vector<uint32_t>& rows);
+
+    size_t rowCount_;
+    std::vector<uint32_t> sensorOffsets_;  // CSR offsets by sensor key
+    std::vector<uint32_t> sensorRows_;
+    std::vector<uint32_t> typeOffsets_;    // CSR offsets by type
+    std::vector<uint32_t> typeRows_;
+};
+
+#endif // READING_INDEX_H
@@ -2,10 +2,21 @@
 #define SENSOR_DATA_PROCESSOR_H
 
 #include "SensorReading.h"
+#include "ReadingBatch.h"
+#include "ValueKernels.h"
+#include "StreamingSelector.h"
 #include <vector>
 #include <string>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <limits>
+#include <functional>
+#include <utility>
+
+class ThreadPool;
+class ReadingIndex;
+struct PostingList;
 
 /**
  * @brief Statistics structure for aggregated sensor data
@@ -20,6 +31,85 @@ struct SensorStatistics {
     SensorStatistics() : min(0.0), max(0.0), mean(0.0), median(0.0), count(0) {}
 };
 
+/**
+ * @brief IQR fences used to reject outliers
+ *
+ * Default-constructed bounds are unbounded and keep every value.
+ */
+struct OutlierBounds {
+    double lower;
+    double upper;
+    
+    OutlierBounds()
+        : lower(-std::numeric_limits<double>::infinity()),
+          upper(std::numeric_limits<double>::infinity()) {}
+};
+
+/**
+ * @brief Robust method used to derive outlier fences
+ */
+enum class OutlierMethod {
+    IQR,          // Tukey fences [Q1 - k*IQR, Q3 + k*IQR]
+    MAD,          // Modified z-score |x - median| / (1.4826 * MAD) within a threshold
+    ROLLING_IQR   // Tukey fences over a centered window of each group's rows
+};
+
+/**
+ * @brief Which readings share one set of outlier fences
+ */
+enum class OutlierGrouping {
+    NONE,             // One fence pair for all readings
+    TYPE,             // Per sensor type
+    SENSOR,           // Per sensor ID
+    TYPE_AND_SENSOR   // Per (sensor ID, type) pair
+};
+
+/**
+ * @brief Outlier removal configuration; the defaults reproduce a single global IQR fence
+ */
+struct OutlierOptions {
+    OutlierMethod method;
+    OutlierGrouping grouping;
+    double iqrFactor;     // Fence distance in IQRs (IQR, ROLLING_IQR)
+    double madThreshold;  // Largest modified z-score kept (MAD)
+    size_t window;        // Rows per window, in input order (ROLLING_IQR)
+    
+    OutlierOptions()
+        : method(OutlierMethod::IQR), grouping(OutlierGrouping::NONE),
+          iqrFactor(1.5), madThreshold(3.5), window(64) {}
+};
+
+/**
+ * @brief Dimension to group readings by for grouped statistics
+ */
+enum class GroupBy {
+    TYPE,             // One group per sensor type
+    SENSOR,           // One group per sensor ID
+    TYPE_AND_SENSOR,  // One group per (sensor ID, type) pair
+    TIME_BUCKET       // One group per fixed-width timestamp bucket
+};
+
+/**
+ * @brief Identifies a group; only the fields of the chosen GroupBy are meaningful
+ */
+struct GroupKey {
+    SensorReading::SensorType type;
+    SensorReading::SensorKey sensorKey;
+    int64_t bucketStart;  // Inclusive start of the bucket, in milliseconds
+    
+    GroupKey()
+        : type(SensorReading::SensorType::TEMPERATURE),
+          sensorKey(SensorIdTable::kEmptyKey), bucketStart(0) {}
+};
+
+/**
+ * @brief Statistics for one group of readings
+ */
+struct GroupStatistics {
+    GroupKey key;
+    SensorStatistics stats;
+};
+
 /**
  * @brief Processes sensor data with filtering, aggregation, and transformation capabilities
  * 
@@ -32,6 +122,37 @@ public:
     SensorDataProcessor();
     ~SensorDataProcessor() = default;
 
+    /**
+     * @brief Set the threads used for grouped statistics, filtering and normalization
+     *
+     * The pool is created once here and reused by every later call (copies of
+     * the processor share it). Work is split into fixed-size row chunks and
+     * partial results are combined in chunk order, so output does not depend
+     * on the thread count.
+     * @param threadCount Total threads (0 = hardware concurrency, 1 = serial)
+     */
+    void setThreadCount(size_t threadCount);
+
+    /**
+     * @brief Threads used for processing (1 when serial)
+     */
+    size_t getThreadCount() const;
+
+    /**
+     * @brief Choose the outlier method and grouping used by process() and removeOutliers()
+     */
+    void setOutlierOptions(const OutlierOptions& options) { outlierOptions_ = options; }
+    const OutlierOptions& getOutlierOptions() const { return outlierOptions_; }
+
+    /**
+     * @brief Allocate large scratch buffers (partitions, value copies) from @p resource
+     *
+     * Meant for a ProcessingArena, so a run's scratch comes from one buffer
+     * released at once. Only the calling thread allocates from the resource;
+     * pool tasks never do. Pass nullptr to use the default resource again.
+     */
+    void setScratchResource(std::pmr::memory_resource* resource) { scratch_ = resource; }
+
     /**
      * @brief Process a collection of sensor readings
      * @param readings Input sensor readings
@@ -39,6 +160,14 @@ public:
      */
     std::vector<SensorReading> process(const std::vector<SensorReading>& readings);
 
+    /**
+     * @brief Process readings the caller hands over, compacting them in place
+     *
+     * Same result as process(const std::vector<SensorReading>&), but survivors
+     * are moved down within @p readings instead of copied into a new vector.
+     */
+    std::vector<SensorReading> process(std::vector<SensorReading>&& readings);
+
     /**
      * @brief Filter readings by sensor type
      * @param readings Input readings
@@ -59,6 +188,24 @@ public:
         const std::vector<SensorReading>& readings,
         const std::string& sensorId) const;
 
+    /**
+     * @brief Filter readings by sensor type or ID using a prebuilt index
+     *
+     * Reads only the matching posting list instead of scanning. The caller
+     * pairs the index with the readings it was built over and rebuilds it
+     * whenever their sensor IDs or types change; only the row count is
+     * checked here. Same result as the scanning overloads.
+     * @param index Index built over @p readings
+     * @throws std::invalid_argument if the index row count differs
+     */
+    std::vector<SensorReading> filterByType(
+        const std::vector<SensorReading>& readings,
+        SensorReading::SensorType type, const ReadingIndex& index) const;
+
+    std::vector<SensorReading> filterBySensorId(
+        const std::vector<SensorReading>& readings,
+        const std::string& sensorId, const ReadingIndex& index) const;
+
     /**
      * @brief Filter readings by value range
      * @param readings Input readings
@@ -95,9 +242,13 @@ public:
     calculateStatisticsBySensorId(const std::vector<SensorReading>& readings) const;
 
     /**
-     * @brief Remove outliers using IQR (Interquartile Range) method
+     * @brief Remove outliers using the configured method (IQR by default)
+     *
+     * With a grouping other than NONE the readings are partitioned once by
+     * group and each group gets its own fences; groups run in parallel on
+     * the processor's thread pool. Groups with fewer than 4 readings are kept.
      * @param readings Input readings
-     * @return Readings with outliers removed
+     * @return Readings with outliers removed, in input order
      */
     std::vector<SensorReading> removeOutliers(
         const std::vector<SensorReading>& readings) const;
@@ -108,17 +259,284 @@ public:
      */
     void normalizeValues(std::vector<SensorReading>& readings) const;
 
+    // Columnar overloads: same semantics as the vector API above, but scans
+    // only the columns each operation needs.
+
+    ReadingBatch process(const ReadingBatch& batch);
+    ReadingBatch process(ReadingBatch&& batch);
+
+    ReadingBatch filterByType(const ReadingBatch& batch,
+                              SensorReading::SensorType type) const;
+
+    ReadingBatch filterBySensorId(const ReadingBatch& batch,
+                                  const std::string& sensorId) const;
+
+    ReadingBatch filterByType(const ReadingBatch& batch,
+                              SensorReading::SensorType type,
+                              const ReadingIndex& index) const;
+
+    ReadingBatch filterBySensorId(const ReadingBatch& batch,
+                                  const std::string& sensorId,
+                                  const ReadingIndex& index) const;
+
+    ReadingBatch filterByValueRange(const ReadingBatch& batch,
+                                    double minValue, double maxValue) const;
+
+    SensorStatistics calculateStatistics(const ReadingBatch& batch) const;
+
+    std::map<SensorReading::SensorType, SensorStatistics>
+    calculateStatisticsByType(const ReadingBatch& batch) const;
+
+    std::map<std::string, SensorStatistics>
+    calculateStatisticsBySensorId(const ReadingBatch& batch) const;
+
+    ReadingBatch removeOutliers(const ReadingBatch& batch) const;
+
+    void normalizeValues(ReadingBatch& batch) const;
+
+    /**
+     * @brief Calculate statistics for every group of readings in one partitioning pass
+     *
+     * Only the values are partitioned (a counting sort by group), so no
+     * reading is copied; each group's statistics are then computed in place
+     * over its contiguous slice.
+     * @param batch Input readings
+     * @param groupBy Grouping dimension
+     * @param bucketMs Bucket width for GroupBy::TIME_BUCKET, in milliseconds
+     * @return Non-empty groups ordered by type, sensor key or bucket start
+     */
+    std::vector<GroupStatistics> calculateGroupedStatistics(
+        const ReadingBatch& batch, GroupBy groupBy, int64_t bucketMs = 60000) const;
+
+    std::vector<GroupStatistics> calculateGroupedStatistics(
+        const std::vector<SensorReading>& readings, GroupBy groupBy,
+        int64_t bucketMs = 60000) const;
+
+    /**
+     * @brief Calculate grouped statistics from the posting lists of a prebuilt index
+     *
+     * Each group's values are gathered in row order, so the result is
+     * identical to the scanning overload. The index must have been built
+     * over @p batch; only the row count is checked.
+     * @param groupBy TYPE, SENSOR or TYPE_AND_SENSOR
+     * @throws std::invalid_argument for TIME_BUCKET or if the index row count differs
+     */
+    std::vector<GroupStatistics> calculateGroupedStatistics(
+        const ReadingBatch& batch, GroupBy groupBy, const ReadingIndex& index) const;
+
+    std::vector<GroupStatistics> calculateGroupedStatistics(
+        const std::vector<SensorReading>& readings, GroupBy groupBy,
+        const ReadingIndex& index) const;
+
+    /**
+     * @brief Calculate statistics directly from a value column
+     * @param values Input values (reordered by the call)
+     * @return Statistics structure
+     */
+    SensorStatistics calculateValueStatistics(std::vector<double>& values) const;
+
+    /**
+     * @brief Calculate median value by selection (values are reordered)
+     * @return Median, or 0.0 for an empty range
+     */
+    static double calculateMedian(double* first, double* last);
+
+    /**
+     * @brief Calculate the outlier fences that removeOutliers applies to one group
+     * @param values Input values (reordered by the call)
+     * @return Fences; unbounded if there are fewer than 4 values
+     * @throws std::invalid_argument if the configured method is ROLLING_IQR,
+     *         which has no single pair of fences
+     */
+    OutlierBounds calculateOutlierBounds(std::vector<double>& values) const;
+
+    OutlierBounds calculateOutlierBounds(std::vector<double>& values,
+                                         const OutlierOptions& options) const;
+
+    /**
+     * @brief Calculate the outlier fences of every group without holding the values
+     *
+     * Same fences as calculateOutlierBounds over each group's values: the
+     * quartiles (IQR), or the median and median absolute deviation (MAD), are
+     * picked exactly by a StreamingSelector that replays @p source.
+     * @param source Replays every (outlier group, value) pair identically
+     * @param groupCounts Number of values in each group
+     * @param memoryBytes Selection budget; see StreamingSelector
+     * @return Fences by group; unbounded for groups with fewer than 4 values
+     * @throws std::invalid_argument if the configured method is ROLLING_IQR
+     */
+    std::vector<OutlierBounds> calculateOutlierBounds(
+        const StreamingSelector::Source& source, const std::vector<size_t>& groupCounts,
+        size_t memoryBytes) const;
+
+    /**
+     * @brief Number of outlier groups for a grouping, given the sensor IDs interned so far
+     */
+    static size_t outlierGroupCount(OutlierGrouping grouping);
+
+    /**
+     * @brief Outlier group index of a reading; indexes the bounds passed to process()
+     */
+    static size_t outlierGroupOf(OutlierGrouping grouping, SensorReading::SensorType type,
+                                 SensorReading::SensorKey sensorKey);
+
+    /**
+     * @brief Apply process() to one batch of a larger stream with precomputed fences
+     *
+     * Drops invalid readings and readings outside @p bounds in a single pass.
+     * With bounds computed over the whole stream's valid values this gives
+     * the same rows as process() over the whole stream, batch by batch.
+     * @param batch Input batch
+     * @param bounds Fences from calculateOutlierBounds
+     * @return Surviving readings in input order
+     */
+    ReadingBatch process(const ReadingBatch& batch, const OutlierBounds& bounds) const;
+
+    /**
+     * @brief Batch-wise process() with precomputed fences per outlier group
+     * @param groupBounds Fences indexed by outlierGroupOf(); missing groups are unbounded
+     */
+    ReadingBatch process(const ReadingBatch& batch,
+                         const std::vector<OutlierBounds>& groupBounds,
+                         OutlierGrouping grouping) const;
+
 private:
     /**
-     * @brief Calculate median value from sorted vector
+     * @brief Rows per parallel chunk; a multiple of 64 so chunks own whole mask words
+     */
+    static constexpr size_t kRowGrain = size_t(1) << 16;
+
+    /**
+     * @brief Run body(begin, end) over [0, count) in @p grain chunks, on the pool if any
+     */
+    void parallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t, size_t)>& body) const;
+
+    /**
+     * @brief Row bitmap of rows where @p pred(row) holds, built in parallel chunks
+     * @return Number of rows set
+     */
+    template <typename Predicate>
+    size_t buildRowMask(size_t rowCount, Predicate pred, ValueKernels::RowMask& mask) const;
+
+    /**
+     * @brief Row bitmap of values in [lower, upper], SIMD kernel per chunk
+     * @return Number of rows set
+     */
+    size_t buildRangeMask(const double* column, size_t rowCount, double lower, double upper,
+                          ValueKernels::RowMask& mask) const;
+
+    /**
+     * @brief Copy the rows set in @p mask into a new batch, in parallel chunks
      */
-    double calculateMedian(std::vector<double>& values) const;
+    ReadingBatch gatherRows(const ReadingBatch& batch, const ValueKernels::RowMask& mask,
+                            size_t selected) const;
 
     /**
-     * @brief Calculate quartiles for outlier detection
+     * @brief Resource for scratch buffers: the one set by setScratchResource, or the default
      */
-    void calculateQuartiles(const std::vector<double>& sortedValues,
-                           double& q1, double& q3) const;
+    std::pmr::memory_resource* scratch() const {
+        return scratch_ ? scratch_ : std::pmr::get_default_resource();
+    }
+
+    /**
+     * @brief Check that @p index was built over @p rowCount rows
+     * @throws std::invalid_argument otherwise
+     */
+    static void requireIndexOver(const ReadingIndex& index, size_t rowCount);
+
+    /**
+     * @brief Copy the rows of a posting list into a new batch, in parallel chunks
+     */
+    ReadingBatch gatherPostings(const ReadingBatch& batch, const PostingList& rows) const;
+
+    /**
+     * @brief calculateGroupedStatistics by TYPE, SENSOR or TYPE_AND_SENSOR from posting lists
+     *
+     * Each group's values are gathered in row order, exactly as the scanning
+     * path partitions them, so both paths give identical results.
+     */
+    template <typename ValueFn, typename TypeFn>
+    std::vector<GroupStatistics> indexedGroupedStatistics(
+        const ReadingIndex& index, ValueFn value, TypeFn type, GroupBy groupBy) const;
+
+    /**
+     * @brief Shared implementation of calculateGroupedStatistics over column accessors
+     */
+    template <typename ValueFn, typename TypeFn, typename KeyFn, typename TimeFn>
+    std::vector<GroupStatistics> groupedStatistics(
+        size_t rowCount, ValueFn value, TypeFn type, KeyFn sensorKey, TimeFn timestamp,
+        GroupBy groupBy, int64_t bucketMs) const;
+
+    /**
+     * @brief Mark the rows process() keeps: valid and inside the IQR fences
+     *
+     * Validation, fence computation and filtering all run over one bitmap on
+     * the original rows; only the valid values are copied, for selection.
+     * @param column Contiguous value column for the SIMD range scan, or nullptr
+     * @return Number of rows left set in @p mask
+     */
+    template <typename ValueFn, typename ValidFn>
+    size_t survivorMask(size_t rowCount, ValueFn value, ValidFn valid,
+                        const double* column, ValueKernels::RowMask& mask) const;
+
+    /**
+     * @brief Mark process()/removeOutliers() survivors with per-group or rolling fences
+     *
+     * One pass assigns each valid row its group, one counting sort partitions
+     * row indexes and values by group, and the groups then run in parallel.
+     * @return Number of rows left set in @p mask
+     */
+    template <typename ValueFn, typename TypeFn, typename KeyFn, typename ValidFn>
+    size_t groupedSurvivorMask(size_t rowCount, ValueFn value, TypeFn type, KeyFn sensorKey,
+                               ValidFn valid, ValueKernels::RowMask& mask) const;
+
+    /**
+     * @brief Dispatch to survivorMask or groupedSurvivorMask for the configured options
+     */
+    template <typename ValueFn, typename TypeFn, typename KeyFn, typename ValidFn>
+    size_t outlierMask(size_t rowCount, ValueFn value, TypeFn type, KeyFn sensorKey,
+                       ValidFn valid, const double* column, ValueKernels::RowMask& mask) const;
+
+    /**
+     * @brief Fences for a contiguous range
+     *
+     * The range is scratch: IQR reorders it and MAD replaces every value
+     * with its absolute deviation from the median.
+     */
+    OutlierBounds rangeOutlierBounds(double* first, double* last,
+                                     const OutlierOptions& options) const;
+
+    /**
+     * @brief Rolling-window IQR over one group's values in row order
+     * @param keep Set to 1 at rows[i] for every value inside its window's fences,
+     *        0 for the rest; non-finite values are always 0 and never enter a window
+     */
+    void markRollingSurvivors(const double* values, const size_t* rows, size_t count,
+                              uint8_t* keep) const;
+
+    /**
+     * @brief Calculate statistics over a contiguous range (values are reordered)
+     */
+    SensorStatistics calculateRangeStatistics(double* first, double* last) const;
+
+    /**
+     * @brief Min-max normalize a contiguous value column in place
+     * @return false (column untouched) if empty or all values are equal
+     */
+    bool normalizeColumn(double* values, size_t count) const;
+
+    /**
+     * @brief Calculate quartiles for outlier detection by selection (values are reordered)
+     *
+     * Same definition as taking Q1/Q3 from the sorted values, without the sort.
+     */
+    void calculateQuartiles(double* first, double* last,
+                            double& q1, double& q3) const;
+
+    std::shared_ptr<ThreadPool> pool_;  // Null when serial
+    OutlierOptions outlierOptions_;
+    std::pmr::memory_resource* scratch_;  // Null for the default resource
 };
 
 #endif // SENSOR_DATA_PROCESSOR_H
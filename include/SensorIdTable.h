@@ -0,0 +1,61 @@
+#ifndef SENSOR_ID_TABLE_H
+#define SENSOR_ID_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstdint>
+
+/**
+ * @brief Process-wide symbol table that interns sensor IDs as dense 32-bit keys
+ *
+ * Readings carry the key instead of the ID string, so ID comparisons are an
+ * integer compare and per-sensor grouping can use flat arrays indexed by key.
+ * Strings are only resolved when they are needed for output. Key 0 is
+ * reserved for the empty ID. Interning and resolving are thread-safe.
+ */
+class SensorIdTable {
+public:
+    using Key = uint32_t;
+
+    static constexpr Key kEmptyKey = 0;
+
+    /**
+     * @brief The shared table used by readings, batches and the ingester
+     */
+    static SensorIdTable& global();
+
+    SensorIdTable();
+    SensorIdTable(const SensorIdTable&) = delete;
+    SensorIdTable& operator=(const SensorIdTable&) = delete;
+
+    /**
+     * @brief Return the key for an ID, assigning the next free key if new
+     */
+    Key intern(std::string_view sensorId);
+
+    /**
+     * @brief Look up an ID without interning it
+     * @return true if the ID has been interned
+     */
+    bool find(std::string_view sensorId, Key& key) const;
+
+    /**
+     * @brief Resolve a key back to its ID (reference stays valid for the table's lifetime)
+     */
+    const std::string& resolve(Key key) const;
+
+    /**
+     * @brief Number of interned IDs, including the empty ID; keys are < size()
+     */
+    size_t size() const;
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::deque<std::string> ids_;  // deque keeps element addresses stable
+    std::unordered_map<std::string_view, Key> keys_;
+};
+
+#endif // SENSOR_ID_TABLE_H
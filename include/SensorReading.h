@@ -1,18 +1,24 @@
 #ifndef SENSOR_READING_H
 #define SENSOR_READING_H
 
+#include "SensorIdTable.h"
 #include <string>
+#include <string_view>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 
 /**
  * @brief Represents a single sensor reading with timestamp and value
  * 
  * This class models sensor data commonly found in defense/undersea systems,
- * including timestamp, sensor ID, and measurement value.
+ * including timestamp, sensor ID, and measurement value. The sensor ID is
+ * stored as a key into SensorIdTable::global() and resolved on demand.
  */
 class SensorReading {
 public:
+    using SensorKey = SensorIdTable::Key;
+
     // Sensor types for different measurement categories
     enum class SensorType {
         TEMPERATURE,
@@ -23,6 +29,11 @@ public:
         GYROSCOPE
     };
 
+    // Number of SensorType values; codes run from 0 to kTypeCount - 1
+    static constexpr size_t kTypeCount = 6;
+    static_assert(static_cast<size_t>(SensorType::GYROSCOPE) + 1 == kTypeCount,
+                  "kTypeCount must follow the last SensorType");
+
     /**
      * @brief Default constructor
      */
@@ -38,14 +49,30 @@ public:
     SensorReading(const std::string& sensorId, SensorType type, 
                   double value, int64_t timestamp);
 
+    /**
+     * @brief Construct from an already interned sensor key
+     * @param sensorKey Key returned by SensorIdTable::global().intern()
+     * @param type Type of sensor measurement
+     * @param value Measurement value
+     * @param timestamp Unix timestamp in milliseconds
+     */
+    SensorReading(SensorKey sensorKey, SensorType type,
+                  double value, int64_t timestamp);
+
     // Getters
-    const std::string& getSensorId() const { return sensorId_; }
+    const std::string& getSensorId() const {
+        return SensorIdTable::global().resolve(sensorKey_);
+    }
+    SensorKey getSensorKey() const { return sensorKey_; }
     SensorType getType() const { return type_; }
     double getValue() const { return value_; }
     int64_t getTimestamp() const { return timestamp_; }
 
     // Setters
-    void setSensorId(const std::string& sensorId) { sensorId_ = sensorId; }
+    void setSensorId(const std::string& sensorId) {
+        sensorKey_ = SensorIdTable::global().intern(sensorId);
+    }
+    void setSensorKey(SensorKey sensorKey) { sensorKey_ = sensorKey; }
     void setType(SensorType type) { type_ = type; }
     void setValue(double value) { value_ = value; }
     void setTimestamp(int64_t timestamp) { timestamp_ = timestamp; }
@@ -55,18 +82,31 @@ public:
      */
     static std::string typeToString(SensorType type);
 
+    /**
+     * @brief Type name from a static table, without allocating ("UNKNOWN" if out of range)
+     */
+    static std::string_view typeName(SensorType type);
+
     /**
      * @brief Parse sensor type from string
      */
     static SensorType stringToType(const std::string& str);
 
+    /**
+     * @brief Parse sensor type from a view without allocating
+     * @param str Type name (exact, upper case)
+     * @param type Set to the parsed type on success
+     * @return false if @p str is not a known type name
+     */
+    static bool parseType(std::string_view str, SensorType& type);
+
     /**
      * @brief Check if reading is valid (non-null sensor ID, reasonable timestamp)
      */
     bool isValid() const;
 
 private:
-    std::string sensorId_;
+    SensorKey sensorKey_;
     SensorType type_;
     double value_;
     int64_t timestamp_;  // Unix timestamp in milliseconds
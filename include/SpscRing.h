@@ -0,0 +1,114 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief Bounded lock-free ring buffer for one producer thread and one consumer thread
+ *
+ * The producer only writes head_ and the consumer only writes tail_; each
+ * side publishes with a release store and reads the other's index with an
+ * acquire load, so slots are handed over without locks or read-modify-write
+ * instructions. Each side also keeps a cached copy of the other's index and
+ * refreshes it only when the ring looks full (producer) or empty (consumer),
+ * which keeps the shared cache lines from bouncing on every item. The indexes
+ * sit on separate cache lines for the same reason.
+ *
+ * Indexes count up without wrapping (a 64-bit counter does not overflow in
+ * practice) and are masked into the slot array, so capacity is a power of two.
+ */
+template <typename T>
+class SpscRing {
+public:
+    /**
+     * @brief Create a ring holding at least @p capacity items (rounded up to a power of two)
+     */
+    explicit SpscRing(size_t capacity)
+        : capacity_(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1), slots_(new T[capacity_]),
+          head_(0), cachedTail_(0), tail_(0), cachedHead_(0) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Producer: append an item unless the ring is full
+     * @return false if the ring was full and nothing was written
+     */
+    bool tryPush(const T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cachedTail_ == capacity_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head - cachedTail_ == capacity_) {
+                return false;
+            }
+        }
+        slots_[head & mask_] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer: take the oldest item unless the ring is empty
+     * @return false if the ring was empty
+     */
+    bool tryPop(T& item) {
+        return tryPopBulk(&item, 1) == 1;
+    }
+
+    /**
+     * @brief Consumer: take up to @p maxItems of the oldest items in order
+     * @return Number of items written to @p out
+     */
+    size_t tryPopBulk(T* out, size_t maxItems) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (cachedHead_ - tail < maxItems) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+        }
+        size_t count = cachedHead_ - tail;
+        if (count > maxItems) {
+            count = maxItems;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = slots_[(tail + i) & mask_];
+        }
+        if (count > 0) {
+            tail_.store(tail + count, std::memory_order_release);  // One publish per batch
+        }
+        return count;
+    }
+
+    /**
+     * @brief Items currently queued; exact only when called from a quiescent ring
+     */
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t power = 1;
+        while (power < value) {
+            power <<= 1;
+        }
+        return power;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    alignas(kCacheLine) std::atomic<size_t> head_;  // Next slot to write; producer-owned
+    size_t cachedTail_;                             // Producer's last view of tail_
+    alignas(kCacheLine) std::atomic<size_t> tail_;  // Next slot to read; consumer-owned
+    size_t cachedHead_;                             // Consumer's last view of head_
+};
+
+#endif // SPSC_RING_H
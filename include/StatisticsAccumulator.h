@@ -0,0 +1,94 @@
+#ifndef STATISTICS_ACCUMULATOR_H
+#define STATISTICS_ACCUMULATOR_H
+
+#include "SensorDataProcessor.h"
+#include "QuantileSketch.h"
+#include <cstddef>
+#include <istream>
+#include <ostream>
+
+/**
+ * @brief Online statistics with O(1) update and mergeable state
+ *
+ * Count, min, max, mean and variance are maintained exactly with Welford's
+ * algorithm and combined across accumulators with Chan's parallel formula.
+ * The median and other quantiles come from a QuantileSketch, which is exact
+ * until the sketch first compacts and otherwise within its rank error, also
+ * after merging accumulators from other threads, shards or files.
+ */
+class StatisticsAccumulator {
+public:
+    /**
+     * @param sketchK Quantile sketch size; see QuantileSketch::kForRankError
+     */
+    explicit StatisticsAccumulator(uint32_t sketchK = QuantileSketch::kDefaultK);
+    ~StatisticsAccumulator() = default;
+
+    /**
+     * @brief Add one value
+     */
+    void add(double value);
+
+    /**
+     * @brief Add a contiguous run of values
+     */
+    void add(const double* values, size_t count);
+
+    /**
+     * @brief Fold another accumulator's state into this one
+     */
+    void merge(const StatisticsAccumulator& other);
+
+    size_t count() const { return count_; }
+    double min() const { return count_ ? min_ : 0.0; }
+    double max() const { return count_ ? max_ : 0.0; }
+    double mean() const { return count_ ? mean_ : 0.0; }
+
+    /**
+     * @brief Sample variance (n - 1 denominator); 0 for fewer than two values
+     */
+    double variance() const;
+
+    /**
+     * @brief Standard deviation derived from variance()
+     */
+    double standardDeviation() const;
+
+    /**
+     * @brief Median estimate (exact until the sketch compacts)
+     */
+    double median() const;
+
+    /**
+     * @brief Estimate of quantile @p q in [0, 1]
+     */
+    double quantile(double q) const { return sketch_.quantile(q); }
+
+    const QuantileSketch& sketch() const { return sketch_; }
+
+    /**
+     * @brief Write the accumulator state in native byte order
+     */
+    void serialize(std::ostream& out) const;
+
+    /**
+     * @brief Read an accumulator written by serialize()
+     * @throws std::runtime_error if the data is truncated or inconsistent
+     */
+    static StatisticsAccumulator deserialize(std::istream& in);
+
+    /**
+     * @brief Snapshot in the same form the batch statistics use
+     */
+    SensorStatistics toStatistics() const;
+
+private:
+    size_t count_;
+    double min_;
+    double max_;
+    double mean_;
+    double m2_;  // Sum of squared deviations from the mean
+    QuantileSketch sketch_;
+};
+
+#endif // STATISTICS_ACCUMULATOR_H
@@ -0,0 +1,82 @@
+#ifndef STREAMING_SELECTOR_H
+#define STREAMING_SELECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Exact order statistics of grouped values that are never held in memory
+ *
+ * The values are replayed by the caller as many times as needed (e.g. by
+ * re-reading a file). Each value is mapped to a 64-bit key that sorts like
+ * the double, and every pass refines a radix histogram of the keys that
+ * still share the selected prefix, narrowing each request by up to 16 bits.
+ * Once the values left around a rank fit the memory budget they are copied
+ * out in one more pass and the rank is picked by nth_element. Doubles of
+ * similar magnitude typically resolve in three or four passes.
+ *
+ * Histograms, copied candidates and per-request state stay within the
+ * budget; requests that do not fit in one pass wait for a later one.
+ * Results equal nth_element over each group's values, except that -0.0 and
+ * +0.0 are ordered (negative first) where nth_element treats them as equal.
+ */
+class StreamingSelector {
+public:
+    using Sink = std::function<void(size_t group, double value)>;
+
+    /**
+     * @brief Replays every (group, value) pair into the sink, identically each time
+     */
+    using Source = std::function<void(const Sink& sink)>;
+
+    /**
+     * @brief One order statistic: the value of 0-based @p rank within @p group
+     */
+    struct Request {
+        size_t group;
+        uint64_t rank;
+    };
+
+    static constexpr size_t kMinMemoryBytes = 64 * 1024;
+
+    /**
+     * @param memoryBytes Budget for histograms, candidates and request state
+     * @throws std::invalid_argument if the budget is below kMinMemoryBytes
+     */
+    explicit StreamingSelector(size_t memoryBytes);
+
+    /**
+     * @brief Select every requested order statistic
+     * @return Values in request order
+     * @throws std::out_of_range if a rank is not below its group's value count
+     * @throws std::length_error if the request state alone exceeds the budget
+     */
+    std::vector<double> select(const Source& source, const std::vector<Request>& requests);
+
+    /**
+     * @brief Replays of the source made by the last select()
+     */
+    size_t passCount() const { return passCount_; }
+
+private:
+    /**
+     * @brief Progress of one request: the key prefix its value must carry
+     */
+    struct State {
+        uint64_t prefix;      // Top prefixBits bits of the selected key
+        uint64_t rank;        // Rank among the keys carrying the prefix
+        uint64_t candidates;  // Keys carrying the prefix; unknown before the first pass
+        uint32_t prefixBits;
+        bool resolved;
+    };
+
+    static uint64_t keyOf(double value);
+    static double valueOf(uint64_t key);
+
+    size_t memoryBytes_;
+    size_t passCount_;
+};
+
+#endif // STREAMING_SELECTOR_H
@@ -0,0 +1,149 @@
+#ifndef STREAMING_STATISTICS_H
+#define STREAMING_STATISTICS_H
+
+#include "SensorDataProcessor.h"
+#include "ReadingBatch.h"
+#include "StatisticsAccumulator.h"
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <map>
+#include <string>
+
+/**
+ * @brief Collects overall, per-type and per-sensor statistics across a stream of batches
+ *
+ * In exact mode each (sensor key, type) group keeps only its count, extremes
+ * and sum, so memory does not grow with the stream. Exact medians need the
+ * values again: resolveMedians() replays the stream through a
+ * StreamingSelector within a fixed budget, e.g. by re-reading the input.
+ *
+ * In approximate mode (a non-zero sketch size) each group keeps a
+ * StatisticsAccumulator instead and needs no replay: counts, extremes and
+ * means stay exact, medians and percentiles come from mergeable quantile
+ * sketches. Approximate statistics can be written out and merged with those
+ * of other runs, e.g. one per node or per day.
+ */
+class StreamingStatistics {
+public:
+    using BatchSink = std::function<void(const ReadingBatch&)>;
+
+    /**
+     * @brief Passes the same batches to the sink as were added, in any order
+     */
+    using BatchReplay = std::function<void(const BatchSink& sink)>;
+
+    /**
+     * @param sketchK Quantile sketch size for approximate mode, 0 for exact statistics
+     */
+    explicit StreamingStatistics(uint32_t sketchK = 0);
+    ~StreamingStatistics() = default;
+
+    /**
+     * @brief Fold a batch into the collected statistics
+     */
+    void add(const ReadingBatch& batch);
+
+    /**
+     * @brief Number of readings added so far
+     */
+    size_t count() const { return count_; }
+
+    bool approximate() const { return sketchK_ > 0; }
+
+    /**
+     * @brief Select the exact medians by replaying the stream (exact mode)
+     *
+     * Must follow the last add() before overall(), byType() or bySensorId()
+     * are called in exact mode; does nothing in approximate mode.
+     * @param memoryBytes Selection budget; see StreamingSelector
+     * @return Number of replays made
+     */
+    size_t resolveMedians(const BatchReplay& replay, size_t memoryBytes);
+
+    /**
+     * @brief Statistics over every reading added
+     * @throws std::logic_error in exact mode before resolveMedians()
+     */
+    SensorStatistics overall() const;
+
+    /**
+     * @brief Statistics grouped by sensor type
+     * @throws std::logic_error in exact mode before resolveMedians()
+     */
+    std::map<SensorReading::SensorType, SensorStatistics> byType() const;
+
+    /**
+     * @brief Statistics grouped by sensor ID
+     * @throws std::logic_error in exact mode before resolveMedians()
+     */
+    std::map<std::string, SensorStatistics> bySensorId() const;
+
+    /**
+     * @brief Mergeable summary over every reading added
+     * @throws std::logic_error in exact mode, which keeps no sketches
+     */
+    StatisticsAccumulator overallSummary() const;
+
+    /**
+     * @brief Mergeable summaries grouped by sensor type
+     */
+    std::map<SensorReading::SensorType, StatisticsAccumulator> byTypeSummary() const;
+
+    /**
+     * @brief Mergeable summaries grouped by sensor ID
+     */
+    std::map<std::string, StatisticsAccumulator> bySensorIdSummary() const;
+
+    /**
+     * @brief Write the per-(sensor, type) summaries as a sketch file
+     * @throws std::logic_error in exact mode
+     */
+    void writeSketches(std::ostream& out) const;
+
+    /**
+     * @brief Merge a sketch file written by writeSketches() into these statistics
+     * @throws std::logic_error in exact mode
+     * @throws std::runtime_error if the data is not a valid sketch file
+     */
+    void mergeSketches(std::istream& in);
+
+private:
+    /**
+     * @brief Exact-mode state of one (sensor key, type) group
+     */
+    struct ExactGroup {
+        size_t count;
+        double min;
+        double max;
+        double sum;
+
+        ExactGroup() : count(0), min(0.0), max(0.0), sum(0.0) {}
+    };
+
+    /**
+     * @brief Group index of a (sensor key, type) pair, growing the group table
+     */
+    size_t groupOf(SensorReading::SensorKey key, SensorReading::SensorType type);
+
+    /**
+     * @brief Exact statistics of the groups selected by @p inTarget
+     * @param target Median slot: 0 overall, 1 + type, 1 + type count + sensor key
+     */
+    template <typename InTarget>
+    SensorStatistics exactStatistics(size_t target, InTarget inTarget) const;
+
+    void requireExact() const;
+    void requireApproximate(const char* what) const;
+
+    uint32_t sketchK_;
+    std::vector<ExactGroup> exact_;                 // Exact mode: by sensorKey * type count + type
+    std::vector<StatisticsAccumulator> summaries_;  // Approximate mode: same indexing
+    std::vector<double> medians_;                   // Exact mode: by median slot
+    bool mediansResolved_;
+    size_t count_;
+};
+
+#endif // STREAMING_STATISTICS_H
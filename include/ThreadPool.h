@@ -0,0 +1,74 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size work-stealing thread pool
+ *
+ * Each worker owns a task deque: it pops its own newest task first and, when
+ * empty, steals the oldest task from another worker. The thread that calls
+ * parallelFor() runs chunks as well while it waits, so nested parallelFor()
+ * calls from inside a task make progress instead of deadlocking.
+ *
+ * Work is split into chunks by a caller-chosen grain, never by thread count,
+ * so a computation that combines per-chunk results in chunk order gives the
+ * same answer for any pool size.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Start the pool
+     * @param threadCount Total threads including the caller (0 = hardware concurrency)
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Threads that execute work, counting the calling thread
+     */
+    size_t size() const { return workers_.size() + 1; }
+
+    /**
+     * @brief Run body(begin, end) over [0, count) in chunks of @p grain and wait
+     *
+     * Chunk boundaries depend only on @p count and @p grain. The first
+     * exception thrown by any chunk is rethrown here once all chunks finish.
+     */
+    void parallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t begin, size_t end)>& body);
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void push(Task task);
+    bool tryRunOne();
+    bool popTask(size_t queue, bool newest, Task& task);
+    void workerLoop(size_t index);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    size_t pending_;  // Queued tasks not yet taken; guarded by sleepMutex_
+    bool stop_;
+    std::atomic<size_t> nextQueue_;
+};
+
+#endif // THREAD_POOL_H
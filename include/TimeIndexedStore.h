@@ -0,0 +1,111 @@
+#ifndef TIME_INDEXED_STORE_H
+#define TIME_INDEXED_STORE_H
+
+#include "ReadingBatch.h"
+#include "SensorDataProcessor.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Summary of one block of time-ordered rows
+ */
+struct TimeBlock {
+    size_t begin;          // First row of the block
+    size_t end;            // One past the last row
+    int64_t minTimestamp;
+    int64_t maxTimestamp;
+    double minValue;
+    double maxValue;
+    double sum;
+};
+
+/**
+ * @brief Readings kept ordered by timestamp for fast time-range queries
+ *
+ * Rows are stored sorted by timestamp (ties keep insertion order) and cut
+ * into fixed-size blocks, each summarized by its timestamp and value range
+ * and value sum. A [t0, t1) query binary-searches the block summaries and
+ * then the two edge blocks, so it touches O(log blocks + matching rows)
+ * instead of the whole dataset. Range statistics take min, max and sum of
+ * fully covered blocks from their summaries; value-filtered scans skip
+ * blocks whose value range cannot match.
+ */
+class TimeIndexedStore {
+public:
+    static constexpr size_t kDefaultBlockRows = 4096;
+
+    /**
+     * @brief Create an empty store
+     * @param blockRows Rows per block summary
+     */
+    explicit TimeIndexedStore(size_t blockRows = kDefaultBlockRows);
+
+    /**
+     * @brief Build a store from a batch, sorting it by timestamp if needed
+     */
+    explicit TimeIndexedStore(ReadingBatch batch, size_t blockRows = kDefaultBlockRows);
+
+    /**
+     * @brief Add readings, keeping the store ordered
+     *
+     * Batches that start at or after the newest stored timestamp are appended
+     * and only the tail block is re-summarized; otherwise the batch is merged
+     * in and every block is rebuilt.
+     */
+    void append(const ReadingBatch& batch);
+
+    size_t size() const { return rows_.size(); }
+    bool empty() const { return rows_.empty(); }
+
+    /**
+     * @brief All readings in timestamp order
+     */
+    const ReadingBatch& readings() const { return rows_; }
+
+    /**
+     * @brief Block summaries in timestamp order
+     */
+    const std::vector<TimeBlock>& blocks() const { return blocks_; }
+
+    /**
+     * @brief Rows whose timestamp lies in [t0, t1)
+     * @return Half-open row range into readings()
+     */
+    std::pair<size_t, size_t> rowRange(int64_t t0, int64_t t1) const;
+
+    /**
+     * @brief Copy the readings with timestamps in [t0, t1)
+     */
+    ReadingBatch rangeScan(int64_t t0, int64_t t1) const;
+
+    /**
+     * @brief Copy the readings with timestamps in [t0, t1) and values in [minValue, maxValue]
+     *
+     * Blocks whose value range lies outside [minValue, maxValue] are skipped
+     * without reading their rows.
+     */
+    ReadingBatch rangeScan(int64_t t0, int64_t t1, double minValue, double maxValue) const;
+
+    /**
+     * @brief Statistics of the values with timestamps in [t0, t1)
+     *
+     * Min, max and sum come from block summaries for fully covered blocks and
+     * from the rows of the two edge blocks; the median selects over a copy of
+     * the range's value column.
+     */
+    SensorStatistics rangeStatistics(int64_t t0, int64_t t1) const;
+
+private:
+    static ReadingBatch sortedByTime(ReadingBatch batch);
+    static ReadingBatch mergeByTime(const ReadingBatch& left, const ReadingBatch& right);
+
+    size_t lowerBound(int64_t timestamp) const;
+    void rebuildBlocks(size_t firstBlock);
+
+    ReadingBatch rows_;
+    std::vector<TimeBlock> blocks_;
+    size_t blockRows_;
+};
+
+#endif // TIME_INDEXED_STORE_H
@@ -0,0 +1,96 @@
+#ifndef TIME_SERIES_CODEC_H
+#define TIME_SERIES_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Gorilla-style compression for one sensor stream
+ *
+ * A block is a run of readings from a single (sensor, type) stream, encoded
+ * as one bit stream with timestamps and values interleaved row by row:
+ *  - timestamps: the first is stored raw, then each delta-of-delta goes into
+ *    a variable-width bucket ('0' for a regular interval, so evenly sampled
+ *    streams cost one bit per row)
+ *  - values: the first is stored raw, then each value is XORed with its
+ *    predecessor and only the meaningful bits are kept ('0' for a repeat,
+ *    reusing the previous leading/trailing-zero window when it fits)
+ *
+ * Encoding is lossless for every timestamp and every double bit pattern.
+ * The block does not store its row count; the container records it.
+ */
+namespace TimeSeriesCodec {
+
+/**
+ * @brief Appends bit fields most-significant bit first to a byte buffer
+ */
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out), buffer_(0), bits_(0) {}
+
+    /**
+     * @brief Append the low @p count bits of @p value (1 to 64)
+     */
+    void write(uint64_t value, int count);
+
+    /**
+     * @brief Pad the last partial byte with zero bits
+     */
+    void flush();
+
+private:
+    std::vector<uint8_t>& out_;
+    uint64_t buffer_;  // Pending bits, right-aligned
+    int bits_;
+};
+
+/**
+ * @brief Reads bit fields written by BitWriter
+ */
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size)
+        : data_(data), size_(size), offset_(0), buffer_(0), bits_(0) {}
+
+    /**
+     * @brief Read the next @p count bits (1 to 64)
+     * @throws std::runtime_error if the buffer ends first
+     */
+    uint64_t read(int count);
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_;
+    uint64_t buffer_;  // Unread bits, right-aligned
+    int bits_;
+};
+
+/**
+ * @brief Append the encoding of @p rows readings to @p out
+ */
+void encodeBlock(const int64_t* timestamps, const double* values, size_t rows,
+                 std::vector<uint8_t>& out);
+
+/**
+ * @brief Most rows a block of @p size bytes can hold
+ *
+ * The first row takes 128 bits and every later row at least two (an
+ * unchanged interval and a repeated value), so containers can reject a row
+ * count the block could not have encoded before allocating for it.
+ */
+size_t maxRows(size_t size);
+
+/**
+ * @brief Decode @p rows readings from a block produced by encodeBlock
+ * @param data Start of the block
+ * @param size Block size in bytes
+ * @throws std::runtime_error if the block is shorter than @p rows readings need
+ */
+void decodeBlock(const uint8_t* data, size_t size, size_t rows,
+                 int64_t* timestamps, double* values);
+
+}  // namespace TimeSeriesCodec
+
+#endif // TIME_SERIES_CODEC_H
@@ -0,0 +1,138 @@
+#ifndef VALUE_KERNELS_H
+#define VALUE_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Vectorized scans over contiguous value columns
+ *
+ * Each kernel has a scalar implementation plus SSE2 and AVX2 versions on
+ * x86-64. The widest instruction set the CPU supports is picked once at
+ * first use; every other platform or compiler uses the scalar code.
+ * Apart from sum(), whose summation order depends on vector width, all
+ * implementations return bit-identical results. minMax() skips NaN the
+ * same way everywhere; only the sign of a zero extreme (0.0 against -0.0)
+ * may depend on the implementation.
+ */
+namespace ValueKernels {
+
+enum class Isa {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+/**
+ * @brief Row bitmap: bit i of word i / 64 is row i
+ */
+using RowMask = std::vector<uint64_t>;
+
+/**
+ * @brief Number of 64-bit words needed to cover @p rows rows
+ */
+inline size_t maskWords(size_t rows) {
+    return (rows + 63) / 64;
+}
+
+/**
+ * @brief Index of the lowest set bit
+ * @pre word != 0
+ */
+inline int lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * @brief Number of set bits
+ */
+inline int popcount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    for (; word; word &= word - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Call @p fn(row) for every set bit of @p mask in ascending order
+ */
+template <typename Fn>
+void forEachSetBit(const RowMask& mask, Fn fn) {
+    for (size_t w = 0; w < mask.size(); ++w) {
+        for (uint64_t word = mask[w]; word; word &= word - 1) {
+            fn(w * 64 + lowestBit(word));
+        }
+    }
+}
+
+struct MinMax {
+    double min;
+    double max;
+};
+
+/**
+ * @brief Instruction set the kernels currently dispatch to
+ */
+Isa activeIsa();
+
+/**
+ * @brief Printable name of an instruction set
+ */
+const char* isaName(Isa isa);
+
+/**
+ * @brief Force a specific implementation (for tests and benchmarks)
+ * @return false, leaving dispatch unchanged, if the CPU lacks @p isa
+ */
+bool setIsa(Isa isa);
+
+/**
+ * @brief Smallest and largest value, ignoring NaN
+ *
+ * NaN only comes back when every value is NaN.
+ * @pre count > 0
+ */
+MinMax minMax(const double* values, size_t count);
+
+/**
+ * @brief Sum of all values
+ */
+double sum(const double* values, size_t count);
+
+/**
+ * @brief Bitmask of values in [lower, upper]
+ * @param mask Output of (count + 63) / 64 words; bit i of word i / 64 is row i
+ * @return Number of set bits
+ */
+size_t rangeMask(const double* values, size_t count,
+                 double lower, double upper, uint64_t* mask);
+
+/**
+ * @brief Intersect @p other into @p mask (both the same length)
+ * @return Number of bits left set
+ */
+size_t andMask(RowMask& mask, const RowMask& other);
+
+/**
+ * @brief In-place affine map values[i] = (values[i] - offset) / scale
+ */
+void normalize(double* values, size_t count, double offset, double scale);
+
+}  // namespace ValueKernels
+
+#endif // VALUE_KERNELS_H
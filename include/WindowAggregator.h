@@ -0,0 +1,125 @@
+#ifndef WINDOW_AGGREGATOR_H
+#define WINDOW_AGGREGATOR_H
+
+#include "SensorDataProcessor.h"
+#include "ReadingBatch.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Statistics for one time window of one group
+ */
+struct WindowStatistics {
+    GroupKey key;         // Only the fields of the aggregator's GroupBy are meaningful
+    int64_t windowStart;  // Inclusive, in milliseconds
+    int64_t windowEnd;    // Exclusive, in milliseconds
+    SensorStatistics stats;
+};
+
+/**
+ * @brief Incremental tumbling and hopping time-window statistics
+ *
+ * Windows of @c sizeMs start at every multiple of @c slideMs (tumbling when
+ * the two are equal). Time is cut into panes of gcd(size, slide) so each
+ * reading is aggregated once into its pane, however many windows overlap it.
+ * Per group, the panes of the current window sit in a two-stack queue that
+ * keeps min, max and sum without rescanning on eviction, and the count is
+ * maintained by subtract-on-evict. Advancing a window therefore costs O(1)
+ * amortized per pane; only the exact median reads the window's values.
+ *
+ * Readings may arrive out of order by up to @c allowedLatenessMs behind the
+ * largest timestamp seen. A window is emitted once the watermark (largest
+ * timestamp minus lateness) passes its end; readings for panes that have
+ * already been folded into an emitted window are counted as late and dropped.
+ */
+class WindowAggregator {
+public:
+    /**
+     * @brief Create an aggregator
+     * @param sizeMs Window length in milliseconds
+     * @param slideMs Distance between window starts (equal to sizeMs for tumbling)
+     * @param groupBy TYPE, SENSOR or TYPE_AND_SENSOR to split windows by group;
+     *                TIME_BUCKET aggregates all readings of a window together
+     * @param allowedLatenessMs How far behind the newest reading data may still arrive
+     * @throws std::invalid_argument unless 0 < slideMs <= sizeMs
+     */
+    WindowAggregator(int64_t sizeMs, int64_t slideMs,
+                     GroupBy groupBy = GroupBy::TYPE_AND_SENSOR,
+                     int64_t allowedLatenessMs = 0);
+    ~WindowAggregator();
+
+    WindowAggregator(const WindowAggregator&) = delete;
+    WindowAggregator& operator=(const WindowAggregator&) = delete;
+
+    /**
+     * @brief Fold every row of a batch into its pane
+     */
+    void add(const ReadingBatch& batch);
+
+    /**
+     * @brief Fold a single reading into its pane
+     */
+    void add(SensorReading::SensorKey sensorKey, SensorReading::SensorType type,
+             double value, int64_t timestamp);
+
+    /**
+     * @brief Emit every non-empty window that closed since the last call
+     * @return Windows ordered by start, then group
+     */
+    std::vector<WindowStatistics> takeClosed();
+
+    /**
+     * @brief Emit every remaining non-empty window, as if the stream ended
+     */
+    std::vector<WindowStatistics> flush();
+
+    /**
+     * @brief Readings dropped because their window had already been emitted
+     */
+    size_t lateCount() const { return lateCount_; }
+
+private:
+    struct Aggregate {
+        double sum;
+        double min;
+        double max;
+    };
+
+    struct Pane {
+        Aggregate aggregate;
+        size_t count;
+        std::vector<double> values;  // Kept for the exact median
+    };
+
+    struct StackEntry {
+        int64_t pane;
+        size_t count;
+        Aggregate aggregate;
+        Aggregate suffix;  // Front stack: this entry combined with every newer one below it
+    };
+
+    struct GroupState;
+
+    static Aggregate identity();
+    static Aggregate combine(const Aggregate& a, const Aggregate& b);
+    static int64_t floorDiv(int64_t a, int64_t b);
+
+    GroupState& groupFor(SensorReading::SensorKey sensorKey, SensorReading::SensorType type);
+    int64_t firstWindowContaining(int64_t timestamp) const;
+    void emitClosed(GroupState& group, int64_t limit, std::vector<WindowStatistics>& out);
+    std::vector<WindowStatistics> emitAll(int64_t limit);
+
+    int64_t sizeMs_;
+    int64_t slideMs_;
+    int64_t paneMs_;
+    GroupBy groupBy_;
+    int64_t allowedLatenessMs_;
+    int64_t maxTimestamp_;
+    bool seenAny_;
+    size_t lateCount_;
+    std::vector<std::unique_ptr<GroupState>> groups_;  // Indexed by dense group id
+};
+
+#endif // WINDOW_AGGREGATOR_H
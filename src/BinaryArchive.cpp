@@ -0,0 +1,231 @@
+#include "BinaryArchive.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+#include "SensorIdTable.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// Binary archive (.sdb) layout constants
+const char kBinaryMagic[4] = {'S', 'D', 'B', '1'};
+const uint32_t kBinaryVersion = 1;
+
+// Column schema: name, element width in bytes
+struct ColumnSpec {
+    const char* name;
+    uint32_t width;
+};
+const ColumnSpec kBinaryColumns[] = {
+    {"value", sizeof(double)},
+    {"timestamp", sizeof(int64_t)},
+    {"type", sizeof(uint8_t)},
+    {"sensor", sizeof(uint32_t)}
+};
+const size_t kBinaryRowBytes = sizeof(double) + sizeof(int64_t) + sizeof(uint8_t) + sizeof(uint32_t);
+
+}  // namespace
+
+namespace BinaryArchive {
+
+void writeString(std::ostream& out, const std::string& str) {
+    writePod(out, static_cast<uint32_t>(str.size()));
+    out.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+void writeTypeDictionary(std::ostream& out) {
+    writePod(out, static_cast<uint32_t>(SensorReading::kTypeCount));
+    for (uint32_t code = 0; code < SensorReading::kTypeCount; ++code) {
+        writeString(out, SensorReading::typeToString(static_cast<SensorReading::SensorType>(code)));
+    }
+}
+
+void writeSensorDictionary(std::ostream& out, const std::vector<SensorReading::SensorKey>& sensors) {
+    writePod(out, static_cast<uint32_t>(sensors.size()));
+    for (SensorReading::SensorKey key : sensors) {
+        writeString(out, SensorIdTable::global().resolve(key));
+    }
+}
+
+std::vector<SensorReading::SensorType> readTypeDictionary(Cursor& cursor) {
+    uint32_t typeCount = cursor.read<uint32_t>();
+    cursor.requireFits(typeCount, sizeof(uint32_t));
+    std::vector<SensorReading::SensorType> typeByCode(typeCount);
+    for (uint32_t code = 0; code < typeCount; ++code) {
+        if (!SensorReading::parseType(cursor.readString(), typeByCode[code])) {
+            throw std::runtime_error("Unknown sensor type in archive: " + cursor.filepath());
+        }
+    }
+    return typeByCode;
+}
+
+std::vector<SensorReading::SensorKey> readSensorDictionary(Cursor& cursor) {
+    uint32_t sensorCount = cursor.read<uint32_t>();
+    cursor.requireFits(sensorCount, sizeof(uint32_t));
+    std::vector<SensorReading::SensorKey> keyByIndex(sensorCount);
+    for (uint32_t index = 0; index < sensorCount; ++index) {
+        keyByIndex[index] = SensorIdTable::global().intern(cursor.readString());
+    }
+    return keyByIndex;
+}
+
+ReadingBatch read(const std::string& filepath) {
+    MappedFile mapped(filepath);
+    Cursor cursor(mapped.data(), mapped.size(), filepath);
+
+    if (std::memcmp(cursor.take(sizeof(kBinaryMagic)), kBinaryMagic, sizeof(kBinaryMagic)) != 0) {
+        throw std::runtime_error("Not a sensor archive: " + filepath);
+    }
+    if (cursor.read<uint32_t>() != kBinaryVersion) {
+        throw std::runtime_error("Unsupported sensor archive version: " + filepath);
+    }
+    if (cursor.read<uint32_t>() != kByteOrderMark) {
+        throw std::runtime_error("Sensor archive has foreign byte order: " + filepath);
+    }
+
+    uint32_t columnCount = cursor.read<uint32_t>();
+    if (columnCount != std::size(kBinaryColumns)) {
+        throw std::runtime_error("Unexpected sensor archive schema: " + filepath);
+    }
+    for (const auto& column : kBinaryColumns) {
+        std::string_view name = cursor.readString();
+        uint32_t width = cursor.read<uint32_t>();
+        if (name != column.name || width != column.width) {
+            throw std::runtime_error("Unexpected sensor archive schema: " + filepath);
+        }
+    }
+
+    std::vector<SensorReading::SensorType> typeByCode = readTypeDictionary(cursor);
+    std::vector<SensorReading::SensorKey> keyByIndex = readSensorDictionary(cursor);
+
+    // Validate the counts against the mapped size before reserving for them
+    uint64_t rowCount = cursor.read<uint64_t>();
+    uint64_t rowGroupCount = cursor.read<uint64_t>();
+    cursor.requireFits(rowCount, kBinaryRowBytes);
+    cursor.requireFits(rowGroupCount, sizeof(uint32_t));
+
+    ReadingBatch batch;
+    batch.reserve(static_cast<size_t>(rowCount));
+    for (uint64_t group = 0; group < rowGroupCount; ++group) {
+        size_t rows = cursor.read<uint32_t>();
+        const char* valueBytes = cursor.take(rows * sizeof(double));
+        const char* timestampBytes = cursor.take(rows * sizeof(int64_t));
+        const auto* typeCodes = reinterpret_cast<const uint8_t*>(cursor.take(rows));
+        const char* indexBytes = cursor.take(rows * sizeof(uint32_t));
+
+        // Fixed-width columns go straight into the batch; memcpy because the
+        // mapped columns need not be aligned
+        size_t base = batch.size();
+        batch.resize(base + rows);
+        std::memcpy(batch.values().data() + base, valueBytes, rows * sizeof(double));
+        std::memcpy(batch.timestamps().data() + base, timestampBytes, rows * sizeof(int64_t));
+
+        auto* types = batch.types().data() + base;
+        auto* keys = batch.sensorKeys().data() + base;
+        for (size_t i = 0; i < rows; ++i) {
+            uint32_t index;
+            std::memcpy(&index, indexBytes + i * sizeof(uint32_t), sizeof(uint32_t));
+            if (typeCodes[i] >= typeByCode.size() || index >= keyByIndex.size()) {
+                throw std::runtime_error("Corrupt row group in sensor archive: " + filepath);
+            }
+            types[i] = typeByCode[typeCodes[i]];
+            keys[i] = keyByIndex[index];
+        }
+    }
+
+    if (batch.size() != rowCount) {
+        throw std::runtime_error("Row count mismatch in sensor archive: " + filepath);
+    }
+    PROFILE_COUNT("ingest.bytesRead", mapped.size());
+    return batch;
+}
+
+}  // namespace BinaryArchive
+
+BinaryArchiveWriter::BinaryArchiveWriter(const std::string& filepath,
+                                         const std::vector<SensorReading::SensorKey>& sensors,
+                                         size_t rowGroupRows)
+    : file_(filepath, std::ios::binary), rowGroupRows_(std::max<size_t>(1, rowGroupRows)),
+      rowCount_(0), rowGroupCount_(0) {
+    if (!file_.is_open()) {
+        return;
+    }
+
+    // Dictionary index of every global key; unassigned keys are rejected by write()
+    for (size_t i = 0; i < sensors.size(); ++i) {
+        if (sensors[i] >= localIndex_.size()) {
+            localIndex_.resize(sensors[i] + 1, kUnassigned);
+        }
+        localIndex_[sensors[i]] = static_cast<uint32_t>(i);
+    }
+
+    // Header: magic, version, byte order, schema, dictionaries, row counts
+    file_.write(kBinaryMagic, sizeof(kBinaryMagic));
+    BinaryArchive::writePod(file_, kBinaryVersion);
+    BinaryArchive::writePod(file_, BinaryArchive::kByteOrderMark);
+    BinaryArchive::writePod(file_, static_cast<uint32_t>(std::size(kBinaryColumns)));
+    for (const auto& column : kBinaryColumns) {
+        BinaryArchive::writeString(file_, column.name);
+        BinaryArchive::writePod(file_, column.width);
+    }
+    BinaryArchive::writeTypeDictionary(file_);
+    BinaryArchive::writeSensorDictionary(file_, sensors);
+    countsOffset_ = file_.tellp();
+    BinaryArchive::writePod(file_, rowCount_);  // Placeholders until close()
+    BinaryArchive::writePod(file_, rowGroupCount_);
+}
+
+BinaryArchiveWriter::~BinaryArchiveWriter() {
+    if (file_.is_open()) {
+        close();
+    }
+}
+
+bool BinaryArchiveWriter::write(const ReadingBatch& batch) {
+    PROFILE_SCOPE("write.binary");
+    if (!file_.is_open()) {
+        return false;
+    }
+
+    // Row groups: row count, then each column contiguously
+    for (size_t start = 0; start < batch.size(); start += rowGroupRows_) {
+        size_t rows = std::min(rowGroupRows_, batch.size() - start);
+        typeCodes_.resize(rows);
+        sensorIndexes_.resize(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            SensorReading::SensorKey key = batch.sensorKeys()[start + i];
+            if (key >= localIndex_.size() || localIndex_[key] == kUnassigned) {
+                throw std::invalid_argument("Sensor is not in the archive dictionary: " +
+                                            SensorIdTable::global().resolve(key));
+            }
+            typeCodes_[i] = static_cast<uint8_t>(batch.types()[start + i]);
+            sensorIndexes_[i] = localIndex_[key];
+        }
+
+        BinaryArchive::writePod(file_, static_cast<uint32_t>(rows));
+        file_.write(reinterpret_cast<const char*>(batch.values().data() + start),
+                    static_cast<std::streamsize>(rows * sizeof(double)));
+        file_.write(reinterpret_cast<const char*>(batch.timestamps().data() + start),
+                    static_cast<std::streamsize>(rows * sizeof(int64_t)));
+        file_.write(reinterpret_cast<const char*>(typeCodes_.data()),
+                    static_cast<std::streamsize>(rows * sizeof(uint8_t)));
+        file_.write(reinterpret_cast<const char*>(sensorIndexes_.data()),
+                    static_cast<std::streamsize>(rows * sizeof(uint32_t)));
+        rowCount_ += rows;
+        ++rowGroupCount_;
+    }
+    PROFILE_COUNT("write.rows", batch.size());
+    return static_cast<bool>(file_);
+}
+
+bool BinaryArchiveWriter::close() {
+    if (!file_.is_open()) {
+        return false;
+    }
+    PROFILE_COUNT("write.bytes", file_.tellp());
+    file_.seekp(countsOffset_);
+    BinaryArchive::writePod(file_, rowCount_);
+    BinaryArchive::writePod(file_, rowGroupCount_);
+    file_.close();
+    return static_cast<bool>(file_);
+}
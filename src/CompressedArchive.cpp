@@ -0,0 +1,265 @@
+#include "CompressedArchive.h"
+#include "BinaryArchive.h"
+#include "Profiler.h"
+#include "SensorIdTable.h"
+#include "ThreadPool.h"
+#include "TimeSeriesCodec.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Compressed archive (.sdc) layout constants
+const char kCompressedMagic[4] = {'S', 'D', 'C', '1'};
+const uint32_t kCompressedVersion = 1;
+const size_t kCompressedTrailerBytes = sizeof(uint64_t) + sizeof(kCompressedMagic);
+const size_t kCompressedBlockEntryBytes = 2 * sizeof(uint32_t) + sizeof(uint8_t) +
+                                          5 * sizeof(uint64_t) + sizeof(uint32_t);
+
+using BinaryArchive::kByteOrderMark;
+using BinaryArchive::writePod;
+using BinaryArchive::Cursor;
+
+}  // namespace
+
+CompressedArchiveWriter::CompressedArchiveWriter(const std::string& filepath, size_t blockRows)
+    : file_(filepath, std::ios::binary),
+      blockRows_(std::min(std::max<size_t>(1, blockRows), kMaxBlockRows)),
+      rowCount_(0), offset_(0) {
+    if (!file_.is_open()) {
+        return;
+    }
+    file_.write(kCompressedMagic, sizeof(kCompressedMagic));
+    writePod(file_, kCompressedVersion);
+    writePod(file_, kByteOrderMark);
+    offset_ = sizeof(kCompressedMagic) + 2 * sizeof(uint32_t);
+}
+
+CompressedArchiveWriter::~CompressedArchiveWriter() {
+    if (file_.is_open()) {
+        close();
+    }
+}
+
+bool CompressedArchiveWriter::write(const ReadingBatch& batch) {
+    PROFILE_SCOPE("write.compressed");
+    if (!file_.is_open()) {
+        return false;
+    }
+
+    for (size_t row = 0; row < batch.size(); ++row) {
+        SensorReading::SensorKey key = batch.sensorKeys()[row];
+        SensorReading::SensorType type = batch.types()[row];
+        size_t slot = static_cast<size_t>(key) * SensorReading::kTypeCount + static_cast<size_t>(type);
+        if (slot >= streamIndex_.size()) {
+            streamIndex_.resize(slot + 1, kUnassigned);
+        }
+        if (streamIndex_[slot] == kUnassigned) {
+            streamIndex_[slot] = static_cast<uint32_t>(streams_.size());
+            streams_.push_back(Stream{key, type, {}, {}});
+        }
+
+        uint32_t stream = streamIndex_[slot];
+        streams_[stream].timestamps.push_back(batch.timestamps()[row]);
+        streams_[stream].values.push_back(batch.values()[row]);
+        if (streams_[stream].values.size() == blockRows_) {
+            flushStream(stream);
+        }
+    }
+    rowCount_ += batch.size();
+    PROFILE_COUNT("write.rows", batch.size());
+    return static_cast<bool>(file_);
+}
+
+void CompressedArchiveWriter::flushStream(uint32_t stream) {
+    Stream& pending = streams_[stream];
+    size_t rows = pending.values.size();
+    if (rows == 0) {
+        return;
+    }
+
+    BlockEntry entry;
+    entry.stream = stream;
+    entry.rows = static_cast<uint32_t>(rows);
+    auto timeRange = std::minmax_element(pending.timestamps.begin(), pending.timestamps.end());
+    entry.minTimestamp = *timeRange.first;
+    entry.maxTimestamp = *timeRange.second;
+    auto valueRange = std::minmax_element(pending.values.begin(), pending.values.end());
+    entry.minValue = *valueRange.first;
+    entry.maxValue = *valueRange.second;
+
+    encoded_.clear();
+    TimeSeriesCodec::encodeBlock(pending.timestamps.data(), pending.values.data(), rows, encoded_);
+    entry.offset = offset_;
+    entry.bytes = static_cast<uint32_t>(encoded_.size());
+    file_.write(reinterpret_cast<const char*>(encoded_.data()),
+                static_cast<std::streamsize>(encoded_.size()));
+    offset_ += encoded_.size();
+    blocks_.push_back(entry);
+
+    pending.timestamps.clear();
+    pending.values.clear();
+}
+
+bool CompressedArchiveWriter::close() {
+    if (!file_.is_open()) {
+        return false;
+    }
+    for (uint32_t stream = 0; stream < streams_.size(); ++stream) {
+        flushStream(stream);
+    }
+
+    // File-local sensor dictionary: distinct keys in first-seen stream order
+    std::vector<uint32_t> sensorIndex(streams_.size());
+    std::vector<SensorReading::SensorKey> dictionary;
+    std::vector<uint32_t> indexByKey;
+    for (size_t stream = 0; stream < streams_.size(); ++stream) {
+        SensorReading::SensorKey key = streams_[stream].sensorKey;
+        if (key >= indexByKey.size()) {
+            indexByKey.resize(key + 1, kUnassigned);
+        }
+        if (indexByKey[key] == kUnassigned) {
+            indexByKey[key] = static_cast<uint32_t>(dictionary.size());
+            dictionary.push_back(key);
+        }
+        sensorIndex[stream] = indexByKey[key];
+    }
+
+    // Footer: dictionaries, counts, block directory; then its offset and the magic
+    uint64_t footerOffset = offset_;
+    BinaryArchive::writeTypeDictionary(file_);
+    BinaryArchive::writeSensorDictionary(file_, dictionary);
+    writePod(file_, rowCount_);
+    writePod(file_, static_cast<uint64_t>(blocks_.size()));
+    for (const BlockEntry& entry : blocks_) {
+        writePod(file_, sensorIndex[entry.stream]);
+        writePod(file_, static_cast<uint8_t>(streams_[entry.stream].type));
+        writePod(file_, entry.rows);
+        writePod(file_, entry.minTimestamp);
+        writePod(file_, entry.maxTimestamp);
+        writePod(file_, entry.minValue);
+        writePod(file_, entry.maxValue);
+        writePod(file_, entry.offset);
+        writePod(file_, entry.bytes);
+    }
+    writePod(file_, footerOffset);
+    file_.write(kCompressedMagic, sizeof(kCompressedMagic));
+    PROFILE_COUNT("write.bytes", file_.tellp());
+    file_.close();
+    return static_cast<bool>(file_);
+}
+
+CompressedArchiveReader::CompressedArchiveReader(const std::string& filepath)
+    : filepath_(filepath), mapped_(filepath), rowCount_(0) {
+    const char* data = mapped_.data();
+    size_t size = mapped_.size();
+    Cursor header(data, size, filepath_);
+    if (std::memcmp(header.take(sizeof(kCompressedMagic)), kCompressedMagic,
+                    sizeof(kCompressedMagic)) != 0) {
+        throw std::runtime_error("Not a compressed sensor archive: " + filepath);
+    }
+    if (header.read<uint32_t>() != kCompressedVersion) {
+        throw std::runtime_error("Unsupported compressed sensor archive version: " + filepath);
+    }
+    if (header.read<uint32_t>() != kByteOrderMark) {
+        throw std::runtime_error("Sensor archive has foreign byte order: " + filepath);
+    }
+
+    size_t blocksBegin = sizeof(kCompressedMagic) + 2 * sizeof(uint32_t);
+    if (size < blocksBegin + kCompressedTrailerBytes ||
+        std::memcmp(data + size - sizeof(kCompressedMagic), kCompressedMagic,
+                    sizeof(kCompressedMagic)) != 0) {
+        throw std::runtime_error("Truncated sensor archive: " + filepath);
+    }
+    uint64_t footerOffset;
+    std::memcpy(&footerOffset, data + size - kCompressedTrailerBytes, sizeof(footerOffset));
+    size_t footerEnd = size - kCompressedTrailerBytes;
+    if (footerOffset < blocksBegin || footerOffset > footerEnd) {
+        throw std::runtime_error("Corrupt footer in sensor archive: " + filepath);
+    }
+    Cursor cursor(data + footerOffset, footerEnd - static_cast<size_t>(footerOffset),
+                        filepath_);
+
+    std::vector<SensorReading::SensorType> typeByCode = BinaryArchive::readTypeDictionary(cursor);
+    std::vector<SensorReading::SensorKey> keyByIndex = BinaryArchive::readSensorDictionary(cursor);
+
+    rowCount_ = cursor.read<uint64_t>();
+    uint64_t blockCount = cursor.read<uint64_t>();
+    cursor.requireFits(blockCount, kCompressedBlockEntryBytes);
+    uint64_t rowsSeen = 0;
+    for (uint64_t i = 0; i < blockCount; ++i) {
+        uint32_t sensor = cursor.read<uint32_t>();
+        uint8_t typeCode = cursor.read<uint8_t>();
+        Block block;
+        block.rows = cursor.read<uint32_t>();
+        block.minTimestamp = cursor.read<int64_t>();
+        block.maxTimestamp = cursor.read<int64_t>();
+        block.minValue = cursor.read<double>();
+        block.maxValue = cursor.read<double>();
+        uint64_t offset = cursor.read<uint64_t>();
+        uint32_t bytes = cursor.read<uint32_t>();
+
+        // Row counts are bounded here because readAll() sizes a batch from them
+        if (sensor >= keyByIndex.size() || typeCode >= typeByCode.size() || offset < blocksBegin ||
+            offset > footerOffset || bytes > footerOffset - offset || block.rows == 0 ||
+            block.rows > CompressedArchiveWriter::kMaxBlockRows ||
+            block.rows > TimeSeriesCodec::maxRows(bytes)) {
+            throw std::runtime_error("Corrupt block directory in sensor archive: " + filepath);
+        }
+        block.sensorKey = keyByIndex[sensor];
+        block.type = typeByCode[typeCode];
+        blocks_.push_back(block);
+        offsets_.push_back(offset);
+        sizes_.push_back(bytes);
+        rowsSeen += block.rows;
+    }
+    if (rowsSeen != rowCount_) {
+        throw std::runtime_error("Row count mismatch in sensor archive: " + filepath);
+    }
+}
+
+void CompressedArchiveReader::decodeInto(size_t index, ReadingBatch& batch, size_t row) const {
+    const Block& block = blocks_[index];
+    const auto* bytes = reinterpret_cast<const uint8_t*>(mapped_.data()) + offsets_[index];
+    try {
+        TimeSeriesCodec::decodeBlock(bytes, sizes_[index], block.rows,
+                                     batch.timestamps().data() + row,
+                                     batch.values().data() + row);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(std::string(e.what()) + " in " + filepath_);
+    }
+    std::fill_n(batch.types().begin() + row, block.rows, block.type);
+    std::fill_n(batch.sensorKeys().begin() + row, block.rows, block.sensorKey);
+}
+
+void CompressedArchiveReader::decodeBlock(size_t index, ReadingBatch& batch) const {
+    size_t row = batch.size();
+    batch.resize(row + blocks_.at(index).rows);
+    decodeInto(index, batch, row);
+}
+
+ReadingBatch CompressedArchiveReader::readAll(size_t threadCount) const {
+    // Each block decodes independently into its own row range
+    std::vector<size_t> firstRow(blocks_.size());
+    size_t rows = 0;
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+        firstRow[i] = rows;
+        rows += blocks_[i].rows;
+    }
+
+    ReadingBatch batch;
+    batch.resize(rows);
+    auto body = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            decodeInto(i, batch, firstRow[i]);
+        }
+    };
+    if (threadCount == 1 || blocks_.size() < 2) {
+        body(0, blocks_.size());
+    } else {
+        ThreadPool pool(threadCount);
+        pool.parallelFor(blocks_.size(), 16, body);
+    }
+    return batch;
+}
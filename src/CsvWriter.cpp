@@ -0,0 +1,133 @@
+#include "CsvWriter.h"
+#include "SensorIdTable.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// Longest type name, shortest round-trip double and int64 plus separators
+const size_t kMaxFixedRowBytes = 13 + 24 + 20 + 4;
+
+char* appendText(char* out, std::string_view text) {
+    std::memcpy(out, text.data(), text.size());
+    return out + text.size();
+}
+
+}  // namespace
+
+CsvWriter::CsvWriter(std::ostream& out) : out_(out), bytesWritten_(0) {
+}
+
+CsvWriter::~CsvWriter() = default;
+
+void CsvWriter::setThreadCount(size_t threadCount) {
+    if (threadCount == 1) {
+        pool_.reset();
+        return;
+    }
+    pool_ = std::make_shared<ThreadPool>(threadCount);
+    if (pool_->size() == 1) {
+        pool_.reset();  // Single-core host: nothing to hand out
+    }
+}
+
+void CsvWriter::writeHeader(std::ostream& out) {
+    out << "sensor_id,type,value,timestamp\n";
+}
+
+void CsvWriter::refreshNames() {
+    // Keys only ever grow, so just resolve the ones interned since last time
+    const SensorIdTable& table = SensorIdTable::global();
+    for (size_t key = names_.size(), size = table.size(); key < size; ++key) {
+        names_.push_back(table.resolve(static_cast<SensorIdTable::Key>(key)));
+    }
+}
+
+template <typename KeyFn, typename TypeFn, typename ValueFn, typename TimeFn>
+size_t CsvWriter::formatRows(size_t begin, size_t end, KeyFn sensorKey, TypeFn type,
+                             ValueFn value, TimeFn timestamp,
+                             std::vector<char>& buffer) const {
+    size_t used = 0;
+    for (size_t row = begin; row < end; ++row) {
+        std::string_view name = names_[sensorKey(row)];
+        size_t worst = name.size() + kMaxFixedRowBytes;
+        if (used + worst > buffer.size()) {
+            buffer.resize(std::max(buffer.size() * 2, used + worst));
+        }
+        char* out = buffer.data() + used;
+        char* limit = buffer.data() + buffer.size();
+        out = appendText(out, name);
+        *out++ = ',';
+        out = appendText(out, SensorReading::typeName(type(row)));
+        *out++ = ',';
+        out = std::to_chars(out, limit, value(row)).ptr;
+        *out++ = ',';
+        out = std::to_chars(out, limit, timestamp(row)).ptr;
+        *out++ = '\n';
+        used = static_cast<size_t>(out - buffer.data());
+    }
+    return used;
+}
+
+bool CsvWriter::write(const ReadingBatch& batch) {
+    PROFILE_SCOPE("write.csvRows");
+    refreshNames();
+    const auto& values = batch.values();
+    const auto& timestamps = batch.timestamps();
+    const auto& types = batch.types();
+    const auto& keys = batch.sensorKeys();
+
+    // Format a wave of chunks (in parallel when pooled), then write them in order
+    const size_t chunkCount = (batch.size() + kChunkRows - 1) / kChunkRows;
+    const size_t waveChunks = pool_ ? pool_->size() * 2 : 1;
+    buffers_.resize(std::max(buffers_.size(), waveChunks));
+    used_.resize(buffers_.size());
+    for (size_t firstChunk = 0; firstChunk < chunkCount && out_; firstChunk += waveChunks) {
+        size_t wave = std::min(waveChunks, chunkCount - firstChunk);
+        auto body = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                size_t first = (firstChunk + i) * kChunkRows;
+                used_[i] = formatRows(
+                    first, std::min(batch.size(), first + kChunkRows),
+                    [&keys](size_t row) { return keys[row]; },
+                    [&types](size_t row) { return types[row]; },
+                    [&values](size_t row) { return values[row]; },
+                    [&timestamps](size_t row) { return timestamps[row]; },
+                    buffers_[i]);
+            }
+        };
+        if (pool_ && wave > 1) {
+            pool_->parallelFor(wave, 1, body);
+        } else {
+            body(0, wave);
+        }
+        for (size_t i = 0; i < wave; ++i) {
+            out_.write(buffers_[i].data(), static_cast<std::streamsize>(used_[i]));
+            bytesWritten_ += used_[i];
+        }
+    }
+    PROFILE_COUNT("write.rows", batch.size());
+    return static_cast<bool>(out_);
+}
+
+bool CsvWriter::write(const std::vector<SensorReading>& readings) {
+    PROFILE_SCOPE("write.csvRows");
+    refreshNames();
+    buffers_.resize(std::max<size_t>(buffers_.size(), 1));
+    for (size_t first = 0; first < readings.size() && out_; first += kChunkRows) {
+        size_t used = formatRows(
+            first, std::min(readings.size(), first + kChunkRows),
+            [&readings](size_t row) { return readings[row].getSensorKey(); },
+            [&readings](size_t row) { return readings[row].getType(); },
+            [&readings](size_t row) { return readings[row].getValue(); },
+            [&readings](size_t row) { return readings[row].getTimestamp(); },
+            buffers_[0]);
+        out_.write(buffers_[0].data(), static_cast<std::streamsize>(used));
+        bytesWritten_ += used;
+    }
+    PROFILE_COUNT("write.rows", readings.size());
+    return static_cast<bool>(out_);
+}
@@ -0,0 +1,219 @@
+#include "DataGenerator.h"
+#include "DataIngester.h"
+#include "CompressedArchive.h"
+#include "BinaryArchive.h"
+#include "CsvWriter.h"
+#include "SensorIdTable.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+const double kTwoPi = 6.283185307179586;
+const int64_t kDayMs = 24 * 3600 * 1000;
+const size_t kRowGrain = size_t(1) << 16;  // Rows per parallel chunk
+
+// Nominal value range per SensorReading::SensorType code
+const double kTypeRanges[SensorReading::kTypeCount][2] = {
+    {0.0, 100.0},      // TEMPERATURE
+    {0.0, 1000.0},     // PRESSURE
+    {0.0, 5000.0},     // DEPTH
+    {0.0, 10000.0},    // SONAR
+    {-10.0, 10.0},     // ACCELEROMETER
+    {-180.0, 180.0}    // GYROSCOPE
+};
+
+// Independent random streams
+enum Stream : uint64_t {
+    BASELINE,
+    DRIFT,
+    CYCLE_AMPLITUDE,
+    CYCLE_PHASE,
+    NOISE_RADIUS,
+    NOISE_ANGLE,
+    OUTLIER_CHANCE,
+    OUTLIER_MAGNITUDE,
+    STREAM_COUNT
+};
+
+}  // namespace
+
+DataGenerator::DataGenerator(const GeneratorOptions& options)
+    : options_(options), cycleStep_(0.0) {
+    if (options.sensorCount == 0 || options.types.empty() || options.intervalMs <= 0) {
+        throw std::invalid_argument(
+            "Generator needs at least one sensor and type and a positive interval");
+    }
+    // Seed and stream are mixed into each stream's key so neighbouring seeds share no values
+    streamKeys_.resize(STREAM_COUNT);
+    for (uint64_t stream = 0; stream < STREAM_COUNT; ++stream) {
+        streamKeys_[stream] = counterRandom(options.seed, stream);
+    }
+    cycleStep_ = kTwoPi * static_cast<double>(options.intervalMs) / kDayMs;
+
+    // Sensor IDs are zero-padded to a common width so they sort numerically
+    const size_t width = std::max<size_t>(3, std::to_string(options.sensorCount - 1).size());
+    const double samplesPerHour = 3600000.0 / static_cast<double>(options.intervalMs);
+    profiles_.reserve(options.sensorCount);
+    sensorKeys_.reserve(options.sensorCount);
+    for (size_t sensor = 0; sensor < options.sensorCount; ++sensor) {
+        std::string digits = std::to_string(sensor);
+        digits.insert(0, width - digits.size(), '0');
+        sensorKeys_.push_back(SensorIdTable::global().intern("SENSOR_" + digits));
+
+        SensorProfile profile;
+        profile.type = options.types[sensor % options.types.size()];
+        const double* range = kTypeRanges[static_cast<size_t>(profile.type)];
+        profile.span = range[1] - range[0];
+        profile.baseline = range[0] + profile.span * (0.3 + 0.4 * uniform(BASELINE, sensor));
+        profile.driftPerSample = (2.0 * uniform(DRIFT, sensor) - 1.0) *
+                                 options.driftFraction * profile.span / samplesPerHour;
+        profile.cycleAmplitude = 0.05 * profile.span * uniform(CYCLE_AMPLITUDE, sensor);
+        profile.cyclePhase = kTwoPi * uniform(CYCLE_PHASE, sensor);
+        profile.noiseSigma = options.noiseFraction * profile.span;
+        profiles_.push_back(profile);
+    }
+}
+
+DataGenerator::~DataGenerator() = default;
+
+void DataGenerator::setThreadCount(size_t threadCount) {
+    if (threadCount == 1) {
+        pool_.reset();
+        return;
+    }
+    pool_ = std::make_shared<ThreadPool>(threadCount);
+    if (pool_->size() == 1) {
+        pool_.reset();  // Single-core host: nothing to hand out
+    }
+}
+
+uint64_t DataGenerator::counterRandom(uint64_t key, uint64_t counter) {
+    uint64_t z = key + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+double DataGenerator::uniform(uint64_t stream, uint64_t counter) const {
+    return static_cast<double>(counterRandom(streamKeys_[stream], counter) >> 11) *
+           0x1.0p-53;  // [0, 1)
+}
+
+void DataGenerator::fillRows(uint64_t firstRow, size_t begin, size_t end,
+                             ReadingBatch& batch) const {
+    const uint64_t sensorCount = options_.sensorCount;
+    double* values = batch.values().data();
+    int64_t* timestamps = batch.timestamps().data();
+    SensorReading::SensorType* types = batch.types().data();
+    SensorReading::SensorKey* keys = batch.sensorKeys().data();
+
+    for (size_t i = begin; i < end; ++i) {
+        const uint64_t row = firstRow + i;
+        const uint64_t sensor = row % sensorCount;
+        const uint64_t sample = row / sensorCount;
+        const SensorProfile& profile = profiles_[sensor];
+
+        // Sensors sample at the same period, staggered evenly within it
+        timestamps[i] = options_.startTimestamp +
+                        static_cast<int64_t>(sample) * options_.intervalMs +
+                        static_cast<int64_t>(sensor) * options_.intervalMs /
+                            static_cast<int64_t>(sensorCount);
+
+        double value = profile.baseline + profile.driftPerSample * static_cast<double>(sample) +
+                       profile.cycleAmplitude *
+                           std::sin(cycleStep_ * static_cast<double>(sample) + profile.cyclePhase);
+
+        // Box-Muller; 1 - u keeps the logarithm finite
+        double radius = std::sqrt(-2.0 * std::log(1.0 - uniform(NOISE_RADIUS, row)));
+        value += profile.noiseSigma * radius * std::cos(kTwoPi * uniform(NOISE_ANGLE, row));
+
+        if (uniform(OUTLIER_CHANCE, row) < options_.outlierRate) {
+            double magnitude = uniform(OUTLIER_MAGNITUDE, row);
+            value = profile.baseline + (magnitude < 0.5 ? -1.0 : 1.0) *
+                                           profile.span * (3.0 + 4.0 * magnitude);
+        }
+
+        values[i] = value;
+        types[i] = profile.type;
+        keys[i] = sensorKeys_[sensor];
+    }
+}
+
+void DataGenerator::generate(uint64_t firstRow, size_t count, ReadingBatch& batch) const {
+    PROFILE_SCOPE("generate");
+    batch.clear();
+    batch.resize(count);
+    auto body = [&](size_t begin, size_t end) { fillRows(firstRow, begin, end, batch); };
+    if (pool_) {
+        pool_->parallelFor(count, kRowGrain, body);
+    } else {
+        for (size_t begin = 0; begin < count; begin += kRowGrain) {
+            body(begin, std::min(count, begin + kRowGrain));
+        }
+    }
+}
+
+ReadingBatch DataGenerator::generate(size_t count) const {
+    ReadingBatch batch;
+    generate(0, count, batch);
+    return batch;
+}
+
+uint64_t DataGenerator::writeFile(const std::string& filepath, uint64_t count,
+                                  size_t chunkRows) const {
+    DataIngester::FileFormat format = DataIngester::formatOf(filepath);
+    bool binary = format == DataIngester::FileFormat::BINARY_ARCHIVE;
+    bool compressed = format == DataIngester::FileFormat::COMPRESSED_ARCHIVE;
+    chunkRows = std::max<size_t>(1, chunkRows);
+
+    std::ofstream csv;
+    CsvWriter csvWriter(csv);
+    csvWriter.setThreadCount(pool_ ? pool_->size() : 1);
+    std::unique_ptr<BinaryArchiveWriter> archive;
+    std::unique_ptr<CompressedArchiveWriter> compressedArchive;
+    bool opened;
+    if (binary) {
+        archive = std::make_unique<BinaryArchiveWriter>(filepath, sensorKeys_);
+        opened = archive->isOpen();
+    } else if (compressed) {
+        compressedArchive = std::make_unique<CompressedArchiveWriter>(filepath);
+        opened = compressedArchive->isOpen();
+    } else {
+        csv.open(filepath);
+        opened = csv.is_open();
+        if (opened) {
+            CsvWriter::writeHeader(csv);
+        }
+    }
+    if (!opened) {
+        throw std::runtime_error("Cannot open file: " + filepath);
+    }
+
+    ReadingBatch chunk;
+    bool ok = true;
+    for (uint64_t first = 0; first < count && ok; first += chunkRows) {
+        size_t rows = static_cast<size_t>(std::min<uint64_t>(chunkRows, count - first));
+        generate(first, rows, chunk);
+        ok = binary ? archive->write(chunk)
+           : compressed ? compressedArchive->write(chunk)
+                        : csvWriter.write(chunk);
+    }
+
+    if (binary) {
+        ok = archive->close() && ok;
+    } else if (compressed) {
+        ok = compressedArchive->close() && ok;
+    } else {
+        csv.close();
+        ok = ok && static_cast<bool>(csv);
+    }
+    if (!ok) {
+        throw std::runtime_error("Failed to write file: " + filepath);
+    }
+    return count;
+}
@@ -1,30 +1,78 @@
 #include "DataIngester.h"
-#include <sstream>
+#include "BinaryArchive.h"
+#include "CompressedArchive.h"
+#include "MappedFile.h"
+#include "CsvWriter.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include <cstring>
+#include <charconv>
 #include <random>
 #include <chrono>
 #include <stdexcept>
 #include <algorithm>
-#include <map>
 #include <cctype>
+#include <thread>
+#include <iterator>
+#include <cstdint>
+#include <utility>
+#include <filesystem>
+
+#if SENSOR_PROFILING
+namespace {
+
+// Size of a file for the bytes-read counter, 0 if it cannot be determined
+uintmax_t fileSize(const std::string& filepath) {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(filepath, error);
+    return error ? 0 : size;
+}
+
+}  // namespace
+#endif // SENSOR_PROFILING
 
 DataIngester::DataIngester() {
 }
 
-std::vector<SensorReading> DataIngester::readFromFile(const std::string& filepath) {
+DataIngester::FileFormat DataIngester::formatOf(const std::string& filepath) {
+    auto hasExtension = [&filepath](const std::string& extension) {
+        return filepath.size() >= extension.size() &&
+            filepath.compare(filepath.size() - extension.size(), extension.size(), extension) == 0;
+    };
+    if (hasExtension(".sdb")) {
+        return FileFormat::BINARY_ARCHIVE;
+    }
+    if (hasExtension(".sdc")) {
+        return FileFormat::COMPRESSED_ARCHIVE;
+    }
+    return FileFormat::CSV;
+}
+
+template <typename Sink>
+void DataIngester::ingestRecord(std::string_view line, IngestStats& stats,
+                                Sink& sink) const {
+    SensorReading reading;
+    if (parseCSVLine(line, reading) == ParseStatus::OK && reading.isValid()) {
+        ++stats.rowsAccepted;
+        sink(reading);
+    } else {
+        ++stats.rowsRejected;
+    }
+}
+
+template <typename Sink>
+void DataIngester::forEachCSVReading(const std::string& filepath, Sink&& sink) {
     std::ifstream file(filepath);
     if (!file.is_open()) {
         throw std::runtime_error("Cannot open file: " + filepath);
     }
 
-    std::vector<SensorReading> readings;
+    lastStats_ = IngestStats();
     std::string line;
     
     // Skip header line if present
     if (std::getline(file, line)) {
-        // Check if it's a header (contains "sensor_id" or "timestamp")
-        std::transform(line.begin(), line.end(), line.begin(),
-                      [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-        if (line.find("sensor_id") == std::string::npos) {
+        if (!isHeaderLine(line)) {
             // Not a header, parse as data
             file.seekg(0);
         }
@@ -35,49 +83,239 @@ std::vector<SensorReading> DataIngester::readFromFile(const std::string& filepat
             continue;  // Skip empty lines and comments
         }
         
-        try {
-            SensorReading reading = parseCSVLine(line);
-            if (reading.isValid()) {
-                readings.push_back(reading);
-            }
-        } catch (const std::exception&) {
-            // Skip malformed lines, continue processing
-            continue;
-        }
+        ingestRecord(line, lastStats_, sink);
     }
 
     file.close();
+    PROFILE_COUNT("ingest.rowsParsed", lastStats_.rowsAccepted);
+    PROFILE_COUNT("ingest.rowsRejected", lastStats_.rowsRejected);
+    PROFILE_COUNT("ingest.bytesRead", fileSize(filepath));
+}
+
+std::vector<SensorReading> DataIngester::readFromFile(const std::string& filepath) {
+    PROFILE_SCOPE("ingest.csv");
+    std::vector<SensorReading> readings;
+    forEachCSVReading(filepath, [&readings](const SensorReading& reading) {
+        readings.push_back(reading);
+    });
     return readings;
 }
 
-SensorReading DataIngester::parseCSVLine(const std::string& line) {
-    std::istringstream iss(line);
-    std::string token;
-    std::vector<std::string> tokens;
+ReadingBatch DataIngester::readBatchFromFile(const std::string& filepath) {
+    PROFILE_SCOPE("ingest.csv");
+    ReadingBatch batch;
+    forEachCSVReading(filepath, [&batch](const SensorReading& reading) {
+        batch.append(reading);
+    });
+    return batch;
+}
 
-    while (std::getline(iss, token, ',')) {
-        // Trim whitespace
-        token.erase(0, token.find_first_not_of(" \t"));
-        token.erase(token.find_last_not_of(" \t") + 1);
-        tokens.push_back(token);
+void DataIngester::streamFromFile(
+    const std::string& filepath, size_t batchRows,
+    const std::function<void(const ReadingBatch&)>& callback) {
+    
+    PROFILE_SCOPE("ingest.stream");  // Includes the time spent in callback
+    batchRows = std::max<size_t>(1, batchRows);
+    ReadingBatch batch;
+    batch.reserve(std::min<size_t>(batchRows, 1 << 16));
+    forEachCSVReading(filepath, [&](const SensorReading& reading) {
+        batch.append(reading);
+        if (batch.size() == batchRows) {
+            callback(batch);
+            batch.clear();
+        }
+    });
+    if (!batch.empty()) {
+        callback(batch);
     }
+}
 
-    if (tokens.size() < 4) {
-        throw std::runtime_error("Invalid CSV format: expected at least 4 columns");
+ReadingBatch DataIngester::readBatchFromMappedFile(const std::string& filepath,
+                                                   size_t threadCount) {
+    std::vector<ReadingBatch> shards = readShardsFromMappedFile(filepath, threadCount);
+    if (shards.size() == 1) {
+        return std::move(shards.front());
     }
 
-    std::string sensorId = tokens[0];
-    SensorReading::SensorType type = SensorReading::stringToType(tokens[1]);
-    double value = std::stod(tokens[2]);
-    int64_t timestamp = std::stoll(tokens[3]);
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        total += shard.size();
+    }
 
-    return SensorReading(sensorId, type, value, timestamp);
+    ReadingBatch batch;
+    batch.reserve(total);
+    for (const auto& shard : shards) {
+        batch.append(shard);
+    }
+    return batch;
+}
+
+std::vector<ReadingBatch> DataIngester::readShardsFromMappedFile(
+    const std::string& filepath, size_t threadCount) {
+    
+    PROFILE_SCOPE("ingest.mmap");
+    MappedFile mapped(filepath);
+    const char* begin = mapped.data();
+    const char* end = begin + mapped.size();
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Don't bother splitting small files
+    const size_t minChunkBytes = 1 << 20;
+    threadCount = std::max<size_t>(1, std::min(threadCount, mapped.size() / minChunkBytes));
+
+    // Chunk boundaries: nominal split points moved forward past the next newline
+    std::vector<const char*> bounds;
+    bounds.push_back(begin);
+    for (size_t i = 1; i < threadCount; ++i) {
+        const char* split = std::max(bounds.back(), begin + mapped.size() * i / threadCount);
+        const char* newline = static_cast<const char*>(
+            std::memchr(split, '\n', static_cast<size_t>(end - split)));
+        bounds.push_back(newline ? newline + 1 : end);
+    }
+    bounds.push_back(end);
+
+    std::vector<ReadingBatch> shards(threadCount);
+    std::vector<IngestStats> stats(threadCount);
+    if (threadCount == 1) {
+        parseMappedRange(begin, end, true, shards[0], stats[0]);
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this, &bounds, &shards, &stats, i]() {
+                parseMappedRange(bounds[i], bounds[i + 1], i == 0, shards[i], stats[i]);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    lastStats_ = IngestStats();
+    for (const auto& shardStats : stats) {
+        lastStats_.rowsAccepted += shardStats.rowsAccepted;
+        lastStats_.rowsRejected += shardStats.rowsRejected;
+    }
+    PROFILE_COUNT("ingest.rowsParsed", lastStats_.rowsAccepted);
+    PROFILE_COUNT("ingest.rowsRejected", lastStats_.rowsRejected);
+    PROFILE_COUNT("ingest.bytesRead", mapped.size());
+    return shards;
+}
+
+void DataIngester::parseMappedRange(const char* begin, const char* end, bool skipHeader,
+                                    ReadingBatch& batch, IngestStats& stats) const {
+    // Rough row estimate so the columns rarely reallocate
+    batch.reserve(static_cast<size_t>(end - begin) / 40);
+    auto sink = [&batch](const SensorReading& reading) { batch.append(reading); };
+
+    const char* cursor = begin;
+    bool firstLine = skipHeader;
+    while (cursor < end) {
+        const char* newline = static_cast<const char*>(
+            std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+        const char* lineEnd = newline ? newline : end;
+        std::string_view line(cursor, static_cast<size_t>(lineEnd - cursor));
+        cursor = newline ? newline + 1 : end;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        if (firstLine) {
+            firstLine = false;
+            if (isHeaderLine(line)) {
+                continue;
+            }
+        }
+
+        if (line.empty() || line[0] == '#') {
+            continue;  // Skip empty lines and comments
+        }
+
+        ingestRecord(line, stats, sink);
+    }
+}
+
+namespace {
+
+// Parse a whole field as a number; a leading '+' is accepted like std::stod
+template <typename T>
+bool parseNumber(std::string_view field, T& out) {
+    if (!field.empty() && field[0] == '+') {
+        field.remove_prefix(1);
+        if (!field.empty() && field[0] == '-') {
+            return false;  // "+-5" is not a number
+        }
+    }
+    const char* end = field.data() + field.size();
+    auto result = std::from_chars(field.data(), end, out);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+}  // namespace
+
+DataIngester::ParseStatus DataIngester::parseCSVLine(std::string_view line,
+                                                      SensorReading& reading) const {
+    // Split into at most 4 views over the line; extra columns are ignored
+    std::string_view tokens[4];
+    size_t tokenCount = 0;
+    size_t start = 0;
+    while (tokenCount < 4 && start < line.size()) {
+        size_t comma = line.find(',', start);
+        size_t stop = (comma == std::string_view::npos) ? line.size() : comma;
+        std::string_view token = line.substr(start, stop - start);
+
+        // Trim whitespace (including a CR left by CRLF line endings)
+        size_t first = token.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos) {
+            token = std::string_view();
+        } else {
+            token = token.substr(first, token.find_last_not_of(" \t\r") - first + 1);
+        }
+        tokens[tokenCount++] = token;
+        start = stop + 1;
+    }
+
+    if (tokenCount < 4) {
+        return ParseStatus::MISSING_COLUMNS;
+    }
+
+    double value;
+    if (!parseNumber(tokens[2], value)) {
+        return ParseStatus::INVALID_VALUE;
+    }
+
+    int64_t timestamp;
+    if (!parseNumber(tokens[3], timestamp)) {
+        return ParseStatus::INVALID_TIMESTAMP;
+    }
+
+    SensorReading::SensorType type;
+    if (!SensorReading::parseType(tokens[1], type)) {
+        type = SensorReading::SensorType::TEMPERATURE;  // Same fallback as stringToType
+    }
+
+    reading = SensorReading(SensorIdTable::global().intern(tokens[0]), type, value, timestamp);
+    return ParseStatus::OK;
+}
+
+bool DataIngester::isHeaderLine(std::string_view line) {
+    // A header names its columns; match "sensor_id" in any letter case
+    static const std::string_view key = "sensor_id";
+    auto it = std::search(line.begin(), line.end(), key.begin(), key.end(),
+                          [](char a, char b) {
+                              return std::tolower(static_cast<unsigned char>(a)) == b;
+                          });
+    return it != line.end();
 }
 
 std::vector<SensorReading> DataIngester::generateSimulatedData(
     size_t count,
     const std::vector<std::string>& sensorIds,
     const std::vector<SensorReading::SensorType>& types) {
+    PROFILE_SCOPE("generate");
     
     if (sensorIds.empty() || types.empty()) {
         throw std::runtime_error("Sensor IDs and types must not be empty");
@@ -86,6 +324,13 @@ std::vector<SensorReading> DataIngester::generateSimulatedData(
     std::vector<SensorReading> readings;
     readings.reserve(count);
 
+    // Intern once up front so the per-reading loop only copies keys
+    std::vector<SensorReading::SensorKey> sensorKeys;
+    sensorKeys.reserve(sensorIds.size());
+    for (const auto& sensorId : sensorIds) {
+        sensorKeys.push_back(SensorIdTable::global().intern(sensorId));
+    }
+
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_int_distribution<size_t> sensorDist(0, sensorIds.size() - 1);
@@ -94,26 +339,29 @@ std::vector<SensorReading> DataIngester::generateSimulatedData(
     int64_t baseTimestamp = getCurrentTimestamp();
     std::uniform_int_distribution<int64_t> timeDist(0, 3600000);  // 1 hour range
 
-    // Value ranges for different sensor types
-    std::map<SensorReading::SensorType, std::pair<double, double>> valueRanges = {
-        {SensorReading::SensorType::TEMPERATURE, {0.0, 100.0}},
-        {SensorReading::SensorType::PRESSURE, {0.0, 1000.0}},
-        {SensorReading::SensorType::DEPTH, {0.0, 5000.0}},
-        {SensorReading::SensorType::SONAR, {0.0, 10000.0}},
-        {SensorReading::SensorType::ACCELEROMETER, {-10.0, 10.0}},
-        {SensorReading::SensorType::GYROSCOPE, {-180.0, 180.0}}
+    // Value distribution per sensor type code, built once rather than per reading
+    const std::pair<double, double> valueRanges[] = {
+        {0.0, 100.0},      // TEMPERATURE
+        {0.0, 1000.0},     // PRESSURE
+        {0.0, 5000.0},     // DEPTH
+        {0.0, 10000.0},    // SONAR
+        {-10.0, 10.0},     // ACCELEROMETER
+        {-180.0, 180.0}    // GYROSCOPE
     };
+    std::vector<std::uniform_real_distribution<double>> valueDists;
+    for (const auto& range : valueRanges) {
+        valueDists.emplace_back(range.first, range.second);
+    }
 
     for (size_t i = 0; i < count; ++i) {
-        std::string sensorId = sensorIds[sensorDist(gen)];
+        SensorReading::SensorKey sensorKey = sensorKeys[sensorDist(gen)];
         SensorReading::SensorType type = types[typeDist(gen)];
         
-        auto range = valueRanges[type];
-        double value = generateRandomValue(range.first, range.second);
+        double value = valueDists[static_cast<size_t>(type)](gen);
         
         int64_t timestamp = baseTimestamp + timeDist(gen);
 
-        readings.emplace_back(sensorId, type, value, timestamp);
+        readings.emplace_back(sensorKey, type, value, timestamp);
     }
 
     return readings;
@@ -121,24 +369,104 @@ std::vector<SensorReading> DataIngester::generateSimulatedData(
 
 bool DataIngester::writeToFile(const std::vector<SensorReading>& readings,
                                 const std::string& filepath) const {
+    PROFILE_SCOPE("write.csv");
     std::ofstream file(filepath);
     if (!file.is_open()) {
         return false;
     }
 
-    // Write header
-    file << "sensor_id,type,value,timestamp\n";
+    writeCSVHeader(file);
+    bool ok = CsvWriter(file).write(readings);
+
+    PROFILE_COUNT("write.bytes", file.tellp());
+    file.close();
+    return ok && static_cast<bool>(file);
+}
 
-    // Write data
-    for (const auto& reading : readings) {
-        file << reading.getSensorId() << ","
-             << SensorReading::typeToString(reading.getType()) << ","
-             << reading.getValue() << ","
-             << reading.getTimestamp() << "\n";
+bool DataIngester::writeToFile(const ReadingBatch& batch,
+                                const std::string& filepath, size_t threadCount) const {
+    PROFILE_SCOPE("write.csv");
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        return false;
     }
 
+    writeCSVHeader(file);
+    CsvWriter writer(file);
+    writer.setThreadCount(threadCount);
+    bool ok = writer.write(batch);
+
+    PROFILE_COUNT("write.bytes", file.tellp());
     file.close();
-    return true;
+    return ok && static_cast<bool>(file);
+}
+
+void DataIngester::writeCSVHeader(std::ostream& out) {
+    CsvWriter::writeHeader(out);
+}
+
+bool DataIngester::writeCSVRows(const ReadingBatch& batch, std::ostream& out) const {
+    return CsvWriter(out).write(batch);
+}
+
+bool DataIngester::writeBinaryFile(const ReadingBatch& batch, const std::string& filepath,
+                                   size_t rowGroupRows) const {
+    // File-local sensor dictionary: distinct keys in first-seen order
+    std::vector<bool> seen(SensorIdTable::global().size(), false);
+    std::vector<SensorReading::SensorKey> dictionary;
+    for (SensorReading::SensorKey key : batch.sensorKeys()) {
+        if (!seen[key]) {
+            seen[key] = true;
+            dictionary.push_back(key);
+        }
+    }
+
+    BinaryArchiveWriter writer(filepath, dictionary, rowGroupRows);
+    if (!writer.isOpen()) {
+        return false;
+    }
+    writer.write(batch);
+    return writer.close();
+}
+
+ReadingBatch DataIngester::readBinaryFile(const std::string& filepath) {
+    PROFILE_SCOPE("ingest.binary");
+    lastStats_ = IngestStats();
+    ReadingBatch batch = BinaryArchive::read(filepath);
+    lastStats_.rowsAccepted = batch.size();
+    PROFILE_COUNT("ingest.rowsParsed", lastStats_.rowsAccepted);
+    return batch;
+}
+
+bool DataIngester::writeCompressedFile(const ReadingBatch& batch, const std::string& filepath,
+                                       size_t blockRows) const {
+    CompressedArchiveWriter writer(filepath, blockRows);
+    if (!writer.isOpen()) {
+        return false;
+    }
+    writer.write(batch);
+    return writer.close();
+}
+
+ReadingBatch DataIngester::readCompressedFile(const std::string& filepath, size_t threadCount) {
+    PROFILE_SCOPE("ingest.compressed");
+    CompressedArchiveReader reader(filepath);
+    ReadingBatch batch = reader.readAll(threadCount);
+    lastStats_ = IngestStats();
+    lastStats_.rowsAccepted = batch.size();
+    PROFILE_COUNT("ingest.rowsParsed", lastStats_.rowsAccepted);
+    PROFILE_COUNT("ingest.bytesRead", reader.fileSize());
+    return batch;
+}
+
+TimeIndexedStore DataIngester::readTimeIndexedFile(const std::string& filepath,
+                                                   size_t threadCount, size_t blockRows) {
+    FileFormat format = formatOf(filepath);
+    ReadingBatch batch = format == FileFormat::BINARY_ARCHIVE ? readBinaryFile(filepath)
+                       : format == FileFormat::COMPRESSED_ARCHIVE
+                           ? readCompressedFile(filepath, threadCount)
+                           : readBatchFromMappedFile(filepath, threadCount);
+    return TimeIndexedStore(std::move(batch), blockRows);
 }
 
 int64_t DataIngester::getCurrentTimestamp() const {
@@ -146,11 +474,3 @@ int64_t DataIngester::getCurrentTimestamp() const {
     auto duration = now.time_since_epoch();
     return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
 }
-
-double DataIngester::generateRandomValue(double min, double max) const {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dist(min, max);
-    return dist(gen);
-}
-
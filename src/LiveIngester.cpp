@@ -0,0 +1,84 @@
+#include "LiveIngester.h"
+#include <string>
+
+LiveIngester::LiveIngester(std::istream& input, size_t ringCapacity)
+    : input_(input), ring_(ringCapacity), inputDone_(false), stop_(false),
+      rowsAccepted_(0), rowsRejected_(0), fullWaits_(0) {
+    reader_ = std::thread(&LiveIngester::readLoop, this);
+}
+
+LiveIngester::~LiveIngester() {
+    stop_.store(true, std::memory_order_relaxed);
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+}
+
+bool LiveIngester::push(const SensorReading& reading) {
+    while (!ring_.tryPush(reading)) {
+        if (stop_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        fullWaits_.fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::yield();  // Consumer is behind; let it drain
+    }
+    return true;
+}
+
+void LiveIngester::readLoop() {
+    try {
+        std::string line;
+        bool firstLine = true;
+        while (!stop_.load(std::memory_order_relaxed) && std::getline(input_, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (firstLine) {
+                firstLine = false;
+                if (DataIngester::isHeaderLine(line)) {
+                    continue;
+                }
+            }
+            if (line.empty() || line[0] == '#') {
+                continue;  // Skip empty lines and comments
+            }
+
+            SensorReading reading;
+            if (parser_.parseCSVLine(line, reading) == DataIngester::ParseStatus::OK &&
+                reading.isValid()) {
+                if (!push(reading)) {
+                    break;
+                }
+                rowsAccepted_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                rowsRejected_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    } catch (...) {
+        error_ = std::current_exception();
+    }
+    inputDone_.store(true, std::memory_order_release);
+}
+
+size_t LiveIngester::poll(ReadingBatch& batch, size_t maxRows) {
+    // Check for the end of input before draining, so a reading pushed just
+    // before the reader finished is never mistaken for an empty ring
+    bool done = inputDone_.load(std::memory_order_acquire);
+    if (drained_.size() < maxRows) {
+        drained_.resize(maxRows);
+    }
+    size_t count = ring_.tryPopBulk(drained_.data(), maxRows);
+    for (size_t i = 0; i < count; ++i) {
+        batch.append(drained_[i]);
+    }
+    if (count == 0 && done && error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+    return count;
+}
+
+bool LiveIngester::finished() const {
+    return inputDone_.load(std::memory_order_acquire) && ring_.empty();
+}
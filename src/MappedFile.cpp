@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define SENSOR_HAVE_MMAP 1
+#endif
+
+MappedFile::MappedFile(const std::string& filepath)
+    : data_(nullptr), size_(0), mapped_(false) {
+#ifdef SENSOR_HAVE_MMAP
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + filepath);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat file: " + filepath);
+    }
+
+    if (!S_ISREG(st.st_mode)) {
+        // Pipes and devices report no size and cannot be mapped: read them
+        // to the end instead
+        char chunk[64 * 1024];
+        ssize_t got;
+        while ((got = ::read(fd, chunk, sizeof(chunk))) != 0) {
+            if (got < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ::close(fd);
+                throw std::runtime_error("Cannot read file: " + filepath);
+            }
+            buffer_.insert(buffer_.end(), chunk, chunk + got);
+        }
+        ::close(fd);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        return;
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map file: " + filepath);
+        }
+        // Ingest is a single front-to-back scan
+        ::madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(addr);
+        mapped_ = true;
+    }
+    ::close(fd);  // The mapping keeps its own reference
+#else
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filepath);
+    }
+    std::streamoff end = file.tellg();
+    if (end < 0) {
+        // Not seekable (e.g. a pipe): read to the end instead
+        file.clear();
+        buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (file.bad()) {
+            throw std::runtime_error("Cannot read file: " + filepath);
+        }
+    } else {
+        buffer_.resize(static_cast<size_t>(end));
+        file.seekg(0);
+        if (!file.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()))) {
+            throw std::runtime_error("Short read from file: " + filepath);
+        }
+    }
+    size_ = buffer_.size();
+    data_ = buffer_.data();
+#endif
+}
+
+bool MappedFile::isRegularFile(const std::string& filepath) {
+#ifdef SENSOR_HAVE_MMAP
+    struct stat st;
+    return ::stat(filepath.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+#else
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    return file.is_open() && file.tellg() >= 0;
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef SENSOR_HAVE_MMAP
+    if (mapped_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
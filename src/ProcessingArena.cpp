@@ -0,0 +1,28 @@
+#include "ProcessingArena.h"
+#include <algorithm>
+
+namespace {
+
+const size_t kMinimumCapacity = 4096;
+
+}  // namespace
+
+ProcessingArena::ProcessingArena(size_t capacityBytes)
+    : capacity_(std::max(capacityBytes, kMinimumCapacity)),
+      // Default-initialized, so pages are only touched when first used
+      buffer_(new std::byte[capacity_]),
+      arena_(buffer_.get(), capacity_, &spill_) {}
+
+void* ProcessingArena::SpillResource::do_allocate(size_t bytes, size_t alignment) {
+    ++count;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void ProcessingArena::SpillResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool ProcessingArena::SpillResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,172 @@
+#include "Profiler.h"
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#if SENSOR_PROFILING
+
+namespace {
+
+std::atomic<uint64_t> allocationCounter(0);
+std::atomic<uint64_t> allocationBytes(0);
+
+}  // namespace
+
+// Counting replacements for the global allocation functions; array, nothrow
+// and sized forms forward to these
+void* operator new(std::size_t size) {
+    allocationCounter.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        if (void* p = std::malloc(size)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#endif // SENSOR_PROFILING
+
+Profiler::Profiler() : enabled_(false) {}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Site& Profiler::site(const char* name, Kind kind) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& existing : sites_) {
+        if (existing.kind == kind && existing.name == name) {
+            return existing;  // Same name from another call site or template instance
+        }
+    }
+    sites_.emplace_back(name, kind);
+    return sites_.back();
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& site : sites_) {
+        site.calls.store(0, std::memory_order_relaxed);
+        site.total.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t Profiler::allocationCount() {
+#if SENSOR_PROFILING
+    return allocationCounter.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+uint64_t Profiler::allocatedBytes() {
+#if SENSOR_PROFILING
+    return allocationBytes.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+size_t Profiler::peakRssBytes() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);  // Already bytes
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;  // Kilobytes
+#endif
+#else
+    return 0;
+#endif
+}
+
+void Profiler::writeTable(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out << "\nProfile:\n"
+        << "  " << std::left << std::setw(34) << "Stage" << std::right
+        << std::setw(10) << "Calls" << std::setw(14) << "Total ms" << "\n";
+    for (const auto& site : sites_) {
+        if (site.kind == Kind::STAGE && site.calls.load(std::memory_order_relaxed) > 0) {
+            out << "  " << std::left << std::setw(34) << site.name << std::right
+                << std::setw(10) << site.calls.load(std::memory_order_relaxed)
+                << std::setw(14) << std::fixed << std::setprecision(3)
+                << site.total.load(std::memory_order_relaxed) / 1e6 << "\n";
+        }
+    }
+    out << "  " << std::left << std::setw(34) << "Counter" << std::right
+        << std::setw(24) << "Value" << "\n";
+    for (const auto& site : sites_) {
+        if (site.kind == Kind::COUNTER && site.calls.load(std::memory_order_relaxed) > 0) {
+            out << "  " << std::left << std::setw(34) << site.name << std::right
+                << std::setw(24) << site.total.load(std::memory_order_relaxed) << "\n";
+        }
+    }
+    if (compiledIn()) {
+        out << "  " << std::left << std::setw(34) << "allocations" << std::right
+            << std::setw(24) << allocationCount() << "\n"
+            << "  " << std::left << std::setw(34) << "allocated MB" << std::right
+            << std::setw(24) << std::fixed << std::setprecision(1)
+            << allocatedBytes() / 1048576.0 << "\n";
+    }
+    out << "  " << std::left << std::setw(34) << "peak RSS MB" << std::right
+        << std::setw(24) << std::fixed << std::setprecision(1)
+        << peakRssBytes() / 1048576.0 << "\n";
+    out << std::left;
+}
+
+void Profiler::writeJson(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto writeSites = [&](Kind kind, const char* valueName) {
+        bool first = true;
+        for (const auto& site : sites_) {
+            if (site.kind != kind || site.calls.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            out << (first ? "\n" : ",\n") << "    {\"name\": \"" << site.name << "\""
+                << ", \"calls\": " << site.calls.load(std::memory_order_relaxed)
+                << ", \"" << valueName << "\": ";
+            if (kind == Kind::STAGE) {
+                out << std::fixed << std::setprecision(3)
+                    << site.total.load(std::memory_order_relaxed) / 1e6;
+            } else {
+                out << site.total.load(std::memory_order_relaxed);
+            }
+            out << "}";
+            first = false;
+        }
+        out << (first ? "]" : "\n  ]");
+    };
+
+    out << "{\n  \"compiled_in\": " << (compiledIn() ? "true" : "false") << ",\n"
+        << "  \"stages\": [";
+    writeSites(Kind::STAGE, "total_ms");
+    out << ",\n  \"counters\": [";
+    writeSites(Kind::COUNTER, "value");
+    out << ",\n  \"allocations\": " << allocationCount()
+        << ",\n  \"allocated_bytes\": " << allocatedBytes()
+        << ",\n  \"peak_rss_bytes\": " << peakRssBytes() << "\n}\n";
+}
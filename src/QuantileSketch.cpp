@@ -0,0 +1,252 @@
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+const double kCapacityDecay = 2.0 / 3.0;  // Capacity ratio between adjacent levels
+const size_t kMinCapacity = 2;
+const uint64_t kCoinSeed = 0x9E3779B97F4A7C15ULL;
+const uint32_t kMaxLevels = 64;
+
+// Empirical KLL error model: epsilon = kErrorScale / k^kErrorExponent
+const double kErrorScale = 2.296;
+const double kErrorExponent = 0.9723;
+
+template <typename T>
+void writePod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T readPod(std::istream& in) {
+    T value;
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("Truncated quantile sketch");
+    }
+    return value;
+}
+
+}  // namespace
+
+QuantileSketch::QuantileSketch(uint32_t k)
+    : k_(std::min(std::max(k, kMinK), kMaxK)), count_(0), min_(0.0), max_(0.0),
+      levels_(1), retained_(0), totalCapacity_(0), coinState_(kCoinSeed) {
+    updateCapacity();
+}
+
+uint32_t QuantileSketch::kForRankError(double epsilon) {
+    if (!(epsilon > 0.0)) {
+        return kMaxK;
+    }
+    double k = std::ceil(std::pow(kErrorScale / epsilon, 1.0 / kErrorExponent));
+    return static_cast<uint32_t>(std::min<double>(std::max<double>(k, kMinK), kMaxK));
+}
+
+double QuantileSketch::rankError() const {
+    return kErrorScale / std::pow(static_cast<double>(k_), kErrorExponent);
+}
+
+void QuantileSketch::add(double value) {
+    if (std::isnan(value)) {
+        return;
+    }
+    if (count_ == 0) {
+        min_ = max_ = value;
+    } else {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+    ++count_;
+    levels_[0].push_back(value);
+    if (++retained_ >= totalCapacity_) {
+        compress();
+    }
+}
+
+void QuantileSketch::add(const double* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        add(values[i]);
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (&other == this) {
+        QuantileSketch copy(other);
+        merge(copy);
+        return;
+    }
+    if (other.count_ == 0) {
+        return;
+    }
+    if (count_ == 0) {
+        min_ = other.min_;
+        max_ = other.max_;
+    } else {
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+    count_ += other.count_;
+    k_ = std::min(k_, other.k_);
+
+    if (other.levels_.size() > levels_.size()) {
+        levels_.resize(other.levels_.size());
+    }
+    for (size_t level = 0; level < other.levels_.size(); ++level) {
+        levels_[level].insert(levels_[level].end(),
+                              other.levels_[level].begin(), other.levels_[level].end());
+    }
+    retained_ += other.retained_;
+    updateCapacity();
+    while (retained_ >= totalCapacity_) {
+        compress();
+    }
+}
+
+double QuantileSketch::quantile(double q) const {
+    return quantiles({q})[0];
+}
+
+std::vector<double> QuantileSketch::quantiles(const std::vector<double>& qs) const {
+    std::vector<double> result(qs.size(), 0.0);
+    if (count_ == 0) {
+        return result;
+    }
+
+    // Stored values with their weights, sorted; ends[i] is the exclusive
+    // cumulative rank after item i
+    std::vector<std::pair<double, uint64_t>> items;
+    items.reserve(retained_);
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        for (double value : levels_[level]) {
+            items.emplace_back(value, uint64_t(1) << level);
+        }
+    }
+    std::sort(items.begin(), items.end());
+    std::vector<uint64_t> ends(items.size());
+    uint64_t total = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+        total += items[i].second;
+        ends[i] = total;
+    }
+    auto valueAtRank = [&](uint64_t rank) {
+        size_t i = std::upper_bound(ends.begin(), ends.end(), rank) - ends.begin();
+        return items[std::min(i, items.size() - 1)].first;
+    };
+
+    for (size_t i = 0; i < qs.size(); ++i) {
+        if (qs[i] <= 0.0) {
+            result[i] = min_;
+        } else if (qs[i] >= 1.0) {
+            result[i] = max_;
+        } else {
+            double position = qs[i] * static_cast<double>(count_ - 1);
+            uint64_t lower = static_cast<uint64_t>(position);
+            double fraction = position - static_cast<double>(lower);
+            double low = valueAtRank(lower);
+            result[i] = fraction > 0.0 ? low + fraction * (valueAtRank(lower + 1) - low) : low;
+        }
+    }
+    return result;
+}
+
+void QuantileSketch::serialize(std::ostream& out) const {
+    writePod(out, k_);
+    writePod(out, count_);
+    writePod(out, min_);
+    writePod(out, max_);
+    writePod(out, coinState_);
+    writePod(out, static_cast<uint32_t>(levels_.size()));
+    for (const auto& level : levels_) {
+        writePod(out, static_cast<uint32_t>(level.size()));
+        out.write(reinterpret_cast<const char*>(level.data()),
+                  static_cast<std::streamsize>(level.size() * sizeof(double)));
+    }
+}
+
+QuantileSketch QuantileSketch::deserialize(std::istream& in) {
+    uint32_t k = readPod<uint32_t>(in);
+    if (k < kMinK || k > kMaxK) {
+        throw std::runtime_error("Invalid quantile sketch parameter");
+    }
+    QuantileSketch sketch(k);
+    sketch.count_ = readPod<uint64_t>(in);
+    sketch.min_ = readPod<double>(in);
+    sketch.max_ = readPod<double>(in);
+    sketch.coinState_ = readPod<uint64_t>(in);
+    uint32_t levelCount = readPod<uint32_t>(in);
+    if (levelCount == 0 || levelCount > kMaxLevels) {
+        throw std::runtime_error("Invalid quantile sketch levels");
+    }
+
+    // Every compaction preserves total weight, so the levels must add up to the count
+    sketch.levels_.assign(levelCount, {});
+    uint64_t weight = 0;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        uint32_t size = readPod<uint32_t>(in);
+        if (size > 4 * static_cast<size_t>(k) + kMinCapacity * kMaxLevels) {
+            throw std::runtime_error("Invalid quantile sketch level size");
+        }
+        auto& items = sketch.levels_[level];
+        items.resize(size);
+        if (!in.read(reinterpret_cast<char*>(items.data()),
+                     static_cast<std::streamsize>(size * sizeof(double)))) {
+            throw std::runtime_error("Truncated quantile sketch");
+        }
+        sketch.retained_ += size;
+        weight += static_cast<uint64_t>(size) << level;
+    }
+    sketch.updateCapacity();
+    if (weight != sketch.count_ || sketch.retained_ >= sketch.totalCapacity_) {
+        throw std::runtime_error("Inconsistent quantile sketch");
+    }
+    return sketch;
+}
+
+size_t QuantileSketch::capacity(size_t level) const {
+    size_t depth = levels_.size() - 1 - level;
+    double scaled = static_cast<double>(k_) * std::pow(kCapacityDecay, static_cast<double>(depth));
+    return std::max(kMinCapacity, static_cast<size_t>(scaled));
+}
+
+void QuantileSketch::updateCapacity() {
+    totalCapacity_ = 0;
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        totalCapacity_ += capacity(level);
+    }
+}
+
+void QuantileSketch::compress() {
+    // Compact the lowest full level; some level is full whenever the total is
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        if (levels_[level].size() >= capacity(level)) {
+            compact(level);
+            return;
+        }
+    }
+}
+
+void QuantileSketch::compact(size_t level) {
+    if (level + 1 == levels_.size()) {
+        levels_.emplace_back();
+        updateCapacity();
+    }
+    std::vector<double>& items = levels_[level];
+    std::vector<double>& above = levels_[level + 1];
+    std::sort(items.begin(), items.end());
+
+    // An odd item out (the largest) stays behind at this level
+    size_t paired = items.size() & ~size_t(1);
+    for (size_t i = nextCoin() ? 1 : 0; i < paired; i += 2) {
+        above.push_back(items[i]);
+    }
+    items.erase(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(paired));
+    retained_ -= paired / 2;
+}
+
+bool QuantileSketch::nextCoin() {
+    coinState_ = coinState_ * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (coinState_ >> 63) != 0;
+}
@@ -0,0 +1,104 @@
+#include "ReadingBatch.h"
+
+ReadingBatch::ReadingBatch() {
+}
+
+ReadingBatch ReadingBatch::fromReadings(const std::vector<SensorReading>& readings) {
+    ReadingBatch batch;
+    batch.reserve(readings.size());
+    for (const auto& reading : readings) {
+        batch.append(reading);
+    }
+    return batch;
+}
+
+std::vector<SensorReading> ReadingBatch::toReadings() const {
+    std::vector<SensorReading> readings;
+    readings.reserve(size());
+    for (size_t row = 0; row < size(); ++row) {
+        readings.push_back(at(row));
+    }
+    return readings;
+}
+
+void ReadingBatch::append(const std::string& sensorId, SensorReading::SensorType type,
+                          double value, int64_t timestamp) {
+    pushRow(value, timestamp, type, SensorIdTable::global().intern(sensorId));
+}
+
+void ReadingBatch::append(const SensorReading& reading) {
+    pushRow(reading.getValue(), reading.getTimestamp(),
+            reading.getType(), reading.getSensorKey());
+}
+
+void ReadingBatch::append(const ReadingBatch& other) {
+    values_.insert(values_.end(), other.values_.begin(), other.values_.end());
+    timestamps_.insert(timestamps_.end(), other.timestamps_.begin(), other.timestamps_.end());
+    types_.insert(types_.end(), other.types_.begin(), other.types_.end());
+    sensorKeys_.insert(sensorKeys_.end(), other.sensorKeys_.begin(), other.sensorKeys_.end());
+}
+
+void ReadingBatch::appendRow(const ReadingBatch& other, size_t row) {
+    pushRow(other.values_[row], other.timestamps_[row],
+            other.types_[row], other.sensorKeys_[row]);
+}
+
+ReadingBatch ReadingBatch::slice(size_t begin, size_t end) const {
+    ReadingBatch result;
+    result.values_.assign(values_.begin() + begin, values_.begin() + end);
+    result.timestamps_.assign(timestamps_.begin() + begin, timestamps_.begin() + end);
+    result.types_.assign(types_.begin() + begin, types_.begin() + end);
+    result.sensorKeys_.assign(sensorKeys_.begin() + begin, sensorKeys_.begin() + end);
+    return result;
+}
+
+ReadingBatch ReadingBatch::gather(const std::vector<size_t>& rows) const {
+    ReadingBatch result;
+    result.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        size_t row = rows[i];
+        result.values_[i] = values_[row];
+        result.timestamps_[i] = timestamps_[row];
+        result.types_[i] = types_[row];
+        result.sensorKeys_[i] = sensorKeys_[row];
+    }
+    return result;
+}
+
+void ReadingBatch::compact(const ValueKernels::RowMask& mask, size_t selected) {
+    // Kept rows only move towards the front, so one forward pass suffices
+    size_t i = 0;
+    ValueKernels::forEachSetBit(mask, [&](size_t row) {
+        values_[i] = values_[row];
+        timestamps_[i] = timestamps_[row];
+        types_[i] = types_[row];
+        sensorKeys_[i] = sensorKeys_[row];
+        ++i;
+    });
+    resize(selected);
+}
+
+SensorReading ReadingBatch::at(size_t row) const {
+    return SensorReading(sensorKeys_[row], types_[row], values_[row], timestamps_[row]);
+}
+
+void ReadingBatch::reserve(size_t count) {
+    values_.reserve(count);
+    timestamps_.reserve(count);
+    types_.reserve(count);
+    sensorKeys_.reserve(count);
+}
+
+void ReadingBatch::resize(size_t count) {
+    values_.resize(count);
+    timestamps_.resize(count);
+    types_.resize(count);
+    sensorKeys_.resize(count);
+}
+
+void ReadingBatch::clear() {
+    values_.clear();
+    timestamps_.clear();
+    types_.clear();
+    sensorKeys_.clear();
+}
@@ -0,0 +1,68 @@
+#include "ReadingIndex.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+ReadingIndex::ReadingIndex(const ReadingBatch& batch)
+    : rowCount_(batch.size()) {
+    const auto& keys = batch.sensorKeys();
+    const auto& types = batch.types();
+    build([&keys](size_t row) { return keys[row]; },
+          [&types](size_t row) { return types[row]; });
+}
+
+ReadingIndex::ReadingIndex(const std::vector<SensorReading>& readings)
+    : rowCount_(readings.size()) {
+    build([&readings](size_t row) { return readings[row].getSensorKey(); },
+          [&readings](size_t row) { return readings[row].getType(); });
+}
+
+template <typename KeyFn, typename TypeFn>
+void ReadingIndex::build(KeyFn sensorKey, TypeFn type) {
+    if (rowCount_ > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Too many rows to index");
+    }
+
+    std::vector<uint32_t> keys(rowCount_);
+    uint32_t maxKey = 0;
+    for (size_t row = 0; row < rowCount_; ++row) {
+        keys[row] = sensorKey(row);
+        maxKey = std::max(maxKey, keys[row]);
+    }
+    countingSort(keys, rowCount_ == 0 ? 0 : size_t(maxKey) + 1, sensorOffsets_, sensorRows_);
+
+    for (size_t row = 0; row < rowCount_; ++row) {
+        keys[row] = static_cast<uint32_t>(type(row));
+    }
+    countingSort(keys, SensorReading::kTypeCount, typeOffsets_, typeRows_);
+}
+
+void ReadingIndex::countingSort(const std::vector<uint32_t>& keys, size_t keyCount,
+                                std::vector<uint32_t>& offsets, std::vector<uint32_t>& rows) {
+    offsets.assign(keyCount + 1, 0);
+    for (uint32_t key : keys) {
+        ++offsets[key + 1];
+    }
+    for (size_t key = 0; key < keyCount; ++key) {
+        offsets[key + 1] += offsets[key];
+    }
+    rows.resize(keys.size());
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t row = 0; row < keys.size(); ++row) {
+        rows[cursor[keys[row]]++] = static_cast<uint32_t>(row);
+    }
+}
+
+PostingList ReadingIndex::rowsOfSensor(SensorReading::SensorKey key) const {
+    if (key >= sensorKeyLimit()) {
+        return PostingList{nullptr, nullptr};
+    }
+    const uint32_t* rows = sensorRows_.data();
+    return PostingList{rows + sensorOffsets_[key], rows + sensorOffsets_[key + 1]};
+}
+
+PostingList ReadingIndex::rowsOfType(SensorReading::SensorType type) const {
+    size_t code = static_cast<size_t>(type);
+    const uint32_t* rows = typeRows_.data();
+    return PostingList{rows + typeOffsets_[code], rows + typeOffsets_[code + 1]};
+}
@@ -1,32 +1,204 @@
 #include "SensorDataProcessor.h"
+#include "ValueKernels.h"
+#include "ThreadPool.h"
+#include "ReadingIndex.h"
+#include "Profiler.h"
 #include <algorithm>
 #include <numeric>
 #include <cmath>
 #include <iterator>
+#include <unordered_map>
+#include <utility>
+#include <stdexcept>
 
-SensorDataProcessor::SensorDataProcessor() {
+namespace {
+
+
+// Same quartile definition as calculateQuartiles, read off an already sorted range
+void quartilesFromSorted(const double* sorted, size_t n, double& q1, double& q3) {
+    size_t q1Index = n / 4;
+    q1 = sorted[q1Index];
+    if (!(n % 4 == 0 || n % 4 == 1)) {
+        q1 = (q1 + sorted[q1Index + 1]) / 2.0;
+    }
+    size_t q3Index = (3 * n) / 4;
+    q3 = sorted[q3Index];
+    if (!(n % 4 == 0 || n % 4 == 3)) {
+        q3 = (q3 + sorted[q3Index + 1]) / 2.0;
+    }
+}
+
+}  // namespace
+
+SensorDataProcessor::SensorDataProcessor() : scratch_(nullptr) {
+}
+
+void SensorDataProcessor::setThreadCount(size_t threadCount) {
+    if (threadCount == 1) {
+        pool_.reset();
+        return;
+    }
+    pool_ = std::make_shared<ThreadPool>(threadCount);
+    if (pool_->size() == 1) {
+        pool_.reset();  // Single-core host: nothing to hand out
+    }
+}
+
+size_t SensorDataProcessor::getThreadCount() const {
+    return pool_ ? pool_->size() : 1;
+}
+
+void SensorDataProcessor::parallelFor(size_t count, size_t grain,
+                                      const std::function<void(size_t, size_t)>& body) const {
+    if (pool_) {
+        pool_->parallelFor(count, grain, body);
+        return;
+    }
+    // Same chunking as the pool so results are identical
+    for (size_t begin = 0; begin < count; begin += grain) {
+        body(begin, std::min(count, begin + grain));
+    }
+}
+
+template <typename Predicate>
+size_t SensorDataProcessor::buildRowMask(size_t rowCount, Predicate pred,
+                                         ValueKernels::RowMask& mask) const {
+    mask.assign(ValueKernels::maskWords(rowCount), 0);
+    std::vector<size_t> counts((rowCount + kRowGrain - 1) / kRowGrain, 0);
+    parallelFor(rowCount, kRowGrain, [&](size_t begin, size_t end) {
+        size_t selected = 0;
+        for (size_t row = begin; row < end; ++row) {
+            bool hit = pred(row);
+            mask[row / 64] |= static_cast<uint64_t>(hit) << (row % 64);
+            selected += hit;
+        }
+        counts[begin / kRowGrain] = selected;
+    });
+    return std::accumulate(counts.begin(), counts.end(), size_t(0));
+}
+
+size_t SensorDataProcessor::buildRangeMask(const double* column, size_t rowCount,
+                                           double lower, double upper,
+                                           ValueKernels::RowMask& mask) const {
+    mask.assign(ValueKernels::maskWords(rowCount), 0);
+    std::vector<size_t> counts((rowCount + kRowGrain - 1) / kRowGrain, 0);
+    parallelFor(rowCount, kRowGrain, [&](size_t begin, size_t end) {
+        counts[begin / kRowGrain] = ValueKernels::rangeMask(
+            column + begin, end - begin, lower, upper, mask.data() + begin / 64);
+    });
+    return std::accumulate(counts.begin(), counts.end(), size_t(0));
+}
+
+ReadingBatch SensorDataProcessor::gatherRows(const ReadingBatch& batch,
+                                             const ValueKernels::RowMask& mask,
+                                             size_t selected) const {
+    ReadingBatch result;
+    result.resize(selected);
+    
+    // Output offset of each chunk from the per-chunk popcounts
+    size_t chunkCount = (batch.size() + kRowGrain - 1) / kRowGrain;
+    std::vector<size_t> offsets(chunkCount + 1, 0);
+    parallelFor(batch.size(), kRowGrain, [&](size_t begin, size_t end) {
+        size_t count = 0;
+        for (size_t w = begin / 64; w < ValueKernels::maskWords(end); ++w) {
+            count += ValueKernels::popcount(mask[w]);
+        }
+        offsets[begin / kRowGrain + 1] = count;
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    
+    parallelFor(batch.size(), kRowGrain, [&](size_t begin, size_t end) {
+        size_t out = offsets[begin / kRowGrain];
+        for (size_t w = begin / 64; w < ValueKernels::maskWords(end); ++w) {
+            for (uint64_t word = mask[w]; word; word &= word - 1) {
+                size_t row = w * 64 + ValueKernels::lowestBit(word);
+                result.values()[out] = batch.values()[row];
+                result.timestamps()[out] = batch.timestamps()[row];
+                result.types()[out] = batch.types()[row];
+                result.sensorKeys()[out] = batch.sensorKeys()[row];
+                ++out;
+            }
+        }
+    });
+    return result;
+}
+
+void SensorDataProcessor::requireIndexOver(const ReadingIndex& index, size_t rowCount) {
+    if (index.rowCount() != rowCount) {
+        throw std::invalid_argument("Reading index was built over " +
+                                    std::to_string(index.rowCount()) + " rows, dataset has " +
+                                    std::to_string(rowCount));
+    }
+}
+
+ReadingBatch SensorDataProcessor::gatherPostings(const ReadingBatch& batch,
+                                                 const PostingList& rows) const {
+    ReadingBatch result;
+    result.resize(rows.size());
+    parallelFor(rows.size(), kRowGrain, [&](size_t begin, size_t end) {
+        for (size_t out = begin; out < end; ++out) {
+            size_t row = rows.first[out];
+            result.values()[out] = batch.values()[row];
+            result.timestamps()[out] = batch.timestamps()[row];
+            result.types()[out] = batch.types()[row];
+            result.sensorKeys()[out] = batch.sensorKeys()[row];
+        }
+    });
+    return result;
 }
 
 std::vector<SensorReading> SensorDataProcessor::process(
     const std::vector<SensorReading>& readings) {
+    PROFILE_SCOPE("process");
     
-    // Basic processing pipeline: validate, filter invalid, remove outliers
-    std::vector<SensorReading> validReadings;
-    std::copy_if(readings.begin(), readings.end(),
-                 std::back_inserter(validReadings),
-                 [](const SensorReading& r) { return r.isValid(); });
+    // Basic processing pipeline: validate, filter invalid, remove outliers,
+    // fused into one survivor bitmap and a single exact-size copy
+    ValueKernels::RowMask mask;
+    size_t kept = outlierMask(
+        readings.size(),
+        [&readings](size_t row) { return readings[row].getValue(); },
+        [&readings](size_t row) { return readings[row].getType(); },
+        [&readings](size_t row) { return readings[row].getSensorKey(); },
+        [&readings](size_t row) { return readings[row].isValid(); },
+        nullptr, mask);
     
-    if (validReadings.empty()) {
-        return validReadings;
-    }
+    std::vector<SensorReading> processed;
+    processed.reserve(kept);
+    ValueKernels::forEachSetBit(mask, [&](size_t row) {
+        processed.push_back(readings[row]);
+    });
+    return processed;
+}
+
+std::vector<SensorReading> SensorDataProcessor::process(
+    std::vector<SensorReading>&& readings) {
+    PROFILE_SCOPE("process");
+    
+    ValueKernels::RowMask mask;
+    size_t kept = outlierMask(
+        readings.size(),
+        [&readings](size_t row) { return readings[row].getValue(); },
+        [&readings](size_t row) { return readings[row].getType(); },
+        [&readings](size_t row) { return readings[row].getSensorKey(); },
+        [&readings](size_t row) { return readings[row].isValid(); },
+        nullptr, mask);
     
-    // Remove outliers
-    return removeOutliers(validReadings);
+    // Survivors only ever move towards the front, so compact in place
+    size_t write = 0;
+    ValueKernels::forEachSetBit(mask, [&](size_t row) {
+        if (write != row) {
+            readings[write] = std::move(readings[row]);
+        }
+        ++write;
+    });
+    readings.resize(kept);
+    return std::move(readings);
 }
 
 std::vector<SensorReading> SensorDataProcessor::filterByType(
     const std::vector<SensorReading>& readings,
     SensorReading::SensorType type) const {
+    PROFILE_SCOPE("filter");
     
     std::vector<SensorReading> filtered;
     std::copy_if(readings.begin(), readings.end(),
@@ -35,22 +207,62 @@ std::vector<SensorReading> SensorDataProcessor::filterByType(
     return filtered;
 }
 
+std::vector<SensorReading> SensorDataProcessor::filterByType(
+    const std::vector<SensorReading>& readings,
+    SensorReading::SensorType type, const ReadingIndex& index) const {
+    PROFILE_SCOPE("filter");
+    
+    requireIndexOver(index, readings.size());
+    PostingList rows = index.rowsOfType(type);
+    std::vector<SensorReading> filtered;
+    filtered.reserve(rows.size());
+    for (uint32_t row : rows) {
+        filtered.push_back(readings[row]);
+    }
+    return filtered;
+}
+
 std::vector<SensorReading> SensorDataProcessor::filterBySensorId(
     const std::vector<SensorReading>& readings,
     const std::string& sensorId) const {
+    PROFILE_SCOPE("filter");
     
     std::vector<SensorReading> filtered;
+    SensorReading::SensorKey key;
+    if (!SensorIdTable::global().find(sensorId, key)) {
+        return filtered;  // Never interned, so no reading can carry it
+    }
+    
     std::copy_if(readings.begin(), readings.end(),
                  std::back_inserter(filtered),
-                 [&sensorId](const SensorReading& r) {
-                     return r.getSensorId() == sensorId;
-                 });
+                 [key](const SensorReading& r) { return r.getSensorKey() == key; });
+    return filtered;
+}
+
+std::vector<SensorReading> SensorDataProcessor::filterBySensorId(
+    const std::vector<SensorReading>& readings,
+    const std::string& sensorId, const ReadingIndex& index) const {
+    PROFILE_SCOPE("filter");
+    
+    requireIndexOver(index, readings.size());
+    std::vector<SensorReading> filtered;
+    SensorReading::SensorKey key;
+    if (!SensorIdTable::global().find(sensorId, key)) {
+        return filtered;
+    }
+    
+    PostingList rows = index.rowsOfSensor(key);
+    filtered.reserve(rows.size());
+    for (uint32_t row : rows) {
+        filtered.push_back(readings[row]);
+    }
     return filtered;
 }
 
 std::vector<SensorReading> SensorDataProcessor::filterByValueRange(
     const std::vector<SensorReading>& readings,
     double minValue, double maxValue) const {
+    PROFILE_SCOPE("filter");
     
     std::vector<SensorReading> filtered;
     std::copy_if(readings.begin(), readings.end(),
@@ -64,170 +276,1002 @@ std::vector<SensorReading> SensorDataProcessor::filterByValueRange(
 
 SensorStatistics SensorDataProcessor::calculateStatistics(
     const std::vector<SensorReading>& readings) const {
+    PROFILE_SCOPE("stats.overall");
     
-    SensorStatistics stats;
-    stats.count = readings.size();
+    std::pmr::vector<double> values(scratch());
+    values.reserve(readings.size());
+    for (const auto& reading : readings) {
+        values.push_back(reading.getValue());
+    }
+    
+    return calculateRangeStatistics(values.data(), values.data() + values.size());
+}
+
+std::map<SensorReading::SensorType, SensorStatistics> 
+SensorDataProcessor::calculateStatisticsByType(
+    const std::vector<SensorReading>& readings) const {
+    
+    std::map<SensorReading::SensorType, SensorStatistics> statsMap;
+    for (auto& group : calculateGroupedStatistics(readings, GroupBy::TYPE)) {
+        statsMap[group.key.type] = group.stats;
+    }
+    
+    return statsMap;
+}
+
+std::map<std::string, SensorStatistics> 
+SensorDataProcessor::calculateStatisticsBySensorId(
+    const std::vector<SensorReading>& readings) const {
+    
+    // Sensor IDs are resolved only here, once per group
+    std::map<std::string, SensorStatistics> statsMap;
+    const SensorIdTable& table = SensorIdTable::global();
+    for (auto& group : calculateGroupedStatistics(readings, GroupBy::SENSOR)) {
+        statsMap[table.resolve(group.key.sensorKey)] = group.stats;
+    }
+    
+    return statsMap;
+}
+
+std::vector<SensorReading> SensorDataProcessor::removeOutliers(
+    const std::vector<SensorReading>& readings) const {
+    PROFILE_SCOPE("removeOutliers");
+    
+    ValueKernels::RowMask mask;
+    size_t kept = outlierMask(
+        readings.size(),
+        [&readings](size_t row) { return readings[row].getValue(); },
+        [&readings](size_t row) { return readings[row].getType(); },
+        [&readings](size_t row) { return readings[row].getSensorKey(); },
+        [](size_t) { return true; },
+        nullptr, mask);
+    
+    std::vector<SensorReading> filtered;
+    filtered.reserve(kept);
+    ValueKernels::forEachSetBit(mask, [&](size_t row) {
+        filtered.push_back(readings[row]);
+    });
+    return filtered;
+}
+
+void SensorDataProcessor::normalizeValues(
+    std::vector<SensorReading>& readings) const {
+    PROFILE_SCOPE("normalize");
     
     if (readings.empty()) {
-        return stats;
+        return;
     }
     
+    // Gather the values into a column so the scans run on the vector kernels
     std::vector<double> values;
     values.reserve(readings.size());
     for (const auto& reading : readings) {
         values.push_back(reading.getValue());
     }
     
-    std::sort(values.begin(), values.end());
-    
-    stats.min = values.front();
-    stats.max = values.back();
+    if (!normalizeColumn(values.data(), values.size())) {
+        return;  // All values are the same
+    }
     
-    // Calculate mean
-    double sum = std::accumulate(values.begin(), values.end(), 0.0);
-    stats.mean = sum / values.size();
+    for (size_t i = 0; i < readings.size(); ++i) {
+        readings[i].setValue(values[i]);
+    }
+}
+
+ReadingBatch SensorDataProcessor::process(const ReadingBatch& batch) {
+    PROFILE_SCOPE("process");
+    // Same pipeline as the vector overload, on columns
+    const auto& values = batch.values();
+    const auto& types = batch.types();
+    const auto& keys = batch.sensorKeys();
+    ValueKernels::RowMask mask;
+    size_t kept = outlierMask(
+        batch.size(),
+        [&values](size_t row) { return values[row]; },
+        [&types](size_t row) { return types[row]; },
+        [&keys](size_t row) { return keys[row]; },
+        [&batch](size_t row) { return batch.isValid(row); },
+        values.data(), mask);
+    return gatherRows(batch, mask, kept);
+}
+
+ReadingBatch SensorDataProcessor::process(ReadingBatch&& batch) {
+    PROFILE_SCOPE("process");
+    const auto& values = batch.values();
+    const auto& types = batch.types();
+    const auto& keys = batch.sensorKeys();
+    ValueKernels::RowMask mask;
+    size_t kept = outlierMask(
+        batch.size(),
+        [&values](size_t row) { return values[row]; },
+        [&types](size_t row) { return types[row]; },
+        [&keys](size_t row) { return keys[row]; },
+        [&batch](size_t row) { return batch.isValid(row); },
+        values.data(), mask);
+    batch.compact(mask, kept);
+    return std::move(batch);
+}
+
+ReadingBatch SensorDataProcessor::filterByType(
+    const ReadingBatch& batch,
+    SensorReading::SensorType type) const {
+    PROFILE_SCOPE("filter");
     
-    // Calculate median
-    stats.median = calculateMedian(values);
+    const auto& types = batch.types();
+    ValueKernels::RowMask mask;
+    size_t selected = buildRowMask(batch.size(),
+        [&types, type](size_t row) { return types[row] == type; }, mask);
+    return gatherRows(batch, mask, selected);
+}
+
+ReadingBatch SensorDataProcessor::filterByType(
+    const ReadingBatch& batch,
+    SensorReading::SensorType type, const ReadingIndex& index) const {
+    PROFILE_SCOPE("filter");
     
-    return stats;
+    requireIndexOver(index, batch.size());
+    return gatherPostings(batch, index.rowsOfType(type));
 }
 
-std::map<SensorReading::SensorType, SensorStatistics> 
-SensorDataProcessor::calculateStatisticsByType(
-    const std::vector<SensorReading>& readings) const {
+ReadingBatch SensorDataProcessor::filterBySensorId(
+    const ReadingBatch& batch,
+    const std::string& sensorId) const {
+    PROFILE_SCOPE("filter");
     
-    std::map<SensorReading::SensorType, SensorStatistics> statsMap;
+    ReadingBatch::SensorKey key;
+    if (!SensorIdTable::global().find(sensorId, key)) {
+        return ReadingBatch();
+    }
     
-    // Group by type
-    std::map<SensorReading::SensorType, std::vector<SensorReading>> grouped;
-    for (const auto& reading : readings) {
-        grouped[reading.getType()].push_back(reading);
+    const auto& keys = batch.sensorKeys();
+    ValueKernels::RowMask mask;
+    size_t selected = buildRowMask(batch.size(),
+        [&keys, key](size_t row) { return keys[row] == key; }, mask);
+    return gatherRows(batch, mask, selected);
+}
+
+ReadingBatch SensorDataProcessor::filterBySensorId(
+    const ReadingBatch& batch,
+    const std::string& sensorId, const ReadingIndex& index) const {
+    PROFILE_SCOPE("filter");
+    
+    requireIndexOver(index, batch.size());
+    ReadingBatch::SensorKey key;
+    if (!SensorIdTable::global().find(sensorId, key)) {
+        return ReadingBatch();
     }
+    return gatherPostings(batch, index.rowsOfSensor(key));
+}
+
+ReadingBatch SensorDataProcessor::filterByValueRange(
+    const ReadingBatch& batch,
+    double minValue, double maxValue) const {
+    PROFILE_SCOPE("filter");
     
-    // Calculate stats for each group
-    for (const auto& pair : grouped) {
-        statsMap[pair.first] = calculateStatistics(pair.second);
+    ValueKernels::RowMask mask;
+    size_t selected = buildRangeMask(batch.values().data(), batch.size(),
+                                     minValue, maxValue, mask);
+    return gatherRows(batch, mask, selected);
+}
+
+SensorStatistics SensorDataProcessor::calculateStatistics(
+    const ReadingBatch& batch) const {
+    PROFILE_SCOPE("stats.overall");
+    
+    std::pmr::vector<double> values(batch.values().begin(), batch.values().end(), scratch());
+    return calculateRangeStatistics(values.data(), values.data() + values.size());
+}
+
+std::map<SensorReading::SensorType, SensorStatistics> 
+SensorDataProcessor::calculateStatisticsByType(const ReadingBatch& batch) const {
+    
+    std::map<SensorReading::SensorType, SensorStatistics> statsMap;
+    for (auto& group : calculateGroupedStatistics(batch, GroupBy::TYPE)) {
+        statsMap[group.key.type] = group.stats;
     }
     
     return statsMap;
 }
 
 std::map<std::string, SensorStatistics> 
-SensorDataProcessor::calculateStatisticsBySensorId(
-    const std::vector<SensorReading>& readings) const {
+SensorDataProcessor::calculateStatisticsBySensorId(const ReadingBatch& batch) const {
     
+    // Sensor IDs are resolved only here, once per group
     std::map<std::string, SensorStatistics> statsMap;
+    const SensorIdTable& table = SensorIdTable::global();
+    for (auto& group : calculateGroupedStatistics(batch, GroupBy::SENSOR)) {
+        statsMap[table.resolve(group.key.sensorKey)] = group.stats;
+    }
     
-    // Group by sensor ID
-    std::map<std::string, std::vector<SensorReading>> grouped;
-    for (const auto& reading : readings) {
-        grouped[reading.getSensorId()].push_back(reading);
+    return statsMap;
+}
+
+std::vector<GroupStatistics> SensorDataProcessor::calculateGroupedStatistics(
+    const ReadingBatch& batch, GroupBy groupBy, int64_t bucketMs) const {
+    PROFILE_SCOPE("stats.grouped");
+    
+    const auto& values = batch.values();
+    const auto& types = batch.types();
+    const auto& keys = batch.sensorKeys();
+    const auto& timestamps = batch.timestamps();
+    return groupedStatistics(
+        batch.size(),
+        [&values](size_t row) { return values[row]; },
+        [&types](size_t row) { return types[row]; },
+        [&keys](size_t row) { return keys[row]; },
+        [&timestamps](size_t row) { return timestamps[row]; },
+        groupBy, bucketMs);
+}
+
+std::vector<GroupStatistics> SensorDataProcessor::calculateGroupedStatistics(
+    const std::vector<SensorReading>& readings, GroupBy groupBy, int64_t bucketMs) const {
+    PROFILE_SCOPE("stats.grouped");
+    
+    return groupedStatistics(
+        readings.size(),
+        [&readings](size_t row) { return readings[row].getValue(); },
+        [&readings](size_t row) { return readings[row].getType(); },
+        [&readings](size_t row) { return readings[row].getSensorKey(); },
+        [&readings](size_t row) { return readings[row].getTimestamp(); },
+        groupBy, bucketMs);
+}
+
+std::vector<GroupStatistics> SensorDataProcessor::calculateGroupedStatistics(
+    const ReadingBatch& batch, GroupBy groupBy, const ReadingIndex& index) const {
+    PROFILE_SCOPE("stats.grouped");
+    
+    requireIndexOver(index, batch.size());
+    const auto& values = batch.values();
+    const auto& types = batch.types();
+    return indexedGroupedStatistics(index,
+        [&values](size_t row) { return values[row]; },
+        [&types](size_t row) { return types[row]; },
+        groupBy);
+}
+
+std::vector<GroupStatistics> SensorDataProcessor::calculateGroupedStatistics(
+    const std::vector<SensorReading>& readings, GroupBy groupBy,
+    const ReadingIndex& index) const {
+    PROFILE_SCOPE("stats.grouped");
+    
+    requireIndexOver(index, readings.size());
+    return indexedGroupedStatistics(index,
+        [&readings](size_t row) { return readings[row].getValue(); },
+        [&readings](size_t row) { return readings[row].getType(); },
+        groupBy);
+}
+
+template <typename ValueFn, typename TypeFn, typename KeyFn, typename TimeFn>
+std::vector<GroupStatistics> SensorDataProcessor::groupedStatistics(
+    size_t rowCount, ValueFn value, TypeFn type, KeyFn sensorKey, TimeFn timestamp,
+    GroupBy groupBy, int64_t bucketMs) const {
+    
+    const size_t typeCount = SensorReading::kTypeCount;
+    bucketMs = std::max<int64_t>(1, bucketMs);
+    auto bucketOf = [bucketMs](int64_t ts) {
+        // Floor division so negative timestamps land in the right bucket
+        int64_t bucket = ts / bucketMs;
+        return (ts % bucketMs < 0) ? bucket - 1 : bucket;
+    };
+    
+    // Pass 1: dense group id per row, and group sizes
+    std::pmr::vector<uint32_t> groupIds(rowCount, scratch());
+    std::vector<int64_t> bucketByGroup;  // TIME_BUCKET only
+    size_t groupCount = 0;
+    switch (groupBy) {
+        case GroupBy::TYPE:
+            groupCount = typeCount;
+            parallelFor(rowCount, kRowGrain, [&](size_t begin, size_t end) {
+                for (size_t row = begin; row < end; ++row) {
+                    groupIds[row] = static_cast<uint32_t>(type(row));
+                }
+            });
+            break;
+        case GroupBy::SENSOR:
+            groupCount = SensorIdTable::global().size();
+            parallelFor(rowCount, kRowGrain, [&](size_t begin, size_t end) {
+                for (size_t row = begin; row < end; ++row) {
+                    groupIds[row] = sensorKey(row);
+                }
+            });
+            break;
+        case GroupBy::TYPE_AND_SENSOR:
+            groupCount = SensorIdTable::global().size() * typeCount;
+            parallelFor(rowCount, kRowGrain, [&](size_t begin, size_t end) {
+                for (size_t row = begin; row < end; ++row) {
+                    groupIds[row] = static_cast<uint32_t>(
+                        sensorKey(row) * typeCount + static_cast<size_t>(type(row)));
+                }
+            });
+            break;
+        case GroupBy::TIME_BUCKET: {
+            // Buckets get dense ids in first-seen order; sorted when emitted
+            std::unordered_map<int64_t, uint32_t> bucketIds;
+            for (size_t row = 0; row < rowCount; ++row) {
+                int64_t bucket = bucketOf(timestamp(row));
+                auto inserted = bucketIds.emplace(bucket, static_cast<uint32_t>(bucketByGroup.size()));
+                if (inserted.second) {
+                    bucketByGroup.push_back(bucket);
+                }
+                groupIds[row] = inserted.first->second;
+            }
+            groupCount = bucketByGroup.size();
+            break;
+        }
     }
     
-    // Calculate stats for each group
-    for (const auto& pair : grouped) {
-        statsMap[pair.first] = calculateStatistics(pair.second);
+    // Pass 2: counting-sort the values so each group is one contiguous slice
+    std::pmr::vector<size_t> offsets(groupCount + 1, 0, scratch());
+    for (size_t row = 0; row < rowCount; ++row) {
+        ++offsets[groupIds[row] + 1];
+    }
+    for (size_t group = 0; group < groupCount; ++group) {
+        offsets[group + 1] += offsets[group];
     }
+    std::pmr::vector<double> partitioned(rowCount, scratch());
+    {
+        std::pmr::vector<size_t> cursor(offsets.begin(), offsets.end() - 1, scratch());
+        for (size_t row = 0; row < rowCount; ++row) {
+            partitioned[cursor[groupIds[row]]++] = value(row);
+        }
+    }
+    groupIds.clear();
+    groupIds.shrink_to_fit();
     
-    return statsMap;
+    // Statistics per non-empty group, in place over its slice; groups are
+    // independent, so each is one pool task and lands in its own result slot
+    std::pmr::vector<size_t> nonEmpty(scratch());
+    for (size_t group = 0; group < groupCount; ++group) {
+        if (offsets[group] != offsets[group + 1]) {
+            nonEmpty.push_back(group);
+        }
+    }
+    std::vector<GroupStatistics> results(nonEmpty.size());
+    parallelFor(nonEmpty.size(), 1, [&](size_t slot, size_t) {
+        size_t group = nonEmpty[slot];
+        GroupStatistics& result = results[slot];
+        switch (groupBy) {
+            case GroupBy::TYPE:
+                result.key.type = static_cast<SensorReading::SensorType>(group);
+                break;
+            case GroupBy::SENSOR:
+                result.key.sensorKey = static_cast<SensorReading::SensorKey>(group);
+                break;
+            case GroupBy::TYPE_AND_SENSOR:
+                result.key.sensorKey = static_cast<SensorReading::SensorKey>(group / typeCount);
+                result.key.type = static_cast<SensorReading::SensorType>(group % typeCount);
+                break;
+            case GroupBy::TIME_BUCKET:
+                result.key.bucketStart = bucketByGroup[group] * bucketMs;
+                break;
+        }
+        result.stats = calculateRangeStatistics(partitioned.data() + offsets[group],
+                                                partitioned.data() + offsets[group + 1]);
+    });
+    
+    if (groupBy == GroupBy::TIME_BUCKET) {
+        std::sort(results.begin(), results.end(),
+                  [](const GroupStatistics& a, const GroupStatistics& b) {
+                      return a.key.bucketStart < b.key.bucketStart;
+                  });
+    }
+    
+    return results;
 }
 
-std::vector<SensorReading> SensorDataProcessor::removeOutliers(
-    const std::vector<SensorReading>& readings) const {
+template <typename ValueFn, typename TypeFn>
+std::vector<GroupStatistics> SensorDataProcessor::indexedGroupedStatistics(
+    const ReadingIndex& index, ValueFn value, TypeFn type, GroupBy groupBy) const {
     
-    if (readings.size() < 4) {
-        return readings;  // Need at least 4 points for IQR
+    if (groupBy == GroupBy::TIME_BUCKET) {
+        throw std::invalid_argument("Reading index has no time buckets");
     }
     
-    std::vector<double> values;
-    values.reserve(readings.size());
-    for (const auto& reading : readings) {
-        values.push_back(reading.getValue());
+    // One posting list per task: a type, or a sensor (split by type below)
+    std::vector<PostingList> lists;
+    std::vector<GroupKey> listKeys;
+    if (groupBy == GroupBy::TYPE) {
+        for (size_t code = 0; code < SensorReading::kTypeCount; ++code) {
+            GroupKey key;
+            key.type = static_cast<SensorReading::SensorType>(code);
+            PostingList rows = index.rowsOfType(key.type);
+            if (!rows.empty()) {
+                lists.push_back(rows);
+                listKeys.push_back(key);
+            }
+        }
+    } else {
+        for (size_t sensor = 0; sensor < index.sensorKeyLimit(); ++sensor) {
+            GroupKey key;
+            key.sensorKey = static_cast<SensorReading::SensorKey>(sensor);
+            PostingList rows = index.rowsOfSensor(key.sensorKey);
+            if (!rows.empty()) {
+                lists.push_back(rows);
+                listKeys.push_back(key);
+            }
+        }
+    }
+    
+    std::vector<std::vector<GroupStatistics>> perList(lists.size());
+    parallelFor(lists.size(), 1, [&](size_t slot, size_t) {
+        const PostingList& rows = lists[slot];
+        std::vector<double> values(rows.size());
+        if (groupBy != GroupBy::TYPE_AND_SENSOR) {
+            for (size_t i = 0; i < rows.size(); ++i) {
+                values[i] = value(rows.first[i]);
+            }
+            GroupStatistics result;
+            result.key = listKeys[slot];
+            result.stats = calculateRangeStatistics(values.data(), values.data() + values.size());
+            perList[slot].push_back(result);
+            return;
+        }
+        
+        // Stable split of this sensor's values by type, in row order
+        size_t offsets[SensorReading::kTypeCount + 1] = {};
+        for (uint32_t row : rows) {
+            ++offsets[static_cast<size_t>(type(row)) + 1];
+        }
+        for (size_t code = 0; code < SensorReading::kTypeCount; ++code) {
+            offsets[code + 1] += offsets[code];
+        }
+        size_t cursor[SensorReading::kTypeCount];
+        std::copy(offsets, offsets + SensorReading::kTypeCount, cursor);
+        for (uint32_t row : rows) {
+            values[cursor[static_cast<size_t>(type(row))]++] = value(row);
+        }
+        for (size_t code = 0; code < SensorReading::kTypeCount; ++code) {
+            if (offsets[code] == offsets[code + 1]) {
+                continue;
+            }
+            GroupStatistics result;
+            result.key.sensorKey = listKeys[slot].sensorKey;
+            result.key.type = static_cast<SensorReading::SensorType>(code);
+            result.stats = calculateRangeStatistics(values.data() + offsets[code],
+                                                    values.data() + offsets[code + 1]);
+            perList[slot].push_back(result);
+        }
+    });
+    
+    std::vector<GroupStatistics> results;
+    for (auto& groups : perList) {
+        results.insert(results.end(), groups.begin(), groups.end());
+    }
+    return results;
+}
+
+ReadingBatch SensorDataProcessor::removeOutliers(const ReadingBatch& batch) const {
+    PROFILE_SCOPE("removeOutliers");
+    
+    const auto& values = batch.values();
+    const auto& types = batch.types();
+    const auto& keys = batch.sensorKeys();
+    ValueKernels::RowMask mask;
+    size_t selected = outlierMask(
+        batch.size(),
+        [&values](size_t row) { return values[row]; },
+        [&types](size_t row) { return types[row]; },
+        [&keys](size_t row) { return keys[row]; },
+        [](size_t) { return true; },
+        values.data(), mask);
+    return gatherRows(batch, mask, selected);
+}
+
+void SensorDataProcessor::normalizeValues(ReadingBatch& batch) const {
+    PROFILE_SCOPE("normalize");
+    normalizeColumn(batch.values().data(), batch.size());
+}
+
+SensorStatistics SensorDataProcessor::calculateValueStatistics(
+    std::vector<double>& values) const {
+    
+    return calculateRangeStatistics(values.data(), values.data() + values.size());
+}
+
+SensorStatistics SensorDataProcessor::calculateRangeStatistics(
+    double* first, double* last) const {
+    
+    SensorStatistics stats;
+    stats.count = static_cast<size_t>(last - first);
+    
+    if (first == last) {
+        return stats;
+    }
+    
+    // Min, max and sum with the vector kernels, per chunk, combined in chunk order
+    size_t chunkCount = (stats.count + kRowGrain - 1) / kRowGrain;
+    std::vector<ValueKernels::MinMax> extremes(chunkCount);
+    std::vector<double> sums(chunkCount);
+    parallelFor(stats.count, kRowGrain, [&](size_t begin, size_t end) {
+        extremes[begin / kRowGrain] = ValueKernels::minMax(first + begin, end - begin);
+        sums[begin / kRowGrain] = ValueKernels::sum(first + begin, end - begin);
+    });
+    stats.min = extremes[0].min;
+    stats.max = extremes[0].max;
+    double sum = 0.0;
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        stats.min = std::min(stats.min, extremes[chunk].min);
+        stats.max = std::max(stats.max, extremes[chunk].max);
+        sum += sums[chunk];
+    }
+    stats.mean = sum / stats.count;
+    
+    // Median by selection instead of a full sort
+    stats.median = calculateMedian(first, last);
+    
+    return stats;
+}
+
+OutlierBounds SensorDataProcessor::calculateOutlierBounds(
+    std::vector<double>& values) const {
+    
+    return calculateOutlierBounds(values, outlierOptions_);
+}
+
+OutlierBounds SensorDataProcessor::calculateOutlierBounds(
+    std::vector<double>& values, const OutlierOptions& options) const {
+    PROFILE_SCOPE("stats.outlierBounds");
+    
+    if (options.method == OutlierMethod::ROLLING_IQR) {
+        throw std::invalid_argument("Rolling IQR has no single pair of outlier fences");
+    }
+    if (options.method == OutlierMethod::MAD) {
+        // MAD overwrites its range with absolute deviations; keep the caller's values
+        std::pmr::vector<double> scratchValues(values.begin(), values.end(), scratch());
+        return rangeOutlierBounds(scratchValues.data(), scratchValues.data() + scratchValues.size(),
+                                  options);
+    }
+    return rangeOutlierBounds(values.data(), values.data() + values.size(), options);
+}
+
+std::vector<OutlierBounds> SensorDataProcessor::calculateOutlierBounds(
+    const StreamingSelector::Source& source, const std::vector<size_t>& groupCounts,
+    size_t memoryBytes) const {
+    PROFILE_SCOPE("stats.outlierBounds");
+    
+    const OutlierOptions& options = outlierOptions_;
+    if (options.method == OutlierMethod::ROLLING_IQR) {
+        throw std::invalid_argument("Rolling IQR has no single pair of outlier fences");
     }
+    std::vector<OutlierBounds> bounds(groupCounts.size());
+    StreamingSelector selector(memoryBytes);
     
-    std::sort(values.begin(), values.end());
+    // Order statistics as calculateMedian and calculateQuartiles pick them:
+    // an even count averages a rank with the next one
+    using Request = StreamingSelector::Request;
+    auto addMedian = [](std::vector<Request>& requests, size_t group, size_t n) {
+        requests.push_back(Request{group, (n - 1) / 2});
+        if (n % 2 == 0) {
+            requests.push_back(Request{group, n / 2});
+        }
+    };
+    auto pick = [](const std::vector<double>& selected, size_t& r, bool pair) {
+        double value = selected[r++];
+        return pair ? (value + selected[r++]) / 2.0 : value;
+    };
+    
+    if (options.method == OutlierMethod::IQR) {
+        std::vector<Request> requests;
+        for (size_t group = 0; group < groupCounts.size(); ++group) {
+            size_t n = groupCounts[group];
+            if (n < 4) {
+                continue;
+            }
+            requests.push_back(Request{group, n / 4});
+            if (!(n % 4 == 0 || n % 4 == 1)) {
+                requests.push_back(Request{group, n / 4 + 1});
+            }
+            requests.push_back(Request{group, (3 * n) / 4});
+            if (!(n % 4 == 0 || n % 4 == 3)) {
+                requests.push_back(Request{group, (3 * n) / 4 + 1});
+            }
+        }
+        std::vector<double> selected = selector.select(source, requests);
+        size_t r = 0;
+        for (size_t group = 0; group < groupCounts.size(); ++group) {
+            size_t n = groupCounts[group];
+            if (n < 4) {
+                continue;
+            }
+            double q1 = pick(selected, r, !(n % 4 == 0 || n % 4 == 1));
+            double q3 = pick(selected, r, !(n % 4 == 0 || n % 4 == 3));
+            double iqr = q3 - q1;
+            bounds[group].lower = q1 - options.iqrFactor * iqr;
+            bounds[group].upper = q3 + options.iqrFactor * iqr;
+        }
+        return bounds;
+    }
+    
+    // MAD: medians first, then the median of the absolute deviations from them
+    std::vector<Request> requests;
+    for (size_t group = 0; group < groupCounts.size(); ++group) {
+        if (groupCounts[group] >= 4) {
+            addMedian(requests, group, groupCounts[group]);
+        }
+    }
+    std::vector<double> selected = selector.select(source, requests);
+    std::vector<double> medians(groupCounts.size(), 0.0);
+    size_t r = 0;
+    for (size_t group = 0; group < groupCounts.size(); ++group) {
+        if (groupCounts[group] >= 4) {
+            medians[group] = pick(selected, r, groupCounts[group] % 2 == 0);
+        }
+    }
+    
+    std::vector<double> deviationSums(groupCounts.size(), 0.0);
+    StreamingSelector::Source deviations = [&](const StreamingSelector::Sink& sink) {
+        std::fill(deviationSums.begin(), deviationSums.end(), 0.0);
+        source([&](size_t group, double value) {
+            if (group < groupCounts.size() && groupCounts[group] >= 4) {
+                double deviation = std::abs(value - medians[group]);
+                deviationSums[group] += deviation;
+                sink(group, deviation);
+            }
+        });
+    };
+    selected = selector.select(deviations, requests);
+    r = 0;
+    for (size_t group = 0; group < groupCounts.size(); ++group) {
+        size_t n = groupCounts[group];
+        if (n < 4) {
+            continue;
+        }
+        // Same spread estimate and fallback as rangeOutlierBounds
+        double spread = 1.4826 * pick(selected, r, n % 2 == 0);
+        if (spread == 0.0) {
+            spread = 1.2533 * deviationSums[group] / n;
+        }
+        if (spread == 0.0) {
+            continue;
+        }
+        bounds[group].lower = medians[group] - options.madThreshold * spread;
+        bounds[group].upper = medians[group] + options.madThreshold * spread;
+    }
+    return bounds;
+}
+
+OutlierBounds SensorDataProcessor::rangeOutlierBounds(
+    double* first, double* last, const OutlierOptions& options) const {
+    
+    OutlierBounds bounds;
+    size_t n = static_cast<size_t>(last - first);
+    if (n < 4) {
+        return bounds;  // Need at least 4 points for IQR
+    }
+    
+    if (options.method == OutlierMethod::MAD) {
+        double median = calculateMedian(first, last);
+        double deviationSum = 0.0;
+        for (double* it = first; it != last; ++it) {
+            *it = std::abs(*it - median);
+            deviationSum += *it;
+        }
+        // 1.4826 * MAD estimates the standard deviation of normal data; when
+        // more than half the values sit on the median, fall back to the mean
+        // absolute deviation (scaled by sqrt(pi / 2)) as the spread estimate
+        double spread = 1.4826 * calculateMedian(first, last);
+        if (spread == 0.0) {
+            spread = 1.2533 * deviationSum / n;
+        }
+        if (spread == 0.0) {
+            return bounds;  // All values equal: nothing is an outlier
+        }
+        bounds.lower = median - options.madThreshold * spread;
+        bounds.upper = median + options.madThreshold * spread;
+        return bounds;
+    }
     
     double q1, q3;
-    calculateQuartiles(values, q1, q3);
+    calculateQuartiles(first, last, q1, q3);
     
     double iqr = q3 - q1;
-    double lowerBound = q1 - 1.5 * iqr;
-    double upperBound = q3 + 1.5 * iqr;
+    bounds.lower = q1 - options.iqrFactor * iqr;
+    bounds.upper = q3 + options.iqrFactor * iqr;
+    return bounds;
+}
+
+size_t SensorDataProcessor::outlierGroupCount(OutlierGrouping grouping) {
+    switch (grouping) {
+        case OutlierGrouping::TYPE:
+            return SensorReading::kTypeCount;
+        case OutlierGrouping::SENSOR:
+            return SensorIdTable::global().size();
+        case OutlierGrouping::TYPE_AND_SENSOR:
+            return SensorIdTable::global().size() * SensorReading::kTypeCount;
+        default:
+            return 1;
+    }
+}
+
+size_t SensorDataProcessor::outlierGroupOf(OutlierGrouping grouping,
+                                           SensorReading::SensorType type,
+                                           SensorReading::SensorKey sensorKey) {
+    switch (grouping) {
+        case OutlierGrouping::TYPE:
+            return static_cast<size_t>(type);
+        case OutlierGrouping::SENSOR:
+            return sensorKey;
+        case OutlierGrouping::TYPE_AND_SENSOR:
+            return static_cast<size_t>(sensorKey) * SensorReading::kTypeCount + static_cast<size_t>(type);
+        default:
+            return 0;
+    }
+}
+
+ReadingBatch SensorDataProcessor::process(const ReadingBatch& batch,
+                                          const std::vector<OutlierBounds>& groupBounds,
+                                          OutlierGrouping grouping) const {
+    if (grouping == OutlierGrouping::NONE && groupBounds.size() == 1) {
+        return process(batch, groupBounds[0]);
+    }
     
-    std::vector<SensorReading> filtered;
-    std::copy_if(readings.begin(), readings.end(),
-                 std::back_inserter(filtered),
-                 [lowerBound, upperBound](const SensorReading& r) {
-                     double val = r.getValue();
-                     return val >= lowerBound && val <= upperBound;
-                 });
+    PROFILE_SCOPE("process");
+    const OutlierBounds unbounded;
+    const auto& values = batch.values();
+    const auto& types = batch.types();
+    const auto& keys = batch.sensorKeys();
+    ValueKernels::RowMask mask;
+    size_t kept = buildRowMask(batch.size(), [&](size_t row) {
+        if (!batch.isValid(row)) {
+            return false;
+        }
+        size_t group = outlierGroupOf(grouping, types[row], keys[row]);
+        const OutlierBounds& bounds = group < groupBounds.size() ? groupBounds[group] : unbounded;
+        return values[row] >= bounds.lower && values[row] <= bounds.upper;
+    }, mask);
+    return gatherRows(batch, mask, kept);
+}
+
+ReadingBatch SensorDataProcessor::process(const ReadingBatch& batch,
+                                          const OutlierBounds& bounds) const {
+    PROFILE_SCOPE("process");
+    ValueKernels::RowMask valid;
+    buildRowMask(batch.size(), [&batch](size_t row) { return batch.isValid(row); }, valid);
     
-    return filtered;
+    ValueKernels::RowMask mask;
+    buildRangeMask(batch.values().data(), batch.size(), bounds.lower, bounds.upper, mask);
+    size_t kept = ValueKernels::andMask(mask, valid);
+    return gatherRows(batch, mask, kept);
 }
 
-void SensorDataProcessor::normalizeValues(
-    std::vector<SensorReading>& readings) const {
+template <typename ValueFn, typename ValidFn>
+size_t SensorDataProcessor::survivorMask(size_t rowCount, ValueFn value, ValidFn valid,
+                                         const double* column,
+                                         ValueKernels::RowMask& mask) const {
+    size_t validCount = buildRowMask(rowCount, valid, mask);
     
-    if (readings.empty()) {
-        return;
+    if (validCount < 4) {
+        return validCount;  // Need at least 4 points for IQR
     }
     
-    // Find min and max
-    auto minmax = std::minmax_element(
-        readings.begin(), readings.end(),
-        [](const SensorReading& a, const SensorReading& b) {
-            return a.getValue() < b.getValue();
+    // Fences come from the valid values only; this is the one copy selection needs
+    OutlierBounds bounds;
+    {
+        std::pmr::vector<double> validValues(scratch());
+        validValues.reserve(validCount);
+        ValueKernels::forEachSetBit(mask, [&](size_t row) {
+            validValues.push_back(value(row));
         });
+        bounds = rangeOutlierBounds(validValues.data(), validValues.data() + validValues.size(),
+                                    outlierOptions_);
+    }
+    
+    ValueKernels::RowMask inRange;
+    if (column != nullptr) {
+        buildRangeMask(column, rowCount, bounds.lower, bounds.upper, inRange);
+    } else {
+        buildRowMask(rowCount, [&](size_t row) {
+            double val = value(row);
+            return val >= bounds.lower && val <= bounds.upper;
+        }, inRange);
+    }
+    return ValueKernels::andMask(mask, inRange);
+}
+
+template <typename ValueFn, typename TypeFn, typename KeyFn, typename ValidFn>
+size_t SensorDataProcessor::outlierMask(size_t rowCount, ValueFn value, TypeFn type,
+                                        KeyFn sensorKey, ValidFn valid, const double* column,
+                                        ValueKernels::RowMask& mask) const {
+    PROFILE_SCOPE("process.outliers");
+    size_t kept = (outlierOptions_.grouping == OutlierGrouping::NONE &&
+                   outlierOptions_.method != OutlierMethod::ROLLING_IQR)
+        ? survivorMask(rowCount, value, valid, column, mask)
+        : groupedSurvivorMask(rowCount, value, type, sensorKey, valid, mask);
+    PROFILE_COUNT("process.rowsIn", rowCount);
+    PROFILE_COUNT("process.rowsKept", kept);
+    return kept;
+}
+
+template <typename ValueFn, typename TypeFn, typename KeyFn, typename ValidFn>
+size_t SensorDataProcessor::groupedSurvivorMask(size_t rowCount, ValueFn value, TypeFn type,
+                                                KeyFn sensorKey, ValidFn valid,
+                                                ValueKernels::RowMask& mask) const {
+    const OutlierOptions options = outlierOptions_;
+    const uint32_t kSkipped = std::numeric_limits<uint32_t>::max();
+    size_t groupCount = outlierGroupCount(options.grouping);
+    
+    // Pass 1: group per valid row
+    std::pmr::vector<uint32_t> groupIds(rowCount, scratch());
+    parallelFor(rowCount, kRowGrain, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row) {
+            groupIds[row] = valid(row)
+                ? static_cast<uint32_t>(outlierGroupOf(options.grouping, type(row), sensorKey(row)))
+                : kSkipped;
+        }
+    });
+    
+    // Pass 2: counting-sort row indexes and values by group, keeping row order
+    std::pmr::vector<size_t> offsets(groupCount + 1, 0, scratch());
+    for (uint32_t group : groupIds) {
+        if (group != kSkipped) {
+            ++offsets[group + 1];
+        }
+    }
+    for (size_t group = 0; group < groupCount; ++group) {
+        offsets[group + 1] += offsets[group];
+    }
+    std::pmr::vector<size_t> rows(offsets.back(), scratch());
+    std::pmr::vector<double> values(offsets.back(), scratch());
+    {
+        std::pmr::vector<size_t> cursor(offsets.begin(), offsets.end() - 1, scratch());
+        for (size_t row = 0; row < rowCount; ++row) {
+            if (groupIds[row] != kSkipped) {
+                size_t slot = cursor[groupIds[row]]++;
+                rows[slot] = row;
+                values[slot] = value(row);
+            }
+        }
+    }
+    groupIds.clear();
+    groupIds.shrink_to_fit();
+    
+    // Fences and survivors per group; groups touch disjoint rows of keep
+    std::pmr::vector<uint8_t> keep(rowCount, 0, scratch());
+    std::pmr::vector<size_t> nonEmpty(scratch());
+    for (size_t group = 0; group < groupCount; ++group) {
+        if (offsets[group] != offsets[group + 1]) {
+            nonEmpty.push_back(group);
+        }
+    }
+    parallelFor(nonEmpty.size(), 1, [&](size_t slot, size_t) {
+        size_t group = nonEmpty[slot];
+        size_t first = offsets[group];
+        size_t count = offsets[group + 1] - first;
+        if (options.method == OutlierMethod::ROLLING_IQR) {
+            markRollingSurvivors(values.data() + first, rows.data() + first, count, keep.data());
+            return;
+        }
+        OutlierBounds bounds = rangeOutlierBounds(values.data() + first,
+                                                  values.data() + first + count, options);
+        for (size_t i = first; i < first + count; ++i) {
+            double val = value(rows[i]);
+            keep[rows[i]] = val >= bounds.lower && val <= bounds.upper;
+        }
+    });
+    
+    return buildRowMask(rowCount, [&keep](size_t row) { return keep[row] != 0; }, mask);
+}
+
+void SensorDataProcessor::markRollingSurvivors(const double* values, const size_t* rows,
+                                               size_t count, uint8_t* keep) const {
+    // Non-finite values are outliers; kept out of the windows, whose sorted
+    // order NaN would break, so the rest are fenced without them
+    if (!std::all_of(values, values + count, [](double v) { return std::isfinite(v); })) {
+        std::vector<double> finiteValues;
+        std::vector<size_t> finiteRows;
+        for (size_t i = 0; i < count; ++i) {
+            if (std::isfinite(values[i])) {
+                finiteValues.push_back(values[i]);
+                finiteRows.push_back(rows[i]);
+            } else {
+                keep[rows[i]] = 0;
+            }
+        }
+        markRollingSurvivors(finiteValues.data(), finiteRows.data(), finiteValues.size(), keep);
+        return;
+    }
     
-    double minVal = minmax.first->getValue();
-    double maxVal = minmax.second->getValue();
-    double range = maxVal - minVal;
+    if (count < 4) {
+        for (size_t i = 0; i < count; ++i) {
+            keep[rows[i]] = 1;  // Need at least 4 points for IQR
+        }
+        return;
+    }
+    
+    // Centered window of fixed width, clamped at the group's ends; kept sorted
+    // incrementally so each step is one erase and one insert
+    size_t width = std::min(count, std::max<size_t>(4, outlierOptions_.window));
+    std::vector<double> window(values, values + width);
+    std::sort(window.begin(), window.end());
+    size_t start = 0;
+    double q1 = 0.0;
+    double q3 = 0.0;
+    bool fencesStale = true;
+    for (size_t i = 0; i < count; ++i) {
+        size_t desired = std::min(i > width / 2 ? i - width / 2 : 0, count - width);
+        while (start < desired) {
+            window.erase(std::lower_bound(window.begin(), window.end(), values[start]));
+            double incoming = values[start + width];
+            window.insert(std::upper_bound(window.begin(), window.end(), incoming), incoming);
+            ++start;
+            fencesStale = true;
+        }
+        if (fencesStale) {
+            quartilesFromSorted(window.data(), width, q1, q3);
+            fencesStale = false;
+        }
+        double iqr = q3 - q1;
+        keep[rows[i]] = values[i] >= q1 - outlierOptions_.iqrFactor * iqr &&
+                        values[i] <= q3 + outlierOptions_.iqrFactor * iqr;
+    }
+}
+
+bool SensorDataProcessor::normalizeColumn(double* values, size_t count) const {
+    if (count == 0) {
+        return false;
+    }
+    
+    size_t chunkCount = (count + kRowGrain - 1) / kRowGrain;
+    std::vector<ValueKernels::MinMax> chunkExtremes(chunkCount);
+    parallelFor(count, kRowGrain, [&](size_t begin, size_t end) {
+        chunkExtremes[begin / kRowGrain] = ValueKernels::minMax(values + begin, end - begin);
+    });
+    ValueKernels::MinMax extremes = chunkExtremes[0];
+    for (const auto& chunk : chunkExtremes) {
+        extremes.min = std::min(extremes.min, chunk.min);
+        extremes.max = std::max(extremes.max, chunk.max);
+    }
+    double range = extremes.max - extremes.min;
     
     if (range == 0.0) {
-        return;  // All values are the same
+        return false;  // All values are the same
     }
     
     // Normalize to 0-1 range
-    for (auto& reading : readings) {
-        double normalized = (reading.getValue() - minVal) / range;
-        reading.setValue(normalized);
-    }
+    parallelFor(count, kRowGrain, [&](size_t begin, size_t end) {
+        ValueKernels::normalize(values + begin, end - begin, extremes.min, range);
+    });
+    return true;
 }
 
-double SensorDataProcessor::calculateMedian(std::vector<double>& values) const {
-    if (values.empty()) {
+double SensorDataProcessor::calculateMedian(double* first, double* last) {
+    if (first == last) {
         return 0.0;
     }
     
-    size_t n = values.size();
+    size_t n = static_cast<size_t>(last - first);
+    double* mid = first + n / 2;
+    std::nth_element(first, mid, last);
     if (n % 2 == 0) {
-        return (values[n/2 - 1] + values[n/2]) / 2.0;
+        // The lower middle element is the largest of the left partition
+        double lower = *std::max_element(first, mid);
+        return (lower + *mid) / 2.0;
     } else {
-        return values[n/2];
+        return *mid;
     }
 }
 
 void SensorDataProcessor::calculateQuartiles(
-    const std::vector<double>& sortedValues,
+    double* first, double* last,
     double& q1, double& q3) const {
     
-    size_t n = sortedValues.size();
+    size_t n = static_cast<size_t>(last - first);
     
     // Q1: median of first half
     size_t q1Index = n / 4;
-    if (n % 4 == 0 || n % 4 == 1) {
-        q1 = sortedValues[q1Index];
-    } else {
-        q1 = (sortedValues[q1Index] + sortedValues[q1Index + 1]) / 2.0;
+    std::nth_element(first, first + q1Index, last);
+    q1 = first[q1Index];
+    if (!(n % 4 == 0 || n % 4 == 1)) {
+        // Next order statistic is the smallest of the right partition
+        q1 = (q1 + *std::min_element(first + q1Index + 1, last)) / 2.0;
     }
     
-    // Q3: median of second half
+    // Q3: median of second half; everything left of q1Index + 1 is already
+    // no larger, so select only within the right partition
     size_t q3Index = (3 * n) / 4;
-    if (n % 4 == 0 || n % 4 == 3) {
-        q3 = sortedValues[q3Index];
-    } else {
-        q3 = (sortedValues[q3Index] + sortedValues[q3Index + 1]) / 2.0;
+    std::nth_element(first + q1Index + 1, first + q3Index, last);
+    q3 = first[q3Index];
+    if (!(n % 4 == 0 || n % 4 == 3)) {
+        q3 = (q3 + *std::min_element(first + q3Index + 1, last)) / 2.0;
     }
 }
-
@@ -0,0 +1,58 @@
+#include "SensorIdTable.h"
+#include <mutex>
+#include <stdexcept>
+
+SensorIdTable& SensorIdTable::global() {
+    static SensorIdTable table;
+    return table;
+}
+
+SensorIdTable::SensorIdTable() {
+    ids_.emplace_back();
+    keys_.emplace(std::string_view(ids_.back()), kEmptyKey);
+}
+
+SensorIdTable::Key SensorIdTable::intern(std::string_view sensorId) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = keys_.find(sensorId);
+        if (it != keys_.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    // Another thread may have interned it between the two locks
+    auto it = keys_.find(sensorId);
+    if (it != keys_.end()) {
+        return it->second;
+    }
+
+    Key key = static_cast<Key>(ids_.size());
+    ids_.emplace_back(sensorId);
+    keys_.emplace(std::string_view(ids_.back()), key);
+    return key;
+}
+
+bool SensorIdTable::find(std::string_view sensorId, Key& key) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = keys_.find(sensorId);
+    if (it == keys_.end()) {
+        return false;
+    }
+    key = it->second;
+    return true;
+}
+
+const std::string& SensorIdTable::resolve(Key key) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (key >= ids_.size()) {
+        throw std::out_of_range("Unknown sensor key: " + std::to_string(key));
+    }
+    return ids_[key];
+}
+
+size_t SensorIdTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return ids_.size();
+}
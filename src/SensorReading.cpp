@@ -1,51 +1,70 @@
 #include "SensorReading.h"
 #include <stdexcept>
-#include <map>
+#include <iterator>
 
 SensorReading::SensorReading()
-    : sensorId_(""), type_(SensorType::TEMPERATURE), value_(0.0), timestamp_(0) {
+    : sensorKey_(SensorIdTable::kEmptyKey), type_(SensorType::TEMPERATURE),
+      value_(0.0), timestamp_(0) {
 }
 
 SensorReading::SensorReading(const std::string& sensorId, SensorType type,
                              double value, int64_t timestamp)
-    : sensorId_(sensorId), type_(type), value_(value), timestamp_(timestamp) {
+    : sensorKey_(SensorIdTable::global().intern(sensorId)), type_(type),
+      value_(value), timestamp_(timestamp) {
+}
+
+SensorReading::SensorReading(SensorKey sensorKey, SensorType type,
+                             double value, int64_t timestamp)
+    : sensorKey_(sensorKey), type_(type), value_(value), timestamp_(timestamp) {
 }
 
 std::string SensorReading::typeToString(SensorType type) {
-    static const std::map<SensorType, std::string> typeMap = {
-        {SensorType::TEMPERATURE, "TEMPERATURE"},
-        {SensorType::PRESSURE, "PRESSURE"},
-        {SensorType::DEPTH, "DEPTH"},
-        {SensorType::SONAR, "SONAR"},
-        {SensorType::ACCELEROMETER, "ACCELEROMETER"},
-        {SensorType::GYROSCOPE, "GYROSCOPE"}
+    return std::string(typeName(type));
+}
+
+std::string_view SensorReading::typeName(SensorType type) {
+    // Indexed by SensorType code
+    static constexpr std::string_view kNames[] = {
+        "TEMPERATURE", "PRESSURE", "DEPTH", "SONAR", "ACCELEROMETER", "GYROSCOPE"
     };
-    
-    auto it = typeMap.find(type);
-    if (it != typeMap.end()) {
-        return it->second;
-    }
-    return "UNKNOWN";
+    size_t code = static_cast<size_t>(type);
+    return code < std::size(kNames) ? kNames[code] : "UNKNOWN";
 }
 
 SensorReading::SensorType SensorReading::stringToType(const std::string& str) {
-    static const std::map<std::string, SensorType> stringMap = {
-        {"TEMPERATURE", SensorType::TEMPERATURE},
-        {"PRESSURE", SensorType::PRESSURE},
-        {"DEPTH", SensorType::DEPTH},
-        {"SONAR", SensorType::SONAR},
-        {"ACCELEROMETER", SensorType::ACCELEROMETER},
-        {"GYROSCOPE", SensorType::GYROSCOPE}
-    };
-    
-    auto it = stringMap.find(str);
-    if (it != stringMap.end()) {
-        return it->second;
+    SensorType type;
+    if (parseType(str, type)) {
+        return type;
     }
     return SensorType::TEMPERATURE;  // Default fallback
 }
 
+bool SensorReading::parseType(std::string_view str, SensorType& type) {
+    // Type names have distinct lengths except DEPTH/SONAR, so a switch on the
+    // length picks the single candidate to compare against
+    switch (str.size()) {
+        case 5:
+            if (str == "DEPTH") { type = SensorType::DEPTH; return true; }
+            if (str == "SONAR") { type = SensorType::SONAR; return true; }
+            return false;
+        case 8:
+            if (str == "PRESSURE") { type = SensorType::PRESSURE; return true; }
+            return false;
+        case 9:
+            if (str == "GYROSCOPE") { type = SensorType::GYROSCOPE; return true; }
+            return false;
+        case 11:
+            if (str == "TEMPERATURE") { type = SensorType::TEMPERATURE; return true; }
+            return false;
+        case 13:
+            if (str == "ACCELEROMETER") { type = SensorType::ACCELEROMETER; return true; }
+            return false;
+        default:
+            return false;
+    }
+}
+
 bool SensorReading::isValid() const {
-    return !sensorId_.empty() && timestamp_ > 0;
+    return sensorKey_ != SensorIdTable::kEmptyKey && timestamp_ > 0;
 }
 
@@ -0,0 +1,122 @@
+#include "StatisticsAccumulator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+template <typename T>
+void writePod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T readPod(std::istream& in) {
+    T value;
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("Truncated statistics accumulator");
+    }
+    return value;
+}
+
+}  // namespace
+
+StatisticsAccumulator::StatisticsAccumulator(uint32_t sketchK)
+    : count_(0), min_(0.0), max_(0.0), mean_(0.0), m2_(0.0), sketch_(sketchK) {
+}
+
+void StatisticsAccumulator::add(double value) {
+    if (count_ == 0) {
+        min_ = max_ = value;
+    } else {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    // Welford update
+    ++count_;
+    double delta = value - mean_;
+    mean_ += delta / count_;
+    m2_ += delta * (value - mean_);
+
+    sketch_.add(value);
+}
+
+void StatisticsAccumulator::add(const double* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        add(values[i]);
+    }
+}
+
+void StatisticsAccumulator::merge(const StatisticsAccumulator& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    if (count_ == 0) {
+        count_ = other.count_;
+        min_ = other.min_;
+        max_ = other.max_;
+        mean_ = other.mean_;
+        m2_ = other.m2_;
+        sketch_.merge(other.sketch_);
+        return;
+    }
+
+    // Chan et al. parallel combination of mean and M2
+    size_t total = count_ + other.count_;
+    double delta = other.mean_ - mean_;
+    double weight = static_cast<double>(other.count_) / total;
+    mean_ += delta * weight;
+    m2_ += other.m2_ + delta * delta * static_cast<double>(count_) * weight;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    count_ = total;
+
+    sketch_.merge(other.sketch_);
+}
+
+double StatisticsAccumulator::variance() const {
+    return count_ > 1 ? m2_ / static_cast<double>(count_ - 1) : 0.0;
+}
+
+double StatisticsAccumulator::standardDeviation() const {
+    return std::sqrt(variance());
+}
+
+double StatisticsAccumulator::median() const {
+    return sketch_.quantile(0.5);
+}
+
+void StatisticsAccumulator::serialize(std::ostream& out) const {
+    writePod(out, static_cast<uint64_t>(count_));
+    writePod(out, min_);
+    writePod(out, max_);
+    writePod(out, mean_);
+    writePod(out, m2_);
+    sketch_.serialize(out);
+}
+
+StatisticsAccumulator StatisticsAccumulator::deserialize(std::istream& in) {
+    StatisticsAccumulator acc;
+    acc.count_ = static_cast<size_t>(readPod<uint64_t>(in));
+    acc.min_ = readPod<double>(in);
+    acc.max_ = readPod<double>(in);
+    acc.mean_ = readPod<double>(in);
+    acc.m2_ = readPod<double>(in);
+    acc.sketch_ = QuantileSketch::deserialize(in);
+    if (acc.sketch_.count() > acc.count_) {
+        throw std::runtime_error("Inconsistent statistics accumulator");
+    }
+    return acc;
+}
+
+SensorStatistics StatisticsAccumulator::toStatistics() const {
+    SensorStatistics stats;
+    stats.count = count_;
+    stats.min = min();
+    stats.max = max();
+    stats.mean = mean();
+    stats.median = median();
+    return stats;
+}
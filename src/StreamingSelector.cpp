@@ -0,0 +1,206 @@
+#include "StreamingSelector.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const uint64_t kSignBit = uint64_t(1) << 63;
+const uint32_t kMaxRadixBits = 16;
+const uint64_t kUnknown = std::numeric_limits<uint64_t>::max();
+
+enum class PassMode : uint8_t {
+    IDLE,       // Waits for a later pass
+    HISTOGRAM,  // Counts the next radix digit of keys carrying its prefix
+    COLLECT     // Copies the values carrying its prefix
+};
+
+}  // namespace
+
+StreamingSelector::StreamingSelector(size_t memoryBytes)
+    : memoryBytes_(memoryBytes), passCount_(0) {
+    if (memoryBytes < kMinMemoryBytes) {
+        throw std::invalid_argument("Selection memory budget below " +
+                                    std::to_string(kMinMemoryBytes / 1024) + " KB");
+    }
+}
+
+uint64_t StreamingSelector::keyOf(double value) {
+    // Negative doubles sort in reverse bit order, non-negative ones in bit order
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & kSignBit) ? ~bits : (bits | kSignBit);
+}
+
+double StreamingSelector::valueOf(uint64_t key) {
+    uint64_t bits = (key & kSignBit) ? (key & ~kSignBit) : ~key;
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::vector<double> StreamingSelector::select(const Source& source,
+                                              const std::vector<Request>& requests) {
+    PROFILE_SCOPE("stats.select");
+
+    passCount_ = 0;
+    const size_t count = requests.size();
+    std::vector<double> results(count);
+    if (count == 0) {
+        return results;
+    }
+
+    // Requests by group (CSR), so each value visits only its group's requests
+    size_t groupLimit = 0;
+    for (const Request& request : requests) {
+        groupLimit = std::max(groupLimit, request.group + 1);
+    }
+    size_t fixedBytes = count * (sizeof(State) + sizeof(double) + sizeof(uint32_t) +
+                                 3 * sizeof(size_t) + 2) +
+                        (groupLimit + 1) * sizeof(uint32_t);
+    if (count > std::numeric_limits<uint32_t>::max() || fixedBytes > memoryBytes_ / 2) {
+        throw std::length_error("Too many order statistics for the selection memory budget");
+    }
+    const size_t workBytes = memoryBytes_ - fixedBytes;
+
+    std::vector<uint32_t> groupOffsets(groupLimit + 1, 0);
+    for (const Request& request : requests) {
+        ++groupOffsets[request.group + 1];
+    }
+    for (size_t group = 0; group < groupLimit; ++group) {
+        groupOffsets[group + 1] += groupOffsets[group];
+    }
+    std::vector<uint32_t> groupRequests(count);
+    {
+        std::vector<uint32_t> cursor(groupOffsets.begin(), groupOffsets.end() - 1);
+        for (size_t r = 0; r < count; ++r) {
+            groupRequests[cursor[requests[r].group]++] = static_cast<uint32_t>(r);
+        }
+    }
+
+    std::vector<State> states(count);
+    for (size_t r = 0; r < count; ++r) {
+        states[r] = State{0, requests[r].rank, kUnknown, 0, false};
+    }
+    std::vector<PassMode> modes(count);
+    std::vector<uint8_t> radixBits(count);
+
+    size_t unresolved = count;
+    while (unresolved > 0) {
+        // Plan the pass: candidates that fit in half the budget are copied,
+        // everything else gets a histogram as wide as the rest allows
+        std::fill(modes.begin(), modes.end(), PassMode::IDLE);
+        size_t collectRows = 0;
+        size_t histogramCount = 0;
+        for (size_t r = 0; r < count; ++r) {
+            const State& state = states[r];
+            if (state.resolved) {
+                continue;
+            }
+            if (state.candidates != kUnknown &&
+                state.candidates <= workBytes / 2 / sizeof(double) - collectRows) {
+                modes[r] = PassMode::COLLECT;
+                collectRows += state.candidates;
+            } else {
+                ++histogramCount;
+            }
+        }
+        size_t histogramBytes = workBytes - collectRows * sizeof(double);
+        uint32_t bits = 1;
+        while (bits < kMaxRadixBits &&
+               histogramCount * (sizeof(uint64_t) << (bits + 1)) <= histogramBytes) {
+            ++bits;
+        }
+        size_t histogramSlots = std::min(histogramCount,
+                                         histogramBytes / (sizeof(uint64_t) << bits));
+
+        std::vector<size_t> slotOf(count, 0);
+        std::vector<size_t> collectBegin(count, 0);
+        std::vector<size_t> collectEnd(count, 0);
+        size_t slots = 0;
+        size_t collectOffset = 0;
+        for (size_t r = 0; r < count; ++r) {
+            if (modes[r] == PassMode::COLLECT) {
+                collectBegin[r] = collectEnd[r] = collectOffset;
+                collectOffset += states[r].candidates;
+            } else if (!states[r].resolved && slots < histogramSlots) {
+                modes[r] = PassMode::HISTOGRAM;
+                radixBits[r] = static_cast<uint8_t>(std::min<uint32_t>(bits, 64 - states[r].prefixBits));
+                slotOf[r] = slots++;
+            }
+        }
+        std::vector<uint64_t> histograms(slots << bits, 0);
+        std::vector<double> candidates(collectRows);
+
+        source([&](size_t group, double value) {
+            if (group >= groupLimit) {
+                return;
+            }
+            uint64_t key = keyOf(value);
+            for (uint32_t i = groupOffsets[group]; i < groupOffsets[group + 1]; ++i) {
+                uint32_t r = groupRequests[i];
+                const State& state = states[r];
+                if (modes[r] == PassMode::IDLE ||
+                    (state.prefixBits > 0 && (key >> (64 - state.prefixBits)) != state.prefix)) {
+                    continue;
+                }
+                if (modes[r] == PassMode::HISTOGRAM) {
+                    uint64_t digit = (key << state.prefixBits) >> (64 - radixBits[r]);
+                    ++histograms[(slotOf[r] << bits) + digit];
+                } else if (collectEnd[r] - collectBegin[r] < state.candidates) {
+                    candidates[collectEnd[r]++] = value;
+                }
+            }
+        });
+        ++passCount_;
+
+        for (size_t r = 0; r < count; ++r) {
+            State& state = states[r];
+            if (modes[r] == PassMode::COLLECT) {
+                if (collectEnd[r] - collectBegin[r] != state.candidates) {
+                    throw std::runtime_error("Selection source changed between passes");
+                }
+                double* first = candidates.data() + collectBegin[r];
+                double* last = candidates.data() + collectEnd[r];
+                std::nth_element(first, first + state.rank, last);
+                results[r] = first[state.rank];
+                state.resolved = true;
+                --unresolved;
+            } else if (modes[r] == PassMode::HISTOGRAM) {
+                const uint64_t* histogram = histograms.data() + (slotOf[r] << bits);
+                size_t buckets = size_t(1) << radixBits[r];
+                uint64_t total = 0;
+                for (size_t bucket = 0; bucket < buckets; ++bucket) {
+                    total += histogram[bucket];
+                }
+                if (state.candidates == kUnknown) {
+                    if (state.rank >= total) {
+                        throw std::out_of_range("Order statistic rank beyond its group's values");
+                    }
+                } else if (total != state.candidates) {
+                    throw std::runtime_error("Selection source changed between passes");
+                }
+
+                size_t bucket = 0;
+                while (state.rank >= histogram[bucket]) {
+                    state.rank -= histogram[bucket];
+                    ++bucket;
+                }
+                state.prefix = (state.prefix << radixBits[r]) | bucket;
+                state.prefixBits += radixBits[r];
+                state.candidates = histogram[bucket];
+                if (state.prefixBits == 64) {
+                    // Every candidate carries the same key
+                    results[r] = valueOf(state.prefix);
+                    state.resolved = true;
+                    --unresolved;
+                }
+            }
+        }
+    }
+    PROFILE_COUNT("select.passes", passCount_);
+    return results;
+}
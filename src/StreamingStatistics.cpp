@@ -0,0 +1,323 @@
+#include "StreamingStatistics.h"
+#include "StreamingSelector.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Sketch file layout constants
+const char kSketchMagic[4] = {'S', 'Q', 'S', '1'};
+const uint32_t kSketchVersion = 1;
+const uint32_t kByteOrderMark = 0x01020304;
+const uint32_t kMaxStringBytes = 4096;  // Sensor IDs and type names are far shorter
+
+template <typename T>
+void writePod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T readPod(std::istream& in) {
+    T value;
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("Truncated sketch file");
+    }
+    return value;
+}
+
+void writeString(std::ostream& out, const std::string& str) {
+    writePod(out, static_cast<uint32_t>(str.size()));
+    out.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+std::string readString(std::istream& in) {
+    uint32_t length = readPod<uint32_t>(in);
+    if (length > kMaxStringBytes) {
+        throw std::runtime_error("Invalid sketch file");
+    }
+    std::string str(length, '\0');
+    if (!in.read(&str[0], length)) {
+        throw std::runtime_error("Truncated sketch file");
+    }
+    return str;
+}
+
+}  // namespace
+
+StreamingStatistics::StreamingStatistics(uint32_t sketchK)
+    : sketchK_(sketchK), mediansResolved_(false), count_(0) {
+}
+
+size_t StreamingStatistics::groupOf(SensorReading::SensorKey key, SensorReading::SensorType type) {
+    size_t group = key * SensorReading::kTypeCount + static_cast<size_t>(type);
+    if (approximate()) {
+        if (group >= summaries_.size()) {
+            summaries_.resize(group + 1, StatisticsAccumulator(sketchK_));
+        }
+    } else if (group >= exact_.size()) {
+        exact_.resize(group + 1);
+    }
+    return group;
+}
+
+void StreamingStatistics::add(const ReadingBatch& batch) {
+    const auto& values = batch.values();
+    const auto& types = batch.types();
+    const auto& keys = batch.sensorKeys();
+    for (size_t row = 0; row < batch.size(); ++row) {
+        size_t group = groupOf(keys[row], types[row]);
+        double value = values[row];
+        if (approximate()) {
+            summaries_[group].add(value);
+            continue;
+        }
+        ExactGroup& exact = exact_[group];
+        if (exact.count == 0) {
+            exact.min = exact.max = value;
+        } else {
+            exact.min = std::min(exact.min, value);
+            exact.max = std::max(exact.max, value);
+        }
+        exact.sum += value;
+        ++exact.count;
+    }
+    count_ += batch.size();
+    mediansResolved_ = false;
+}
+
+size_t StreamingStatistics::resolveMedians(const BatchReplay& replay, size_t memoryBytes) {
+    if (approximate()) {
+        return 0;
+    }
+
+    // Median slots: 0 overall, 1 + type, 1 + type count + sensor key
+    const size_t typeCount = SensorReading::kTypeCount;
+    const size_t sensorLimit = (exact_.size() + typeCount - 1) / typeCount;
+    std::vector<size_t> slotCounts(1 + typeCount + sensorLimit, 0);
+    for (size_t group = 0; group < exact_.size(); ++group) {
+        size_t n = exact_[group].count;
+        slotCounts[0] += n;
+        slotCounts[1 + group % typeCount] += n;
+        slotCounts[1 + typeCount + group / typeCount] += n;
+    }
+
+    // Same definition as SensorDataProcessor::calculateMedian: the middle
+    // value, or the mean of the two middle values for an even count
+    std::vector<StreamingSelector::Request> requests;
+    for (size_t slot = 0; slot < slotCounts.size(); ++slot) {
+        size_t n = slotCounts[slot];
+        if (n == 0) {
+            continue;
+        }
+        requests.push_back(StreamingSelector::Request{slot, n / 2});
+        if (n % 2 == 0) {
+            requests.push_back(StreamingSelector::Request{slot, n / 2 - 1});
+        }
+    }
+
+    StreamingSelector selector(memoryBytes);
+    std::vector<double> selected = selector.select(
+        [&replay](const StreamingSelector::Sink& sink) {
+            replay([&sink](const ReadingBatch& batch) {
+                for (size_t row = 0; row < batch.size(); ++row) {
+                    double value = batch.values()[row];
+                    sink(0, value);
+                    sink(1 + static_cast<size_t>(batch.types()[row]), value);
+                    sink(1 + SensorReading::kTypeCount + batch.sensorKeys()[row], value);
+                }
+            });
+        },
+        requests);
+
+    medians_.assign(slotCounts.size(), 0.0);
+    for (size_t r = 0; r < requests.size(); ++r) {
+        size_t slot = requests[r].group;
+        if (slotCounts[slot] % 2 == 0) {
+            medians_[slot] = (selected[r] + selected[r + 1]) / 2.0;
+            ++r;
+        } else {
+            medians_[slot] = selected[r];
+        }
+    }
+    mediansResolved_ = true;
+    return selector.passCount();
+}
+
+void StreamingStatistics::requireExact() const {
+    if (!mediansResolved_) {
+        throw std::logic_error("Exact streaming medians need resolveMedians() after the last add()");
+    }
+}
+
+void StreamingStatistics::requireApproximate(const char* what) const {
+    if (!approximate()) {
+        throw std::logic_error(std::string(what) + " needs approximate statistics");
+    }
+}
+
+template <typename InTarget>
+SensorStatistics StreamingStatistics::exactStatistics(size_t target, InTarget inTarget) const {
+    SensorStatistics stats;
+    double sum = 0.0;
+    for (size_t group = 0; group < exact_.size(); ++group) {
+        const ExactGroup& exact = exact_[group];
+        if (exact.count == 0 || !inTarget(group)) {
+            continue;
+        }
+        if (stats.count == 0) {
+            stats.min = exact.min;
+            stats.max = exact.max;
+        } else {
+            stats.min = std::min(stats.min, exact.min);
+            stats.max = std::max(stats.max, exact.max);
+        }
+        stats.count += exact.count;
+        sum += exact.sum;
+    }
+    if (stats.count > 0) {
+        stats.mean = sum / stats.count;
+        stats.median = medians_[target];
+    }
+    return stats;
+}
+
+SensorStatistics StreamingStatistics::overall() const {
+    if (approximate()) {
+        return overallSummary().toStatistics();
+    }
+    requireExact();
+    return exactStatistics(0, [](size_t) { return true; });
+}
+
+std::map<SensorReading::SensorType, SensorStatistics> StreamingStatistics::byType() const {
+    std::map<SensorReading::SensorType, SensorStatistics> statsMap;
+    if (approximate()) {
+        for (const auto& pair : byTypeSummary()) {
+            statsMap[pair.first] = pair.second.toStatistics();
+        }
+        return statsMap;
+    }
+    requireExact();
+    for (size_t type = 0; type < SensorReading::kTypeCount; ++type) {
+        SensorStatistics stats = exactStatistics(1 + type,
+            [type](size_t group) { return group % SensorReading::kTypeCount == type; });
+        if (stats.count > 0) {
+            statsMap[static_cast<SensorReading::SensorType>(type)] = stats;
+        }
+    }
+    return statsMap;
+}
+
+std::map<std::string, SensorStatistics> StreamingStatistics::bySensorId() const {
+    std::map<std::string, SensorStatistics> statsMap;
+    if (approximate()) {
+        for (const auto& pair : bySensorIdSummary()) {
+            statsMap[pair.first] = pair.second.toStatistics();
+        }
+        return statsMap;
+    }
+    requireExact();
+    for (size_t first = 0; first < exact_.size(); first += SensorReading::kTypeCount) {
+        size_t sensor = first / SensorReading::kTypeCount;
+        SensorStatistics stats = exactStatistics(1 + SensorReading::kTypeCount + sensor,
+            [sensor](size_t group) { return group / SensorReading::kTypeCount == sensor; });
+        if (stats.count > 0) {
+            auto key = static_cast<SensorIdTable::Key>(sensor);
+            statsMap[SensorIdTable::global().resolve(key)] = stats;
+        }
+    }
+    return statsMap;
+}
+
+StatisticsAccumulator StreamingStatistics::overallSummary() const {
+    requireApproximate("Quantile summaries");
+    StatisticsAccumulator summary(sketchK_);
+    for (const auto& group : summaries_) {
+        summary.merge(group);
+    }
+    return summary;
+}
+
+std::map<SensorReading::SensorType, StatisticsAccumulator> StreamingStatistics::byTypeSummary() const {
+    requireApproximate("Quantile summaries");
+    std::map<SensorReading::SensorType, StatisticsAccumulator> summaryMap;
+    for (size_t group = 0; group < summaries_.size(); ++group) {
+        const StatisticsAccumulator& summary = summaries_[group];
+        if (summary.count() > 0) {
+            auto type = static_cast<SensorReading::SensorType>(group % SensorReading::kTypeCount);
+            auto it = summaryMap.emplace(type, StatisticsAccumulator(summary.sketch().k())).first;
+            it->second.merge(summary);
+        }
+    }
+    return summaryMap;
+}
+
+std::map<std::string, StatisticsAccumulator> StreamingStatistics::bySensorIdSummary() const {
+    requireApproximate("Quantile summaries");
+    std::map<std::string, StatisticsAccumulator> summaryMap;
+    for (size_t group = 0; group < summaries_.size(); ++group) {
+        const StatisticsAccumulator& summary = summaries_[group];
+        if (summary.count() > 0) {
+            auto key = static_cast<SensorIdTable::Key>(group / SensorReading::kTypeCount);
+            auto it = summaryMap.emplace(SensorIdTable::global().resolve(key),
+                                         StatisticsAccumulator(summary.sketch().k())).first;
+            it->second.merge(summary);
+        }
+    }
+    return summaryMap;
+}
+
+void StreamingStatistics::writeSketches(std::ostream& out) const {
+    requireApproximate("Sketch files");
+
+    // Header, then one (sensor ID, type name, summary) record per non-empty group
+    std::vector<size_t> nonEmpty;
+    for (size_t group = 0; group < summaries_.size(); ++group) {
+        if (summaries_[group].count() > 0) {
+            nonEmpty.push_back(group);
+        }
+    }
+
+    out.write(kSketchMagic, sizeof(kSketchMagic));
+    writePod(out, kSketchVersion);
+    writePod(out, kByteOrderMark);
+    writePod(out, static_cast<uint32_t>(nonEmpty.size()));
+    for (size_t group : nonEmpty) {
+        auto key = static_cast<SensorIdTable::Key>(group / SensorReading::kTypeCount);
+        auto type = static_cast<SensorReading::SensorType>(group % SensorReading::kTypeCount);
+        writeString(out, SensorIdTable::global().resolve(key));
+        writeString(out, std::string(SensorReading::typeName(type)));
+        summaries_[group].serialize(out);
+    }
+}
+
+void StreamingStatistics::mergeSketches(std::istream& in) {
+    if (!approximate()) {
+        throw std::logic_error("Sketch files can only be merged into approximate statistics");
+    }
+
+    char magic[sizeof(kSketchMagic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kSketchMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a sketch file");
+    }
+    if (readPod<uint32_t>(in) != kSketchVersion) {
+        throw std::runtime_error("Unsupported sketch file version");
+    }
+    if (readPod<uint32_t>(in) != kByteOrderMark) {
+        throw std::runtime_error("Sketch file has foreign byte order");
+    }
+
+    uint32_t records = readPod<uint32_t>(in);
+    for (uint32_t i = 0; i < records; ++i) {
+        std::string sensorId = readString(in);
+        SensorReading::SensorType type;
+        if (!SensorReading::parseType(readString(in), type)) {
+            throw std::runtime_error("Unknown sensor type in sketch file");
+        }
+        StatisticsAccumulator summary = StatisticsAccumulator::deserialize(in);
+        size_t group = groupOf(SensorIdTable::global().intern(sensorId), type);
+        summaries_[group].merge(summary);
+        count_ += summary.count();
+    }
+}
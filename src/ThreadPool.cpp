@@ -0,0 +1,153 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <exception>
+
+namespace {
+
+// Worker identity, so tasks submitted from a worker land on its own deque
+thread_local const ThreadPool* tlsPool = nullptr;
+thread_local size_t tlsIndex = 0;
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : pending_(0), stop_(false), nextQueue_(0) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    size_t workerCount = threadCount - 1;  // The caller is the last thread
+    queues_.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain,
+                             const std::function<void(size_t, size_t)>& body) {
+    grain = std::max<size_t>(1, grain);
+    size_t chunks = (count + grain - 1) / grain;
+    if (chunks <= 1 || workers_.empty()) {
+        for (size_t begin = 0; begin < count; begin += grain) {
+            body(begin, std::min(count, begin + grain));
+        }
+        return;
+    }
+
+    std::atomic<size_t> remaining(chunks);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto runChunk = [&](size_t chunk) {
+        size_t begin = chunk * grain;
+        try {
+            body(begin, std::min(count, begin + grain));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        // Last touch of this frame's state; the caller may return right after
+        remaining.fetch_sub(1, std::memory_order_acq_rel);
+    };
+
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        push([&runChunk, chunk]() { runChunk(chunk); });
+    }
+    runChunk(0);
+
+    // Help with queued work (ours or anyone's) until every chunk is done
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!tryRunOne()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::push(Task task) {
+    size_t queue = (tlsPool == this)
+        ? tlsIndex
+        : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+        queues_[queue]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        ++pending_;
+    }
+    wake_.notify_one();
+}
+
+bool ThreadPool::popTask(size_t queue, bool newest, Task& task) {
+    WorkerQueue& q = *queues_[queue];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) {
+        return false;
+    }
+    if (newest) {
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+    } else {
+        task = std::move(q.tasks.front());
+        q.tasks.pop_front();
+    }
+    return true;
+}
+
+bool ThreadPool::tryRunOne() {
+    bool isWorker = (tlsPool == this);
+    size_t self = isWorker ? tlsIndex : 0;
+    Task task;
+
+    // Own deque newest-first (cache-warm), then steal oldest-first from others
+    bool found = isWorker && popTask(self, true, task);
+    for (size_t i = 0; !found && i < queues_.size(); ++i) {
+        size_t victim = (self + i + (isWorker ? 1 : 0)) % queues_.size();
+        found = popTask(victim, false, task);
+    }
+    if (!found) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        --pending_;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    tlsPool = this;
+    tlsIndex = index;
+    while (true) {
+        if (tryRunOne()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this]() { return stop_ || pending_ > 0; });
+        if (stop_ && pending_ == 0) {
+            return;
+        }
+    }
+}
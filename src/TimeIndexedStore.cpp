@@ -0,0 +1,168 @@
+#include "TimeIndexedStore.h"
+#include "ValueKernels.h"
+#include <algorithm>
+#include <numeric>
+
+TimeIndexedStore::TimeIndexedStore(size_t blockRows)
+    : blockRows_(std::max<size_t>(1, blockRows)) {}
+
+TimeIndexedStore::TimeIndexedStore(ReadingBatch batch, size_t blockRows)
+    : rows_(sortedByTime(std::move(batch))), blockRows_(std::max<size_t>(1, blockRows)) {
+    rebuildBlocks(0);
+}
+
+ReadingBatch TimeIndexedStore::sortedByTime(ReadingBatch batch) {
+    const auto& timestamps = batch.timestamps();
+    if (std::is_sorted(timestamps.begin(), timestamps.end())) {
+        return batch;  // Archives are usually written in time order already
+    }
+    std::vector<size_t> order(batch.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return timestamps[a] < timestamps[b];
+    });
+    return batch.gather(order);
+}
+
+ReadingBatch TimeIndexedStore::mergeByTime(const ReadingBatch& left, const ReadingBatch& right) {
+    ReadingBatch merged;
+    merged.reserve(left.size() + right.size());
+    const auto& leftTimes = left.timestamps();
+    const auto& rightTimes = right.timestamps();
+    size_t i = 0;
+    size_t j = 0;
+    while (i < left.size() || j < right.size()) {
+        // Stored rows win ties so equal timestamps keep insertion order
+        if (j == right.size() || (i < left.size() && leftTimes[i] <= rightTimes[j])) {
+            merged.appendRow(left, i++);
+        } else {
+            merged.appendRow(right, j++);
+        }
+    }
+    return merged;
+}
+
+void TimeIndexedStore::append(const ReadingBatch& batch) {
+    if (batch.empty()) {
+        return;
+    }
+    ReadingBatch incoming = sortedByTime(batch);
+    if (rows_.empty() || incoming.timestamps().front() >= rows_.timestamps().back()) {
+        rows_.append(incoming);
+        // Only the last block may have been partial
+        rebuildBlocks(blocks_.empty() ? 0 : blocks_.size() - 1);
+    } else {
+        rows_ = mergeByTime(rows_, incoming);
+        rebuildBlocks(0);
+    }
+}
+
+void TimeIndexedStore::rebuildBlocks(size_t firstBlock) {
+    blocks_.resize(firstBlock);
+    const double* values = rows_.values().data();
+    const auto& timestamps = rows_.timestamps();
+    for (size_t begin = firstBlock * blockRows_; begin < rows_.size(); begin += blockRows_) {
+        size_t end = std::min(rows_.size(), begin + blockRows_);
+        ValueKernels::MinMax extremes = ValueKernels::minMax(values + begin, end - begin);
+        TimeBlock block;
+        block.begin = begin;
+        block.end = end;
+        block.minTimestamp = timestamps[begin];
+        block.maxTimestamp = timestamps[end - 1];
+        block.minValue = extremes.min;
+        block.maxValue = extremes.max;
+        block.sum = ValueKernels::sum(values + begin, end - begin);
+        blocks_.push_back(block);
+    }
+}
+
+size_t TimeIndexedStore::lowerBound(int64_t timestamp) const {
+    // First block that can hold the timestamp, then the row within it
+    auto block = std::partition_point(blocks_.begin(), blocks_.end(), [&](const TimeBlock& b) {
+        return b.maxTimestamp < timestamp;
+    });
+    if (block == blocks_.end()) {
+        return rows_.size();
+    }
+    const auto& timestamps = rows_.timestamps();
+    return static_cast<size_t>(
+        std::lower_bound(timestamps.begin() + block->begin, timestamps.begin() + block->end,
+                         timestamp) - timestamps.begin());
+}
+
+std::pair<size_t, size_t> TimeIndexedStore::rowRange(int64_t t0, int64_t t1) const {
+    if (t1 <= t0) {
+        return {0, 0};
+    }
+    return {lowerBound(t0), lowerBound(t1)};
+}
+
+ReadingBatch TimeIndexedStore::rangeScan(int64_t t0, int64_t t1) const {
+    auto range = rowRange(t0, t1);
+    return rows_.slice(range.first, range.second);
+}
+
+ReadingBatch TimeIndexedStore::rangeScan(int64_t t0, int64_t t1,
+                                         double minValue, double maxValue) const {
+    auto range = rowRange(t0, t1);
+    ReadingBatch result;
+    if (range.first == range.second) {
+        return result;
+    }
+    const auto& values = rows_.values();
+    size_t firstBlock = range.first / blockRows_;
+    size_t lastBlock = (range.second - 1) / blockRows_;
+    for (size_t b = firstBlock; b <= lastBlock; ++b) {
+        const TimeBlock& block = blocks_[b];
+        if (block.maxValue < minValue || block.minValue > maxValue) {
+            continue;  // No row of this block can match
+        }
+        size_t begin = std::max(block.begin, range.first);
+        size_t end = std::min(block.end, range.second);
+        for (size_t row = begin; row < end; ++row) {
+            if (values[row] >= minValue && values[row] <= maxValue) {
+                result.appendRow(rows_, row);
+            }
+        }
+    }
+    return result;
+}
+
+SensorStatistics TimeIndexedStore::rangeStatistics(int64_t t0, int64_t t1) const {
+    SensorStatistics stats;
+    auto range = rowRange(t0, t1);
+    if (range.first == range.second) {
+        return stats;
+    }
+
+    const double* values = rows_.values().data();
+    double minValue = values[range.first];
+    double maxValue = minValue;
+    double sum = 0.0;
+    size_t firstBlock = range.first / blockRows_;
+    size_t lastBlock = (range.second - 1) / blockRows_;
+    for (size_t b = firstBlock; b <= lastBlock; ++b) {
+        const TimeBlock& block = blocks_[b];
+        size_t begin = std::max(block.begin, range.first);
+        size_t end = std::min(block.end, range.second);
+        if (begin == block.begin && end == block.end) {
+            minValue = std::min(minValue, block.minValue);
+            maxValue = std::max(maxValue, block.maxValue);
+            sum += block.sum;
+        } else {
+            ValueKernels::MinMax extremes = ValueKernels::minMax(values + begin, end - begin);
+            minValue = std::min(minValue, extremes.min);
+            maxValue = std::max(maxValue, extremes.max);
+            sum += ValueKernels::sum(values + begin, end - begin);
+        }
+    }
+
+    stats.count = range.second - range.first;
+    stats.min = minValue;
+    stats.max = maxValue;
+    stats.mean = sum / stats.count;
+    std::vector<double> scratch(values + range.first, values + range.second);
+    stats.median = SensorDataProcessor::calculateMedian(scratch.data(),
+                                                        scratch.data() + scratch.size());
+    return stats;
+}
@@ -0,0 +1,251 @@
+#include "TimeSeriesCodec.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace TimeSeriesCodec {
+
+namespace {
+
+// Delta-of-delta buckets after the '0' (unchanged interval) case: control
+// bits, control width, payload width. The payload stores dod - minimum.
+struct DodBucket {
+    uint64_t control;
+    int controlBits;
+    int payloadBits;
+    int64_t minimum;
+};
+const DodBucket kDodBuckets[] = {
+    {0b10, 2, 7, -63},
+    {0b110, 3, 9, -255},
+    {0b1110, 4, 12, -2047}
+};
+const uint64_t kRawDodControl = 0b1111;  // Followed by all 64 bits
+const int kRawDodControlBits = 4;
+
+const int kLeadingBits = 5;          // Leading-zero count field, capped at 31
+const int kMaxLeading = (1 << kLeadingBits) - 1;
+const int kLengthBits = 6;           // Meaningful-bit count minus one
+
+const size_t kFirstRowBits = 128;    // Raw timestamp and value
+const size_t kMinRowBits = 2;        // '0' timestamp and '0' value
+
+uint64_t lowMask(int count) {
+    return count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+}
+
+int leadingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(word);
+#else
+    int count = 0;
+    for (uint64_t bit = uint64_t(1) << 63; !(word & bit); bit >>= 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+int trailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int count = 0;
+    for (; !(word & 1); word >>= 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+uint64_t doubleBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsDouble(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Per-stream state shared by the encoder and decoder. Timestamp arithmetic
+// is unsigned so arbitrary int64 inputs wrap instead of overflowing.
+struct StreamState {
+    uint64_t timestamp = 0;
+    uint64_t delta = 0;
+    uint64_t value = 0;
+    int leading = -1;  // -1 until a window has been written
+    int trailing = 0;
+};
+
+void encodeTimestamp(BitWriter& writer, StreamState& state, uint64_t timestamp) {
+    uint64_t delta = timestamp - state.timestamp;
+    int64_t dod = static_cast<int64_t>(delta - state.delta);
+    state.timestamp = timestamp;
+    state.delta = delta;
+
+    if (dod == 0) {
+        writer.write(0, 1);
+        return;
+    }
+    for (const DodBucket& bucket : kDodBuckets) {
+        int64_t maximum = bucket.minimum + static_cast<int64_t>(lowMask(bucket.payloadBits));
+        if (dod >= bucket.minimum && dod <= maximum) {
+            writer.write(bucket.control, bucket.controlBits);
+            writer.write(static_cast<uint64_t>(dod - bucket.minimum), bucket.payloadBits);
+            return;
+        }
+    }
+    writer.write(kRawDodControl, kRawDodControlBits);
+    writer.write(static_cast<uint64_t>(dod), 64);
+}
+
+uint64_t decodeTimestamp(BitReader& reader, StreamState& state) {
+    int64_t dod = 0;
+    if (reader.read(1)) {
+        const DodBucket* match = nullptr;
+        for (const DodBucket& bucket : kDodBuckets) {
+            if (!reader.read(1)) {
+                match = &bucket;
+                break;
+            }
+        }
+        dod = match ? match->minimum + static_cast<int64_t>(reader.read(match->payloadBits))
+                    : static_cast<int64_t>(reader.read(64));
+    }
+    state.delta += static_cast<uint64_t>(dod);
+    state.timestamp += state.delta;
+    return state.timestamp;
+}
+
+void encodeValue(BitWriter& writer, StreamState& state, uint64_t value) {
+    uint64_t xored = value ^ state.value;
+    state.value = value;
+    if (xored == 0) {
+        writer.write(0, 1);
+        return;
+    }
+    writer.write(1, 1);
+
+    int leading = std::min(leadingZeros(xored), kMaxLeading);
+    int trailing = trailingZeros(xored);
+    if (state.leading >= 0 && leading >= state.leading && trailing >= state.trailing) {
+        // Fits the previous window: reuse it
+        writer.write(0, 1);
+        writer.write(xored >> state.trailing, 64 - state.leading - state.trailing);
+        return;
+    }
+
+    int length = 64 - leading - trailing;
+    writer.write(1, 1);
+    writer.write(static_cast<uint64_t>(leading), kLeadingBits);
+    writer.write(static_cast<uint64_t>(length - 1), kLengthBits);
+    writer.write(xored >> trailing, length);
+    state.leading = leading;
+    state.trailing = trailing;
+}
+
+uint64_t decodeValue(BitReader& reader, StreamState& state) {
+    if (!reader.read(1)) {
+        return state.value;
+    }
+    if (reader.read(1)) {
+        int leading = static_cast<int>(reader.read(kLeadingBits));
+        int length = static_cast<int>(reader.read(kLengthBits)) + 1;
+        if (leading + length > 64) {
+            throw std::runtime_error("Corrupt compressed block: invalid XOR window");
+        }
+        state.leading = leading;
+        state.trailing = 64 - leading - length;
+    } else if (state.leading < 0) {
+        throw std::runtime_error("Corrupt compressed block: missing XOR window");
+    }
+    int length = 64 - state.leading - state.trailing;
+    state.value ^= reader.read(length) << state.trailing;
+    return state.value;
+}
+
+}  // namespace
+
+void BitWriter::write(uint64_t value, int count) {
+    if (count > 32) {
+        // Keep the pending buffer within 64 bits
+        write(value >> 32, count - 32);
+        write(value, 32);
+        return;
+    }
+    buffer_ = (buffer_ << count) | (value & lowMask(count));
+    bits_ += count;
+    while (bits_ >= 8) {
+        bits_ -= 8;
+        out_.push_back(static_cast<uint8_t>(buffer_ >> bits_));
+    }
+}
+
+void BitWriter::flush() {
+    if (bits_ > 0) {
+        out_.push_back(static_cast<uint8_t>(buffer_ << (8 - bits_)));
+        bits_ = 0;
+    }
+    buffer_ = 0;
+}
+
+uint64_t BitReader::read(int count) {
+    if (count > 32) {
+        uint64_t high = read(count - 32);
+        return (high << 32) | read(32);
+    }
+    while (bits_ < count) {
+        if (offset_ == size_) {
+            throw std::runtime_error("Corrupt compressed block: truncated bit stream");
+        }
+        buffer_ = (buffer_ << 8) | data_[offset_++];
+        bits_ += 8;
+    }
+    bits_ -= count;
+    return (buffer_ >> bits_) & lowMask(count);
+}
+
+void encodeBlock(const int64_t* timestamps, const double* values, size_t rows,
+                 std::vector<uint8_t>& out) {
+    if (rows == 0) {
+        return;
+    }
+    BitWriter writer(out);
+    StreamState state;
+    state.timestamp = static_cast<uint64_t>(timestamps[0]);
+    state.value = doubleBits(values[0]);
+    writer.write(state.timestamp, 64);
+    writer.write(state.value, 64);
+    for (size_t row = 1; row < rows; ++row) {
+        encodeTimestamp(writer, state, static_cast<uint64_t>(timestamps[row]));
+        encodeValue(writer, state, doubleBits(values[row]));
+    }
+    writer.flush();
+}
+
+size_t maxRows(size_t size) {
+    size_t bits = size * 8;
+    return bits < kFirstRowBits ? 0 : (bits - kFirstRowBits) / kMinRowBits + 1;
+}
+
+void decodeBlock(const uint8_t* data, size_t size, size_t rows,
+                 int64_t* timestamps, double* values) {
+    if (rows == 0) {
+        return;
+    }
+    BitReader reader(data, size);
+    StreamState state;
+    state.timestamp = reader.read(64);
+    state.value = reader.read(64);
+    timestamps[0] = static_cast<int64_t>(state.timestamp);
+    values[0] = bitsDouble(state.value);
+    for (size_t row = 1; row < rows; ++row) {
+        timestamps[row] = static_cast<int64_t>(decodeTimestamp(reader, state));
+        values[row] = bitsDouble(decodeValue(reader, state));
+    }
+}
+
+}  // namespace TimeSeriesCodec
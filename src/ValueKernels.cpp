@@ -0,0 +1,335 @@
+#include "ValueKernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SENSOR_HAVE_X86_KERNELS 1
+#endif
+
+namespace ValueKernels {
+
+namespace {
+
+constexpr size_t kWordBits = 64;
+
+// ---------------------------------------------------------------------------
+// Scalar reference implementations
+// ---------------------------------------------------------------------------
+
+MinMax minMaxScalar(const double* values, size_t count) {
+    MinMax result{values[0], values[0]};
+    for (size_t i = 1; i < count; ++i) {
+        result.min = std::min(result.min, values[i]);
+        result.max = std::max(result.max, values[i]);
+    }
+    return result;
+}
+
+double sumScalar(const double* values, size_t count) {
+    double total = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+// Mask for up to 64 rows
+uint64_t rangeWordScalar(const double* values, size_t count,
+                         double lower, double upper) {
+    uint64_t word = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t hit = (values[i] >= lower) & (values[i] <= upper);
+        word |= hit << i;
+    }
+    return word;
+}
+
+void normalizeScalar(double* values, size_t count, double offset, double scale) {
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = (values[i] - offset) / scale;
+    }
+}
+
+#ifdef SENSOR_HAVE_X86_KERNELS
+
+// ---------------------------------------------------------------------------
+// SSE2 (baseline on x86-64)
+// ---------------------------------------------------------------------------
+
+MinMax minMaxSse2(const double* values, size_t count) {
+    __m128d lo = _mm_set1_pd(values[0]);
+    __m128d hi = lo;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(values + i);
+        lo = _mm_min_pd(v, lo);
+        hi = _mm_max_pd(v, hi);
+    }
+    double lanes[2];
+    MinMax result;
+    _mm_storeu_pd(lanes, lo);
+    result.min = std::min(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, hi);
+    result.max = std::max(lanes[0], lanes[1]);
+    for (; i < count; ++i) {
+        result.min = std::min(result.min, values[i]);
+        result.max = std::max(result.max, values[i]);
+    }
+    return result;
+}
+
+double sumSse2(const double* values, size_t count) {
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(values + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(values + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    double total = lanes[0] + lanes[1];
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+uint64_t rangeWordSse2(const double* values, size_t count,
+                       double lower, double upper) {
+    __m128d lo = _mm_set1_pd(lower);
+    __m128d hi = _mm_set1_pd(upper);
+    uint64_t word = 0;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(values + i);
+        __m128d in = _mm_and_pd(_mm_cmpge_pd(v, lo), _mm_cmple_pd(v, hi));
+        word |= static_cast<uint64_t>(_mm_movemask_pd(in)) << i;
+    }
+    if (i < count) {
+        word |= rangeWordScalar(values + i, count - i, lower, upper) << i;
+    }
+    return word;
+}
+
+void normalizeSse2(double* values, size_t count, double offset, double scale) {
+    __m128d off = _mm_set1_pd(offset);
+    __m128d sc = _mm_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(values + i);
+        _mm_storeu_pd(values + i, _mm_div_pd(_mm_sub_pd(v, off), sc));
+    }
+    normalizeScalar(values + i, count - i, offset, scale);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2, compiled per function so the rest of the binary stays baseline
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+MinMax minMaxAvx2(const double* values, size_t count) {
+    __m256d lo0 = _mm256_set1_pd(values[0]);
+    __m256d hi0 = lo0;
+    __m256d lo1 = lo0;
+    __m256d hi1 = lo0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d a = _mm256_loadu_pd(values + i);
+        __m256d b = _mm256_loadu_pd(values + i + 4);
+        lo0 = _mm256_min_pd(a, lo0);
+        hi0 = _mm256_max_pd(a, hi0);
+        lo1 = _mm256_min_pd(b, lo1);
+        hi1 = _mm256_max_pd(b, hi1);
+    }
+    double lanes[4];
+    MinMax result;
+    _mm256_storeu_pd(lanes, _mm256_min_pd(lo0, lo1));
+    result.min = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+    _mm256_storeu_pd(lanes, _mm256_max_pd(hi0, hi1));
+    result.max = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    for (; i < count; ++i) {
+        result.min = std::min(result.min, values[i]);
+        result.max = std::max(result.max, values[i]);
+    }
+    return result;
+}
+
+__attribute__((target("avx2")))
+double sumAvx2(const double* values, size_t count) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(values + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(values + i + 4));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    double total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+__attribute__((target("avx2")))
+uint64_t rangeWordAvx2(const double* values, size_t count,
+                       double lower, double upper) {
+    __m256d lo = _mm256_set1_pd(lower);
+    __m256d hi = _mm256_set1_pd(upper);
+    uint64_t word = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d v = _mm256_loadu_pd(values + i);
+        __m256d in = _mm256_and_pd(_mm256_cmp_pd(v, lo, _CMP_GE_OQ),
+                                   _mm256_cmp_pd(v, hi, _CMP_LE_OQ));
+        word |= static_cast<uint64_t>(_mm256_movemask_pd(in)) << i;
+    }
+    if (i < count) {
+        word |= rangeWordScalar(values + i, count - i, lower, upper) << i;
+    }
+    return word;
+}
+
+__attribute__((target("avx2")))
+void normalizeAvx2(double* values, size_t count, double offset, double scale) {
+    __m256d off = _mm256_set1_pd(offset);
+    __m256d sc = _mm256_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d v = _mm256_loadu_pd(values + i);
+        _mm256_storeu_pd(values + i, _mm256_div_pd(_mm256_sub_pd(v, off), sc));
+    }
+    normalizeScalar(values + i, count - i, offset, scale);
+}
+
+#endif  // SENSOR_HAVE_X86_KERNELS
+
+struct KernelTable {
+    Isa isa;
+    MinMax (*minMax)(const double*, size_t);
+    double (*sum)(const double*, size_t);
+    uint64_t (*rangeWord)(const double*, size_t, double, double);
+    void (*normalize)(double*, size_t, double, double);
+};
+
+const KernelTable kScalarTable = {
+    Isa::SCALAR, minMaxScalar, sumScalar, rangeWordScalar, normalizeScalar
+};
+
+#ifdef SENSOR_HAVE_X86_KERNELS
+const KernelTable kSse2Table = {
+    Isa::SSE2, minMaxSse2, sumSse2, rangeWordSse2, normalizeSse2
+};
+const KernelTable kAvx2Table = {
+    Isa::AVX2, minMaxAvx2, sumAvx2, rangeWordAvx2, normalizeAvx2
+};
+#endif
+
+bool isaSupported(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR:
+            return true;
+#ifdef SENSOR_HAVE_X86_KERNELS
+        case Isa::SSE2:
+            return true;
+        case Isa::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+const KernelTable* tableFor(Isa isa) {
+    switch (isa) {
+#ifdef SENSOR_HAVE_X86_KERNELS
+        case Isa::SSE2:
+            return &kSse2Table;
+        case Isa::AVX2:
+            return &kAvx2Table;
+#endif
+        default:
+            return &kScalarTable;
+    }
+}
+
+const KernelTable* detectBest() {
+    if (isaSupported(Isa::AVX2)) {
+        return tableFor(Isa::AVX2);
+    }
+    if (isaSupported(Isa::SSE2)) {
+        return tableFor(Isa::SSE2);
+    }
+    return &kScalarTable;
+}
+
+const KernelTable*& activeTable() {
+    static const KernelTable* table = detectBest();
+    return table;
+}
+
+}  // namespace
+
+Isa activeIsa() {
+    return activeTable()->isa;
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::SSE2: return "sse2";
+        case Isa::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+bool setIsa(Isa isa) {
+    if (!isaSupported(isa)) {
+        return false;
+    }
+    activeTable() = tableFor(isa);
+    return true;
+}
+
+MinMax minMax(const double* values, size_t count) {
+    // Seed from the first non-NaN value so every implementation skips NaN
+    size_t first = 0;
+    while (first + 1 < count && std::isnan(values[first])) {
+        ++first;
+    }
+    return activeTable()->minMax(values + first, count - first);
+}
+
+double sum(const double* values, size_t count) {
+    return activeTable()->sum(values, count);
+}
+
+size_t rangeMask(const double* values, size_t count,
+                 double lower, double upper, uint64_t* mask) {
+    auto rangeWord = activeTable()->rangeWord;
+    size_t selected = 0;
+    for (size_t base = 0; base < count; base += kWordBits) {
+        size_t rows = std::min(kWordBits, count - base);
+        uint64_t word = rangeWord(values + base, rows, lower, upper);
+        mask[base / kWordBits] = word;
+        selected += popcount(word);
+    }
+    return selected;
+}
+
+size_t andMask(RowMask& mask, const RowMask& other) {
+    size_t selected = 0;
+    for (size_t w = 0; w < mask.size(); ++w) {
+        mask[w] &= other[w];
+        selected += popcount(mask[w]);
+    }
+    return selected;
+}
+
+void normalize(double* values, size_t count, double offset, double scale) {
+    activeTable()->normalize(values, count, offset, scale);
+}
+
+}  // namespace ValueKernels
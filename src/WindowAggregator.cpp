@@ -0,0 +1,246 @@
+#include "WindowAggregator.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+const int64_t kUnsetWindow = std::numeric_limits<int64_t>::min();
+
+}  // namespace
+
+struct WindowAggregator::GroupState {
+    GroupKey key;
+    std::map<int64_t, Pane> panes;   // Pane index -> pane, for panes not yet evicted
+    std::vector<StackEntry> front;   // Oldest entry at back()
+    std::vector<StackEntry> back;    // Newest entry at back()
+    Aggregate backAggregate;
+    size_t windowCount;              // Readings in the queued panes
+    int64_t pushedUpTo;              // Panes below this are sealed (queued or evicted)
+    int64_t nextWindow;              // Index of the next window to emit
+
+    GroupState()
+        : backAggregate(WindowAggregator::identity()), windowCount(0),
+          pushedUpTo(std::numeric_limits<int64_t>::min()), nextWindow(kUnsetWindow) {}
+
+    bool queueEmpty() const { return front.empty() && back.empty(); }
+
+    int64_t oldestPane() const {
+        return front.empty() ? back.front().pane : front.back().pane;
+    }
+
+    void push(int64_t pane, const Pane& data) {
+        StackEntry entry{pane, data.count, data.aggregate, data.aggregate};
+        back.push_back(entry);
+        backAggregate = WindowAggregator::combine(backAggregate, data.aggregate);
+        windowCount += data.count;
+    }
+
+    void popOldest() {
+        if (front.empty()) {
+            // Reverse the back stack into the front, recording suffix aggregates
+            for (auto it = back.rbegin(); it != back.rend(); ++it) {
+                it->suffix = front.empty()
+                    ? it->aggregate
+                    : WindowAggregator::combine(it->aggregate, front.back().suffix);
+                front.push_back(*it);
+            }
+            back.clear();
+            backAggregate = WindowAggregator::identity();
+        }
+        windowCount -= front.back().count;  // Subtract on evict
+        front.pop_back();
+    }
+
+    Aggregate query() const {
+        return front.empty() ? backAggregate
+                             : WindowAggregator::combine(front.back().suffix, backAggregate);
+    }
+};
+
+WindowAggregator::WindowAggregator(int64_t sizeMs, int64_t slideMs,
+                                   GroupBy groupBy, int64_t allowedLatenessMs)
+    : sizeMs_(sizeMs), slideMs_(slideMs), paneMs_(0), groupBy_(groupBy),
+      allowedLatenessMs_(std::max<int64_t>(0, allowedLatenessMs)),
+      maxTimestamp_(0), seenAny_(false), lateCount_(0) {
+    if (sizeMs <= 0 || slideMs <= 0 || slideMs > sizeMs) {
+        throw std::invalid_argument("Window slide must be positive and no larger than the window");
+    }
+    paneMs_ = std::gcd(sizeMs, slideMs);
+}
+
+WindowAggregator::~WindowAggregator() = default;
+
+WindowAggregator::Aggregate WindowAggregator::identity() {
+    return Aggregate{0.0, std::numeric_limits<double>::infinity(),
+                     -std::numeric_limits<double>::infinity()};
+}
+
+WindowAggregator::Aggregate WindowAggregator::combine(const Aggregate& a, const Aggregate& b) {
+    return Aggregate{a.sum + b.sum, std::min(a.min, b.min), std::max(a.max, b.max)};
+}
+
+int64_t WindowAggregator::floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b < 0) ? q - 1 : q;
+}
+
+int64_t WindowAggregator::firstWindowContaining(int64_t timestamp) const {
+    return floorDiv(timestamp - sizeMs_, slideMs_) + 1;
+}
+
+WindowAggregator::GroupState& WindowAggregator::groupFor(SensorReading::SensorKey sensorKey,
+                                                         SensorReading::SensorType type) {
+    size_t id = 0;
+    switch (groupBy_) {
+        case GroupBy::TYPE:
+            id = static_cast<size_t>(type);
+            break;
+        case GroupBy::SENSOR:
+            id = sensorKey;
+            break;
+        case GroupBy::TYPE_AND_SENSOR:
+            id = static_cast<size_t>(sensorKey) * SensorReading::kTypeCount + static_cast<size_t>(type);
+            break;
+        case GroupBy::TIME_BUCKET:
+            id = 0;
+            break;
+    }
+    if (id >= groups_.size()) {
+        groups_.resize(id + 1);
+    }
+    if (!groups_[id]) {
+        groups_[id] = std::make_unique<GroupState>();
+        if (groupBy_ == GroupBy::TYPE || groupBy_ == GroupBy::TYPE_AND_SENSOR) {
+            groups_[id]->key.type = type;
+        }
+        if (groupBy_ == GroupBy::SENSOR || groupBy_ == GroupBy::TYPE_AND_SENSOR) {
+            groups_[id]->key.sensorKey = sensorKey;
+        }
+    }
+    return *groups_[id];
+}
+
+void WindowAggregator::add(const ReadingBatch& batch) {
+    const auto& values = batch.values();
+    const auto& timestamps = batch.timestamps();
+    const auto& types = batch.types();
+    const auto& keys = batch.sensorKeys();
+    for (size_t row = 0; row < batch.size(); ++row) {
+        add(keys[row], types[row], values[row], timestamps[row]);
+    }
+}
+
+void WindowAggregator::add(SensorReading::SensorKey sensorKey, SensorReading::SensorType type,
+                           double value, int64_t timestamp) {
+    GroupState& group = groupFor(sensorKey, type);
+    int64_t paneIndex = floorDiv(timestamp, paneMs_);
+    if (paneIndex < group.pushedUpTo) {
+        ++lateCount_;
+        return;
+    }
+
+    Pane& pane = group.panes[paneIndex];
+    if (pane.count == 0) {
+        pane.aggregate = identity();
+    }
+    pane.aggregate = combine(pane.aggregate, Aggregate{value, value, value});
+    pane.values.push_back(value);
+    ++pane.count;
+
+    maxTimestamp_ = seenAny_ ? std::max(maxTimestamp_, timestamp) : timestamp;
+    seenAny_ = true;
+}
+
+void WindowAggregator::emitClosed(GroupState& group, int64_t limit,
+                                  std::vector<WindowStatistics>& out) {
+    const int64_t panesPerWindow = sizeMs_ / paneMs_;
+    const int64_t panesPerSlide = slideMs_ / paneMs_;
+    std::vector<double> scratch;
+
+    while (true) {
+        if (group.queueEmpty()) {
+            // Nothing queued: skip straight to the first window of the next pending pane
+            auto pending = group.panes.lower_bound(group.pushedUpTo);
+            if (pending == group.panes.end()) {
+                break;
+            }
+            int64_t first = firstWindowContaining(pending->first * paneMs_);
+            group.nextWindow = std::max(group.nextWindow, first);
+        }
+
+        int64_t start = group.nextWindow * slideMs_;
+        if (start > limit - sizeMs_) {
+            break;  // Window still open
+        }
+        int64_t firstPane = group.nextWindow * panesPerSlide;
+        int64_t endPane = firstPane + panesPerWindow;
+
+        // Queue the panes entering the window, then evict those that left it
+        for (auto it = group.panes.lower_bound(group.pushedUpTo);
+             it != group.panes.end() && it->first < endPane; ++it) {
+            group.push(it->first, it->second);
+        }
+        group.pushedUpTo = std::max(group.pushedUpTo, endPane);
+        while (!group.queueEmpty() && group.oldestPane() < firstPane) {
+            group.panes.erase(group.oldestPane());
+            group.popOldest();
+        }
+
+        if (group.windowCount > 0) {
+            Aggregate aggregate = group.query();
+            WindowStatistics window;
+            window.key = group.key;
+            window.key.bucketStart = start;
+            window.windowStart = start;
+            window.windowEnd = start + sizeMs_;
+            window.stats.count = group.windowCount;
+            window.stats.min = aggregate.min;
+            window.stats.max = aggregate.max;
+            window.stats.mean = aggregate.sum / group.windowCount;
+
+            scratch.clear();
+            for (auto it = group.panes.lower_bound(firstPane);
+                 it != group.panes.end() && it->first < endPane; ++it) {
+                scratch.insert(scratch.end(), it->second.values.begin(), it->second.values.end());
+            }
+            window.stats.median = SensorDataProcessor::calculateMedian(
+                scratch.data(), scratch.data() + scratch.size());
+            out.push_back(window);
+        }
+        ++group.nextWindow;
+    }
+}
+
+std::vector<WindowStatistics> WindowAggregator::emitAll(int64_t limit) {
+    std::vector<WindowStatistics> out;
+    for (auto& group : groups_) {
+        if (group) {
+            emitClosed(*group, limit, out);
+        }
+    }
+    std::sort(out.begin(), out.end(), [](const WindowStatistics& a, const WindowStatistics& b) {
+        if (a.windowStart != b.windowStart) {
+            return a.windowStart < b.windowStart;
+        }
+        if (a.key.sensorKey != b.key.sensorKey) {
+            return a.key.sensorKey < b.key.sensorKey;
+        }
+        return a.key.type < b.key.type;
+    });
+    return out;
+}
+
+std::vector<WindowStatistics> WindowAggregator::takeClosed() {
+    if (!seenAny_) {
+        return {};
+    }
+    // The watermark bounds how far back future readings may land
+    int64_t watermark = maxTimestamp_ - allowedLatenessMs_;
+    return emitAll(watermark);
+}
+
+std::vector<WindowStatistics> WindowAggregator::flush() {
+    return emitAll(std::numeric_limits<int64_t>::max());
+}
@@ -1,10 +1,31 @@
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
+#include <map>
+#include <utility>
+#include <memory>
+#include <limits>
+#include <chrono>
+#include <thread>
 #include "SensorReading.h"
+#include "ReadingBatch.h"
 #include "SensorDataProcessor.h"
+#include "StreamingSelector.h"
+#include "StreamingStatistics.h"
+#include "StatisticsAccumulator.h"
+#include "LiveIngester.h"
+#include "WindowAggregator.h"
+#include "TimeIndexedStore.h"
+#include "ProcessingArena.h"
+#include "Profiler.h"
 #include "DataIngester.h"
+#include "MappedFile.h"
+#include "CsvWriter.h"
+#include "DataGenerator.h"
+#include <random>
 
 /**
  * @brief Print usage information
@@ -14,13 +35,97 @@ void printUsage(const char* programName) {
               << "Options:\n"
               << "  -f, --file <path>     Read sensor data from CSV file\n"
               << "  -g, --generate <num>   Generate <num> simulated sensor readings\n"
+              << "      --seed <num>       Seed for -g, so generated data is reproducible (default: random)\n"
+              << "      --sensors <num>    Sensors for -g (default 4)\n"
               << "  -o, --output <path>    Write processed results to file\n"
               << "  -s, --stats            Show detailed statistics\n"
+              << "      --convert          Write the input to -o unprocessed (format chosen by extension)\n"
+              << "      --mmap             Memory-map the input file instead of streaming it\n"
+              << "      --threads <num>    Parse and process with <num> threads, 0 = all cores (CSV input implies --mmap)\n"
+              << "      --stream           Process the input file in bounded-memory batches\n"
+              << "      --memory-limit <MB> Memory budget for batches and exact selection in --stream mode (default 256)\n"
+              << "      --outlier-method <m> Outlier fences: iqr (default), mad or rolling-iqr\n"
+              << "      --outlier-group <g> Fences per: none (default), type, sensor or type-sensor\n"
+              << "      --outlier-window <n> Rows per rolling-iqr window (default 64)\n"
+              << "      --from <ms>        Keep only readings at or after timestamp <ms>\n"
+              << "      --to <ms>          Keep only readings before timestamp <ms>\n"
+              << "      --window <ms>      Print statistics per sensor and type for windows of <ms>\n"
+              << "      --hop <ms>         Start a window every <ms> (default: --window, i.e. tumbling)\n"
+              << "      --live             Read readings continuously from stdin (or the -f pipe) and keep running statistics\n"
+              << "      --live-interval <ms> Print running statistics every <ms> in --live mode (default 1000)\n"
+              << "      --approx <eps>     Estimate medians and percentiles with mergeable sketches (rank error <eps>, e.g. 0.01)\n"
+              << "      --percentiles <list> Print estimated percentiles, e.g. 50,90,99 (requires --approx)\n"
+              << "      --sketch-out <path> Save the --approx sketches so other runs can merge them\n"
+              << "      --sketch-merge <path> Merge sketches saved by another run (repeatable; -f/-g optional)\n"
+              << "      --profile          Print per-stage times, row/byte counters, allocations and peak RSS\n"
+              << "      --profile-json <path> Write the --profile report as JSON to <path>\n"
               << "  -h, --help             Show this help message\n"
               << "\n"
               << "Examples:\n"
               << "  " << programName << " -f data/sensor_data.csv -s\n"
-              << "  " << programName << " -g 1000 -o output.csv -s\n";
+              << "  " << programName << " -g 1000 -o output.csv -s\n"
+              << "  " << programName << " -f day.csv -o day.sdb --convert\n"
+              << "  " << programName << " -f day.sdb -o day.sdc --convert\n"
+              << "  " << programName << " -g 1000000000 --seed 7 --sensors 500 -o load.sdb --convert\n"
+              << "  gateway-feed | " << programName << " --live --window 60000\n"
+              << "  " << programName << " -f node1.csv --stream --approx 0.01 --sketch-out node1.sqs\n"
+              << "  " << programName << " --approx 0.01 --sketch-merge node1.sqs --sketch-merge node2.sqs -s --percentiles 50,99\n"
+              << "\n"
+              << "Files ending in .sdb are read and written in the binary columnar archive format,\n"
+              << "files ending in .sdc in the compressed per-sensor time-series format.\n";
+}
+
+/**
+ * @brief Emits the profiling report when the run ends, on every return path
+ */
+class ProfileReport {
+public:
+    ProfileReport(bool printTable, const std::string& jsonPath)
+        : printTable_(printTable), jsonPath_(jsonPath) {}
+
+    ~ProfileReport() {
+        if (printTable_) {
+            Profiler::instance().writeTable(std::cout);
+        }
+        if (!jsonPath_.empty()) {
+            std::ofstream json(jsonPath_);
+            if (json.is_open()) {
+                Profiler::instance().writeJson(json);
+            } else {
+                std::cerr << "Error: Cannot write profile to " << jsonPath_ << "\n";
+            }
+        }
+    }
+
+    ProfileReport(const ProfileReport&) = delete;
+    ProfileReport& operator=(const ProfileReport&) = delete;
+
+private:
+    bool printTable_;
+    std::string jsonPath_;
+};
+
+/**
+ * @brief Check whether a path names a .sdb or .sdc archive rather than CSV
+ */
+bool isArchive(const std::string& path) {
+    return DataIngester::formatOf(path) != DataIngester::FileFormat::CSV;
+}
+
+/**
+ * @brief Write readings as CSV, .sdb or .sdc according to the output extension
+ */
+bool writeReadings(DataIngester& ingester, const ReadingBatch& readings,
+                   const std::string& outputFile, size_t threadCount) {
+    switch (DataIngester::formatOf(outputFile)) {
+        case DataIngester::FileFormat::BINARY_ARCHIVE:
+            return ingester.writeBinaryFile(readings, outputFile);
+        case DataIngester::FileFormat::COMPRESSED_ARCHIVE:
+            return ingester.writeCompressedFile(readings, outputFile);
+        case DataIngester::FileFormat::CSV:
+            break;
+    }
+    return ingester.writeToFile(readings, outputFile, threadCount);
 }
 
 /**
@@ -47,11 +152,469 @@ void printStatistics(const SensorStatistics& stats, const std::string& label = "
               << "  Median: " << stats.median << "\n";
 }
 
+/**
+ * @brief Print overall, per-type and per-sensor statistics
+ */
+void printAllStatistics(const SensorStatistics& overallStats,
+                        const std::map<SensorReading::SensorType, SensorStatistics>& statsByType,
+                        const std::map<std::string, SensorStatistics>& statsBySensor) {
+    printStatistics(overallStats, "Overall Statistics");
+
+    // Statistics by type
+    if (!statsByType.empty()) {
+        std::cout << "\nStatistics by Sensor Type:\n";
+        for (const auto& pair : statsByType) {
+            std::string typeStr = SensorReading::typeToString(pair.first);
+            printStatistics(pair.second, typeStr);
+        }
+    }
+
+    // Statistics by sensor ID
+    if (!statsBySensor.empty()) {
+        std::cout << "\nStatistics by Sensor ID:\n";
+        for (const auto& pair : statsBySensor) {
+            printStatistics(pair.second, pair.first);
+        }
+    }
+}
+
+/**
+ * @brief Print the statistics of each closed time window, one line per window
+ */
+void printWindows(const std::vector<WindowStatistics>& windows) {
+    for (const auto& window : windows) {
+        std::cout << std::fixed << std::setprecision(2)
+                  << "[" << window.windowStart << ", " << window.windowEnd << ") "
+                  << SensorIdTable::global().resolve(window.key.sensorKey) << " "
+                  << std::setw(15) << std::left << SensorReading::typeToString(window.key.type)
+                  << std::right
+                  << " Count: " << window.stats.count
+                  << " Min: " << window.stats.min
+                  << " Max: " << window.stats.max
+                  << " Mean: " << window.stats.mean
+                  << " Median: " << window.stats.median << "\n";
+    }
+}
+
+/**
+ * @brief Options of the approximate (sketch-based) statistics mode
+ */
+struct ApproxOptions {
+    uint32_t sketchK;                         // Quantile sketch size, 0 = exact statistics
+    std::vector<double> percentiles;          // In percent
+    std::string sketchOutPath;
+    std::vector<std::string> sketchMergePaths;
+
+    ApproxOptions() : sketchK(0) {}
+};
+
+/**
+ * @brief Print estimated percentiles overall, per type and per sensor, one line each
+ */
+void printPercentiles(const StreamingStatistics& stats, const std::vector<double>& percentiles) {
+    std::vector<double> quantiles;
+    for (double percentile : percentiles) {
+        quantiles.push_back(percentile / 100.0);
+    }
+    auto printLine = [&](const std::string& label, const StatisticsAccumulator& summary) {
+        std::vector<double> values = summary.sketch().quantiles(quantiles);
+        std::cout << "  " << std::setw(15) << std::left << label << std::right;
+        for (size_t i = 0; i < values.size(); ++i) {
+            std::ostringstream name;
+            name << "P" << percentiles[i];
+            std::cout << " " << name.str() << ": " << std::fixed << std::setprecision(2) << values[i];
+        }
+        std::cout << "\n";
+    };
+
+    std::cout << "\nEstimated Percentiles:\n";
+    printLine("ALL", stats.overallSummary());
+    for (const auto& pair : stats.byTypeSummary()) {
+        printLine(SensorReading::typeToString(pair.first), pair.second);
+    }
+    for (const auto& pair : stats.bySensorIdSummary()) {
+        printLine(pair.first, pair.second);
+    }
+}
+
+/**
+ * @brief Merge sketch files, then print and save approximate statistics
+ * @return 0 on success, 1 if a sketch file could not be read or written
+ */
+int reportApproximateStatistics(StreamingStatistics& stats, bool showStats,
+                                const ApproxOptions& approx) {
+    for (const auto& path : approx.sketchMergePaths) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            std::cerr << "Error: Cannot open sketch file: " << path << "\n";
+            return 1;
+        }
+        stats.mergeSketches(in);
+        std::cout << "Merged sketches from: " << path << "\n";
+    }
+
+    if (showStats) {
+        std::cout << "\n(Medians are sketch estimates, rank error about " << std::fixed
+                  << std::setprecision(2) << QuantileSketch(approx.sketchK).rankError() * 100.0
+                  << "%)\n";
+        printAllStatistics(stats.overall(), stats.byType(), stats.bySensorId());
+    }
+    if (!approx.percentiles.empty()) {
+        printPercentiles(stats, approx.percentiles);
+    }
+
+    if (!approx.sketchOutPath.empty()) {
+        std::ofstream out(approx.sketchOutPath, std::ios::binary);
+        if (out.is_open()) {
+            stats.writeSketches(out);
+        }
+        if (!out.is_open() || !out) {
+            std::cerr << "Error: Failed to write sketch file\n";
+            return 1;
+        }
+        std::cout << "\nSketches written to: " << approx.sketchOutPath << "\n";
+    }
+    return 0;
+}
+
+/**
+ * @brief Run the ingest -> process -> output pipeline in bounded-memory batches
+ *
+ * Pass 1 streams the file once to count the valid readings of each outlier
+ * group. The fences' quartiles (or medians and MADs) are then selected
+ * exactly by re-reading the file a few more times (see StreamingSelector);
+ * the last pass filters each batch against the fences, writes survivors as
+ * it goes and folds them into the statistics. Exact medians for -s re-read
+ * and re-filter the file once more per selection pass. Half of the memory
+ * limit sizes the batches, the other half bounds the selection state, so
+ * memory does not grow with the file; a limit too small for the number of
+ * groups is an error. In approximate mode the statistics keep quantile
+ * sketches instead and need no extra passes.
+ * With a window size, survivors also feed a WindowAggregator whose windows are
+ * printed as soon as the stream has moved past them.
+ */
+int runStreamingPipeline(const std::string& inputFile, const std::string& outputFile,
+                         bool showStats, size_t memoryLimitMB, size_t threadCount,
+                         const OutlierOptions& outlierOptions,
+                         int64_t windowMs, int64_t hopMs, const ApproxOptions& approx) {
+    // Approximate bytes per in-flight row: input batch plus surviving batch
+    const size_t bytesPerBatchRow = 64;
+    const size_t memoryLimitBytes = memoryLimitMB * 1024 * 1024;
+    const size_t selectionBytes = memoryLimitBytes / 2;
+    const size_t batchRows = std::max<size_t>(1024, (memoryLimitBytes - selectionBytes) / bytesPerBatchRow);
+
+    DataIngester ingester;
+    SensorDataProcessor processor;
+    processor.setThreadCount(threadCount);
+    processor.setOutlierOptions(outlierOptions);
+
+    std::cout << "Streaming sensor data from: " << inputFile
+              << " (" << batchRows << " readings per batch)\n";
+
+    // Pass 1: valid readings per outlier group
+    const OutlierGrouping grouping = outlierOptions.grouping;
+    std::vector<size_t> groupCounts;
+    ingester.streamFromFile(inputFile, batchRows, [&](const ReadingBatch& batch) {
+        for (size_t row = 0; row < batch.size(); ++row) {
+            if (batch.isValid(row)) {
+                size_t group = SensorDataProcessor::outlierGroupOf(
+                    grouping, batch.types()[row], batch.sensorKeys()[row]);
+                if (group >= groupCounts.size()) {
+                    groupCounts.resize(group + 1, 0);
+                }
+                ++groupCounts[group];
+            }
+        }
+    });
+    size_t loaded = ingester.getLastIngestStats().rowsAccepted;
+    std::cout << "Scanned " << loaded << " sensor readings";
+    size_t rejected = ingester.getLastIngestStats().rowsRejected;
+    if (rejected > 0) {
+        std::cout << " (rejected " << rejected << " malformed/invalid rows)";
+    }
+    std::cout << "\n";
+
+    if (loaded == 0) {
+        std::cerr << "Error: No sensor readings to process\n";
+        return 1;
+    }
+
+    // Fences selected by re-reading the valid values of each group
+    std::vector<OutlierBounds> bounds = processor.calculateOutlierBounds(
+        [&](const StreamingSelector::Sink& sink) {
+            ingester.streamFromFile(inputFile, batchRows, [&](const ReadingBatch& batch) {
+                for (size_t row = 0; row < batch.size(); ++row) {
+                    if (batch.isValid(row)) {
+                        sink(SensorDataProcessor::outlierGroupOf(
+                                 grouping, batch.types()[row], batch.sensorKeys()[row]),
+                             batch.values()[row]);
+                    }
+                }
+            });
+        },
+        groupCounts, selectionBytes);
+
+    // Pass 2: filter, write and accumulate batch by batch
+    std::cout << "\nProcessing sensor data...\n";
+    std::ofstream output;
+    CsvWriter csv(output);
+    if (!outputFile.empty()) {
+        output.open(outputFile);
+        if (!output.is_open()) {
+            std::cerr << "Error: Failed to write output file\n";
+            return 1;
+        }
+        CsvWriter::writeHeader(output);
+        csv.setThreadCount(threadCount);
+    }
+
+    StreamingStatistics stats(approx.sketchK);
+    bool collectStats = showStats || approx.sketchK > 0;
+    std::unique_ptr<WindowAggregator> windows;
+    if (windowMs > 0) {
+        windows = std::make_unique<WindowAggregator>(windowMs, hopMs);
+        std::cout << "\nWindowed Statistics:\n";
+    }
+    ReadingBatch sample;
+    size_t processedCount = 0;
+    bool writeOk = true;
+    ingester.streamFromFile(inputFile, batchRows, [&](const ReadingBatch& batch) {
+        ReadingBatch survivors = processor.process(batch, bounds, grouping);
+        processedCount += survivors.size();
+        if (output.is_open()) {
+            writeOk = csv.write(survivors) && writeOk;
+        }
+        if (collectStats) {
+            stats.add(survivors);
+        }
+        if (windows) {
+            windows->add(survivors);
+            printWindows(windows->takeClosed());
+        }
+        for (size_t row = 0; row < survivors.size() && sample.size() < 10; ++row) {
+            sample.appendRow(survivors, row);
+        }
+    });
+    if (windows) {
+        printWindows(windows->flush());
+        if (windows->lateCount() > 0) {
+            std::cout << "(" << windows->lateCount() << " readings arrived after their window closed)\n";
+        }
+    }
+    std::cout << "Processed " << processedCount << " readings "
+              << "(removed " << (loaded - processedCount) << " outliers/invalid)\n";
+
+    if (approx.sketchK > 0) {
+        if (reportApproximateStatistics(stats, showStats, approx) != 0) {
+            return 1;
+        }
+    } else if (showStats) {
+        size_t passes = stats.resolveMedians([&](const StreamingStatistics::BatchSink& sink) {
+            ingester.streamFromFile(inputFile, batchRows, [&](const ReadingBatch& batch) {
+                sink(processor.process(batch, bounds, grouping));
+            });
+        }, selectionBytes);
+        std::cout << "Exact medians selected in " << passes << " more passes over the input\n";
+        printAllStatistics(stats.overall(), stats.byType(), stats.bySensorId());
+    }
+
+    if (output.is_open()) {
+        output.close();
+        if (!writeOk || !output) {
+            std::cerr << "Error: Failed to write output file\n";
+            return 1;
+        }
+        std::cout << "\nProcessed data written to: " << outputFile << "\n";
+    } else {
+        std::cout << "\nSample processed readings (first 10):\n";
+        for (size_t i = 0; i < sample.size(); ++i) {
+            printReading(sample.at(i));
+        }
+        if (processedCount > sample.size()) {
+            std::cout << "... (" << (processedCount - sample.size()) << " more readings)\n";
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Print one line of running statistics
+ */
+void printRunningStatistics(const std::string& label, const StatisticsAccumulator& stats) {
+    std::cout << std::fixed << std::setprecision(2)
+              << "  " << std::setw(15) << std::left << label << std::right
+              << " Count: " << stats.count()
+              << " Min: " << stats.min()
+              << " Max: " << stats.max()
+              << " Mean: " << stats.mean()
+              << " Median~: " << stats.median() << "\n";
+}
+
+/**
+ * @brief Ingest a live stream of readings and keep running statistics up to date
+ *
+ * A LiveIngester thread reads and parses the input and hands readings over
+ * through a lock-free ring; this thread drains at most a few thousand at a
+ * time, folds them into StatisticsAccumulators (O(1) per reading, no stored
+ * values) and prints a snapshot every @p intervalMs, flushed so a downstream
+ * pipe sees it immediately. A reading is therefore reflected in the output
+ * within one interval plus one poll. Outlier fences need the whole dataset,
+ * so live mode reports every valid reading.
+ */
+int runLivePipeline(const std::string& inputFile, const std::string& outputFile,
+                    bool showStats, int64_t intervalMs, int64_t windowMs, int64_t hopMs,
+                    uint32_t sketchK) {
+    const size_t kLivePollRows = 4096;  // Bounds the work between two snapshot checks
+
+    std::ifstream file;
+    if (!inputFile.empty()) {
+        file.open(inputFile);  // Blocks until a named pipe has a writer
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open file: " << inputFile << "\n";
+            return 1;
+        }
+    }
+    std::istream& input = inputFile.empty() ? std::cin : file;
+
+    std::ofstream output;
+    CsvWriter csv(output);
+    if (!outputFile.empty()) {
+        output.open(outputFile);
+        if (!output.is_open()) {
+            std::cerr << "Error: Failed to write output file\n";
+            return 1;
+        }
+        CsvWriter::writeHeader(output);
+    }
+
+    std::cout << "Live ingestion from: " << (inputFile.empty() ? "stdin" : inputFile) << "\n";
+    std::unique_ptr<WindowAggregator> windows;
+    if (windowMs > 0) {
+        windows = std::make_unique<WindowAggregator>(windowMs, hopMs);
+    }
+
+    StatisticsAccumulator overall(sketchK);
+    std::vector<StatisticsAccumulator> byType(SensorReading::kTypeCount, StatisticsAccumulator(sketchK));
+    std::vector<StatisticsAccumulator> bySensor;  // Indexed by sensor key
+    ReadingBatch batch;
+    batch.reserve(kLivePollRows);
+    bool writeOk = true;
+
+    const auto interval = std::chrono::milliseconds(std::max<int64_t>(1, intervalMs));
+    const auto started = std::chrono::steady_clock::now();
+    auto nextReport = started + interval;
+    LiveIngester live(input);
+    while (true) {
+        batch.clear();
+        if (live.poll(batch, kLivePollRows) > 0) {
+            const auto& values = batch.values();
+            const auto& types = batch.types();
+            const auto& keys = batch.sensorKeys();
+            for (size_t row = 0; row < batch.size(); ++row) {
+                overall.add(values[row]);
+                byType[static_cast<size_t>(types[row])].add(values[row]);
+                if (keys[row] >= bySensor.size()) {
+                    bySensor.resize(keys[row] + 1, StatisticsAccumulator(sketchK));
+                }
+                bySensor[keys[row]].add(values[row]);
+            }
+            if (output.is_open()) {
+                writeOk = csv.write(batch) && writeOk;
+            }
+            if (windows) {
+                windows->add(batch);
+                printWindows(windows->takeClosed());
+            }
+        } else if (live.finished()) {
+            break;
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));  // Wait for the reader
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= nextReport) {
+            double seconds = std::chrono::duration<double>(now - started).count();
+            std::cout << "\n[live " << std::fixed << std::setprecision(1) << seconds << "s] "
+                      << overall.count() << " readings, " << live.rowsRejected() << " rejected\n";
+            printRunningStatistics("ALL", overall);
+            for (size_t type = 0; type < SensorReading::kTypeCount; ++type) {
+                if (byType[type].count() > 0) {
+                    printRunningStatistics(
+                        SensorReading::typeToString(static_cast<SensorReading::SensorType>(type)),
+                        byType[type]);
+                }
+            }
+            std::cout << std::flush;
+            nextReport = now + interval;
+        }
+    }
+
+    if (windows) {
+        printWindows(windows->flush());
+        if (windows->lateCount() > 0) {
+            std::cout << "(" << windows->lateCount() << " readings arrived after their window closed)\n";
+        }
+    }
+    std::cout << "\nInput ended after " << live.rowsAccepted() << " readings";
+    if (live.rowsRejected() > 0) {
+        std::cout << " (rejected " << live.rowsRejected() << " malformed/invalid rows)";
+    }
+    std::cout << "\n";
+
+    if (showStats && overall.count() > 0) {
+        std::map<SensorReading::SensorType, SensorStatistics> statsByType;
+        for (size_t type = 0; type < SensorReading::kTypeCount; ++type) {
+            if (byType[type].count() > 0) {
+                statsByType[static_cast<SensorReading::SensorType>(type)] = byType[type].toStatistics();
+            }
+        }
+        std::map<std::string, SensorStatistics> statsBySensor;
+        for (size_t key = 0; key < bySensor.size(); ++key) {
+            if (bySensor[key].count() > 0) {
+                statsBySensor[SensorIdTable::global().resolve(
+                    static_cast<SensorReading::SensorKey>(key))] = bySensor[key].toStatistics();
+            }
+        }
+        std::cout << "\n(Medians are streaming estimates)\n";
+        printAllStatistics(overall.toStatistics(), statsByType, statsBySensor);
+    }
+
+    if (output.is_open()) {
+        output.close();
+        if (!writeOk || !output) {
+            std::cerr << "Error: Failed to write output file\n";
+            return 1;
+        }
+        std::cout << "\nReceived data written to: " << outputFile << "\n";
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     std::string inputFile;
     std::string outputFile;
-    size_t generateCount = 0;
+    uint64_t generateCount = 0;
+    GeneratorOptions generatorOptions;
+    bool seedGiven = false;
     bool showStats = false;
+    bool useMmap = false;
+    size_t threadCount = 1;
+    bool streamMode = false;
+    bool convertOnly = false;
+    size_t memoryLimitMB = 256;
+    OutlierOptions outlierOptions;
+    int64_t windowMs = 0;
+    int64_t fromMs = std::numeric_limits<int64_t>::min();
+    int64_t toMs = std::numeric_limits<int64_t>::max();
+    bool rangeQuery = false;
+    int64_t hopMs = 0;
+    bool profileTable = false;
+    bool liveMode = false;
+    int64_t liveIntervalMs = 1000;
+    std::string profileJsonPath;
+    double approxError = 0.0;
+    ApproxOptions approx;
 
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
@@ -69,11 +632,26 @@ int main(int argc, char* argv[]) {
             }
         } else if (arg == "-g" || arg == "--generate") {
             if (i + 1 < argc) {
-                generateCount = std::stoul(argv[++i]);
+                generateCount = std::stoull(argv[++i]);
             } else {
                 std::cerr << "Error: -g requires a count\n";
                 return 1;
             }
+        } else if (arg == "--seed") {
+            if (i + 1 < argc) {
+                generatorOptions.seed = std::stoull(argv[++i]);
+                seedGiven = true;
+            } else {
+                std::cerr << "Error: --seed requires a number\n";
+                return 1;
+            }
+        } else if (arg == "--sensors") {
+            size_t sensors = (i + 1 < argc) ? std::stoul(argv[++i]) : 0;
+            if (sensors == 0) {
+                std::cerr << "Error: --sensors requires a positive count\n";
+                return 1;
+            }
+            generatorOptions.sensorCount = sensors;
         } else if (arg == "-o" || arg == "--output") {
             if (i + 1 < argc) {
                 outputFile = argv[++i];
@@ -83,6 +661,123 @@ int main(int argc, char* argv[]) {
             }
         } else if (arg == "-s" || arg == "--stats") {
             showStats = true;
+        } else if (arg == "--mmap") {
+            useMmap = true;
+        } else if (arg == "--threads") {
+            if (i + 1 < argc) {
+                threadCount = std::stoul(argv[++i]);
+            } else {
+                std::cerr << "Error: --threads requires a count\n";
+                return 1;
+            }
+        } else if (arg == "--convert") {
+            convertOnly = true;
+        } else if (arg == "--stream") {
+            streamMode = true;
+        } else if (arg == "--memory-limit") {
+            if (i + 1 < argc) {
+                memoryLimitMB = std::stoul(argv[++i]);
+            } else {
+                std::cerr << "Error: --memory-limit requires a size in MB\n";
+                return 1;
+            }
+        } else if (arg == "--outlier-method") {
+            std::string method = (i + 1 < argc) ? argv[++i] : "";
+            if (method == "iqr") {
+                outlierOptions.method = OutlierMethod::IQR;
+            } else if (method == "mad") {
+                outlierOptions.method = OutlierMethod::MAD;
+            } else if (method == "rolling-iqr") {
+                outlierOptions.method = OutlierMethod::ROLLING_IQR;
+            } else {
+                std::cerr << "Error: --outlier-method requires iqr, mad or rolling-iqr\n";
+                return 1;
+            }
+        } else if (arg == "--outlier-group") {
+            std::string grouping = (i + 1 < argc) ? argv[++i] : "";
+            if (grouping == "none") {
+                outlierOptions.grouping = OutlierGrouping::NONE;
+            } else if (grouping == "type") {
+                outlierOptions.grouping = OutlierGrouping::TYPE;
+            } else if (grouping == "sensor") {
+                outlierOptions.grouping = OutlierGrouping::SENSOR;
+            } else if (grouping == "type-sensor") {
+                outlierOptions.grouping = OutlierGrouping::TYPE_AND_SENSOR;
+            } else {
+                std::cerr << "Error: --outlier-group requires none, type, sensor or type-sensor\n";
+                return 1;
+            }
+        } else if (arg == "--from" || arg == "--to") {
+            if (i + 1 < argc) {
+                (arg == "--from" ? fromMs : toMs) = std::stoll(argv[++i]);
+                rangeQuery = true;
+            } else {
+                std::cerr << "Error: " << arg << " requires a timestamp in milliseconds\n";
+                return 1;
+            }
+        } else if (arg == "--window" || arg == "--hop") {
+            int64_t ms = (i + 1 < argc) ? std::stoll(argv[++i]) : 0;
+            if (ms <= 0) {
+                std::cerr << "Error: " << arg << " requires a positive number of milliseconds\n";
+                return 1;
+            }
+            (arg == "--window" ? windowMs : hopMs) = ms;
+        } else if (arg == "--live") {
+            liveMode = true;
+        } else if (arg == "--live-interval") {
+            liveIntervalMs = (i + 1 < argc) ? std::stoll(argv[++i]) : 0;
+            if (liveIntervalMs <= 0) {
+                std::cerr << "Error: --live-interval requires a positive number of milliseconds\n";
+                return 1;
+            }
+        } else if (arg == "--approx") {
+            approxError = (i + 1 < argc) ? std::stod(argv[++i]) : 0.0;
+            if (!(approxError > 0.0 && approxError < 0.5)) {
+                std::cerr << "Error: --approx requires a rank error between 0 and 0.5, e.g. 0.01\n";
+                return 1;
+            }
+        } else if (arg == "--percentiles") {
+            std::istringstream list((i + 1 < argc) ? argv[++i] : "");
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                double percentile = std::stod(item);
+                if (percentile < 0.0 || percentile > 100.0) {
+                    std::cerr << "Error: --percentiles values must lie between 0 and 100\n";
+                    return 1;
+                }
+                approx.percentiles.push_back(percentile);
+            }
+            if (approx.percentiles.empty()) {
+                std::cerr << "Error: --percentiles requires a comma-separated list, e.g. 50,90,99\n";
+                return 1;
+            }
+        } else if (arg == "--sketch-out" || arg == "--sketch-merge") {
+            if (i + 1 < argc) {
+                if (arg == "--sketch-out") {
+                    approx.sketchOutPath = argv[++i];
+                } else {
+                    approx.sketchMergePaths.push_back(argv[++i]);
+                }
+            } else {
+                std::cerr << "Error: " << arg << " requires a file path\n";
+                return 1;
+            }
+        } else if (arg == "--profile") {
+            profileTable = true;
+        } else if (arg == "--profile-json") {
+            if (i + 1 < argc) {
+                profileJsonPath = argv[++i];
+            } else {
+                std::cerr << "Error: --profile-json requires a file path\n";
+                return 1;
+            }
+        } else if (arg == "--outlier-window") {
+            if (i + 1 < argc) {
+                outlierOptions.window = std::stoul(argv[++i]);
+            } else {
+                std::cerr << "Error: --outlier-window requires a row count\n";
+                return 1;
+            }
         } else {
             std::cerr << "Unknown option: " << arg << "\n";
             printUsage(argv[0]);
@@ -90,74 +785,198 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (hopMs == 0) {
+        hopMs = windowMs;
+    }
+    if (windowMs > 0 && hopMs > windowMs) {
+        std::cerr << "Error: --hop must not exceed --window\n";
+        return 1;
+    }
+
+    if (approxError > 0.0) {
+        approx.sketchK = QuantileSketch::kForRankError(approxError);
+    } else if (!approx.percentiles.empty() || !approx.sketchOutPath.empty() ||
+               !approx.sketchMergePaths.empty()) {
+        std::cerr << "Error: --percentiles, --sketch-out and --sketch-merge require --approx\n";
+        return 1;
+    }
+
+    if ((profileTable || !profileJsonPath.empty()) && !Profiler::compiledIn()) {
+        std::cerr << "Note: built with ENABLE_PROFILING=OFF; the profile has no stage timings\n";
+    }
+    Profiler::instance().setEnabled(profileTable || !profileJsonPath.empty());
+    ProfileReport profileReport(profileTable, profileJsonPath);
+    PROFILE_SCOPE("run");
+
+    if (!seedGiven) {
+        generatorOptions.seed = (static_cast<uint64_t>(std::random_device()()) << 32) |
+                                std::random_device()();
+    }
+
+    if (liveMode) {
+        if (streamMode || convertOnly || rangeQuery || generateCount > 0 ||
+            isArchive(inputFile) || isArchive(outputFile)) {
+            std::cerr << "Error: --live reads CSV from stdin or -f and cannot be combined with "
+                      << "--stream, --convert, --from/--to, -g, .sdb or .sdc files\n";
+            return 1;
+        }
+        if (!approx.percentiles.empty() || !approx.sketchOutPath.empty() ||
+            !approx.sketchMergePaths.empty()) {
+            std::cerr << "Error: --live supports --approx but not --percentiles or sketch files\n";
+            return 1;
+        }
+        try {
+            return runLivePipeline(inputFile, outputFile, showStats, liveIntervalMs,
+                                   windowMs, hopMs,
+                                   approx.sketchK ? approx.sketchK : QuantileSketch::kDefaultK);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    if (streamMode) {
+        if (inputFile.empty() || isArchive(inputFile) || isArchive(outputFile)) {
+            std::cerr << "Error: --stream requires a CSV -f input and CSV output\n";
+            return 1;
+        }
+        if (outlierOptions.method == OutlierMethod::ROLLING_IQR) {
+            std::cerr << "Error: --stream supports only iqr and mad outlier methods\n";
+            return 1;
+        }
+        if (rangeQuery) {
+            std::cerr << "Error: --from and --to are not supported with --stream\n";
+            return 1;
+        }
+        try {
+            return runStreamingPipeline(inputFile, outputFile, showStats, memoryLimitMB,
+                                        threadCount, outlierOptions, windowMs, hopMs, approx);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
     DataIngester ingester;
     SensorDataProcessor processor;
-    std::vector<SensorReading> readings;
+    processor.setThreadCount(threadCount);
+    processor.setOutlierOptions(outlierOptions);
+    ReadingBatch readings;
 
     try {
         // Ingest data
         if (!inputFile.empty()) {
             std::cout << "Reading sensor data from: " << inputFile << "\n";
-            readings = ingester.readFromFile(inputFile);
-            std::cout << "Loaded " << readings.size() << " sensor readings\n";
+            DataIngester::FileFormat format = DataIngester::formatOf(inputFile);
+            if (format == DataIngester::FileFormat::BINARY_ARCHIVE) {
+                readings = ingester.readBinaryFile(inputFile);
+            } else if (format == DataIngester::FileFormat::COMPRESSED_ARCHIVE) {
+                readings = ingester.readCompressedFile(inputFile, threadCount);
+            } else if ((useMmap || threadCount != 1) && MappedFile::isRegularFile(inputFile)) {
+                readings = ingester.readBatchFromMappedFile(inputFile, threadCount);
+            } else {
+                // Also pipes, which cannot be mapped in place or split across threads
+                readings = ingester.readBatchFromFile(inputFile);
+            }
+            std::cout << "Loaded " << readings.size() << " sensor readings";
+            size_t rejected = ingester.getLastIngestStats().rowsRejected;
+            if (rejected > 0) {
+                std::cout << " (rejected " << rejected << " malformed/invalid rows)";
+            }
+            std::cout << "\n";
         } else if (generateCount > 0) {
-            std::cout << "Generating " << generateCount << " simulated sensor readings...\n";
-            std::vector<std::string> sensorIds = {
-                "SENSOR_001", "SENSOR_002", "SENSOR_003", "SENSOR_004"
-            };
-            std::vector<SensorReading::SensorType> types = {
-                SensorReading::SensorType::TEMPERATURE,
-                SensorReading::SensorType::PRESSURE,
-                SensorReading::SensorType::DEPTH,
-                SensorReading::SensorType::SONAR
-            };
-            readings = ingester.generateSimulatedData(generateCount, sensorIds, types);
+            DataGenerator generator(generatorOptions);
+            generator.setThreadCount(threadCount);
+            std::cout << "Generating " << generateCount << " simulated sensor readings from "
+                      << generatorOptions.sensorCount << " sensors (seed "
+                      << generatorOptions.seed << ")...\n";
+            if (convertOnly && !outputFile.empty() && !rangeQuery) {
+                // Straight to disk chunk by chunk, never holding the whole dataset
+                generator.writeFile(outputFile, generateCount);
+                std::cout << "Wrote " << generateCount << " readings to: " << outputFile << "\n";
+                return 0;
+            }
+            readings = generator.generate(static_cast<size_t>(generateCount));
             std::cout << "Generated " << readings.size() << " sensor readings\n";
+        } else if (!approx.sketchMergePaths.empty()) {
+            // Nothing to ingest: combine the statistics of earlier runs
+            StreamingStatistics stats(approx.sketchK);
+            return reportApproximateStatistics(stats, showStats, approx);
         } else {
             std::cerr << "Error: Must specify either -f or -g option\n";
             printUsage(argv[0]);
             return 1;
         }
 
+        if (rangeQuery) {
+            TimeIndexedStore store(std::move(readings));
+            readings = store.rangeScan(fromMs, toMs);
+            std::cout << "Selected " << readings.size() << " readings in the requested time range\n";
+        }
+
         if (readings.empty()) {
             std::cerr << "Error: No sensor readings to process\n";
             return 1;
         }
 
+        if (convertOnly) {
+            if (outputFile.empty()) {
+                std::cerr << "Error: --convert requires -o\n";
+                return 1;
+            }
+            bool written = writeReadings(ingester, readings, outputFile, threadCount);
+            if (!written) {
+                std::cerr << "Error: Failed to write output file\n";
+                return 1;
+            }
+            std::cout << "Converted " << readings.size() << " readings to: " << outputFile << "\n";
+            return 0;
+        }
+
+        // Scratch for every phase comes from one arena, rewound after each phase;
+        // 16 bytes per row fits a group-id column plus a partitioned value column
+        ProcessingArena arena(readings.size() * 16);
+        processor.setScratchResource(arena.resource());
+
         // Process data
         std::cout << "\nProcessing sensor data...\n";
-        std::vector<SensorReading> processed = processor.process(readings);
+        size_t loaded = readings.size();
+        ReadingBatch processed = processor.process(std::move(readings));
+        arena.release();
         std::cout << "Processed " << processed.size() << " readings "
-                  << "(removed " << (readings.size() - processed.size()) << " outliers/invalid)\n";
+                  << "(removed " << (loaded - processed.size()) << " outliers/invalid)\n";
 
         // Display statistics if requested
-        if (showStats) {
-            SensorStatistics overallStats = processor.calculateStatistics(processed);
-            printStatistics(overallStats, "Overall Statistics");
-
-            // Statistics by type
-            auto statsByType = processor.calculateStatisticsByType(processed);
-            if (!statsByType.empty()) {
-                std::cout << "\nStatistics by Sensor Type:\n";
-                for (const auto& pair : statsByType) {
-                    std::string typeStr = SensorReading::typeToString(pair.first);
-                    printStatistics(pair.second, typeStr);
-                }
+        if (approx.sketchK > 0) {
+            StreamingStatistics stats(approx.sketchK);
+            stats.add(processed);
+            if (reportApproximateStatistics(stats, showStats, approx) != 0) {
+                return 1;
             }
+        } else if (showStats) {
+            SensorStatistics overall = processor.calculateStatistics(processed);
+            arena.release();
+            auto byType = processor.calculateStatisticsByType(processed);
+            arena.release();
+            auto bySensor = processor.calculateStatisticsBySensorId(processed);
+            arena.release();
+            printAllStatistics(overall, byType, bySensor);
+        }
+        PROFILE_COUNT("arena.spills", arena.spillCount());
+        processor.setScratchResource(nullptr);
 
-            // Statistics by sensor ID
-            auto statsBySensor = processor.calculateStatisticsBySensorId(processed);
-            if (!statsBySensor.empty()) {
-                std::cout << "\nStatistics by Sensor ID:\n";
-                for (const auto& pair : statsBySensor) {
-                    printStatistics(pair.second, pair.first);
-                }
-            }
+        if (windowMs > 0) {
+            PROFILE_SCOPE("windows");
+            WindowAggregator windows(windowMs, hopMs);
+            windows.add(processed);
+            std::cout << "\nWindowed Statistics:\n";
+            printWindows(windows.flush());
         }
 
         // Write output if specified
         if (!outputFile.empty()) {
-            if (ingester.writeToFile(processed, outputFile)) {
+            bool written = writeReadings(ingester, processed, outputFile, threadCount);
+            if (written) {
                 std::cout << "\nProcessed data written to: " << outputFile << "\n";
             } else {
                 std::cerr << "Error: Failed to write output file\n";
@@ -168,7 +987,7 @@ int main(int argc, char* argv[]) {
             std::cout << "\nSample processed readings (first 10):\n";
             size_t printCount = std::min(static_cast<size_t>(10), processed.size());
             for (size_t i = 0; i < printCount; ++i) {
-                printReading(processed[i]);
+                printReading(processed.at(i));
             }
             if (processed.size() > 10) {
                 std::cout << "... (" << (processed.size() - 10) << " more readings)\n";
@@ -0,0 +1,120 @@
+#include "test_CsvWriter.h"
+#include "CsvWriter.h"
+#include "DataIngester.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+static ReadingBatch csvBatch(size_t count, unsigned seed) {
+    RandomReadingsSpec spec;
+    spec.sensorPrefix = "CSV_";
+    spec.sensorCount = 50;
+    spec.step = 7;
+    std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+    std::uniform_int_distribution<int> exponent(-30, 30);
+    return randomBatch(count, seed, spec, [&](std::mt19937& gen, size_t) {
+        return std::ldexp(mantissa(gen), exponent(gen));
+    });
+}
+
+static std::string writeBatch(const ReadingBatch& batch, size_t threads) {
+    std::ostringstream out;
+    CsvWriter writer(out);
+    writer.setThreadCount(threads);
+    writer.write(batch);
+    return out.str();
+}
+
+bool testValuesRoundTrip() {
+    ReadingBatch batch = csvBatch(5000, 3);
+    batch.append("CSV_EDGE", SensorReading::SensorType::SONAR, 0.1, 1);
+    batch.append("CSV_EDGE", SensorReading::SensorType::SONAR, -0.0, 2);
+    batch.append("CSV_EDGE", SensorReading::SensorType::SONAR,
+                 std::numeric_limits<double>::max(), std::numeric_limits<int64_t>::max());
+    batch.append("CSV_EDGE", SensorReading::SensorType::SONAR,
+                 std::numeric_limits<double>::denorm_min(), 3);
+
+    std::istringstream in(writeBatch(batch, 1));
+    DataIngester ingester;
+    std::string line;
+    size_t row = 0;
+    while (std::getline(in, line)) {
+        SensorReading reading;
+        ASSERT(ingester.parseCSVLine(line, reading) == DataIngester::ParseStatus::OK,
+               "Written rows parse");
+        ASSERT(row < batch.size(), "No extra rows");
+        ASSERT(reading.getValue() == batch.values()[row], "Values round-trip exactly");
+        ASSERT(reading.getTimestamp() == batch.timestamps()[row], "Timestamps round-trip");
+        ASSERT(reading.getType() == batch.types()[row], "Types round-trip");
+        ASSERT(reading.getSensorKey() == batch.sensorKeys()[row], "Sensor IDs round-trip");
+        ++row;
+    }
+    ASSERT(row == batch.size(), "Every row is written");
+
+    std::ostringstream single;
+    CsvWriter(single).write(batch.slice(batch.size() - 3, batch.size() - 2));
+    ASSERT(single.str() == "CSV_EDGE,SONAR,-0,2\n", "Shortest form, no locale formatting");
+    return true;
+}
+
+bool testParallelMatchesSerial() {
+    ReadingBatch batch = csvBatch(300000, 9);
+    std::string serial = writeBatch(batch, 1);
+    ASSERT(writeBatch(batch, 4) == serial, "Parallel formatting writes identical output");
+
+    std::ostringstream fromVector;
+    CsvWriter writer(fromVector);
+    writer.write(batch.toReadings());
+    ASSERT(fromVector.str() == serial, "Vector and batch overloads agree");
+    ASSERT(writer.bytesWritten() == serial.size(), "Bytes written are counted");
+    return true;
+}
+
+bool testTypeNameTable() {
+    for (int code = 0; code < 6; ++code) {
+        auto type = static_cast<SensorReading::SensorType>(code);
+        SensorReading::SensorType parsed;
+        ASSERT(SensorReading::typeName(type) == SensorReading::typeToString(type),
+               "typeName and typeToString agree");
+        ASSERT(SensorReading::parseType(SensorReading::typeName(type), parsed) && parsed == type,
+               "Type names parse back");
+    }
+    ASSERT(SensorReading::typeName(static_cast<SensorReading::SensorType>(42)) == "UNKNOWN",
+           "Out-of-range types are UNKNOWN");
+    return true;
+}
+
+std::pair<int, int> runCsvWriterTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Values Round Trip", testValuesRoundTrip);
+    runTest("Parallel Matches Serial", testParallelMatchesSerial);
+    runTest("Type Name Table", testTypeNameTable);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_CSV_WRITER_H
+#define TEST_CSV_WRITER_H
+
+#include <utility>
+
+std::pair<int, int> runCsvWriterTests();
+
+#endif // TEST_CSV_WRITER_H
@@ -0,0 +1,128 @@
+#include "test_DataGenerator.h"
+#include "DataGenerator.h"
+#include "DataIngester.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+bool testDeterministicAcrossThreads() {
+    GeneratorOptions options;
+    options.seed = 42;
+    options.sensorCount = 37;
+
+    DataGenerator serial(options);
+    ReadingBatch expected = serial.generate(300000);
+
+    DataGenerator parallel(options);
+    parallel.setThreadCount(4);
+    ASSERT(sameBatch(parallel.generate(300000), expected), "Thread count does not change the output");
+
+    ReadingBatch slice;
+    serial.generate(123457, 1000, slice);
+    ASSERT(sameBatch(slice, expected.slice(123457, 124457)), "Any row range can be generated alone");
+
+    options.seed = 43;
+    DataGenerator reseeded(options);
+    ASSERT(reseeded.generate(1000).values() != expected.slice(0, 1000).values(),
+           "A different seed gives different values");
+    ASSERT(reseeded.generate(1000).timestamps() == expected.slice(0, 1000).timestamps(),
+           "Timestamps depend only on the schedule");
+    return true;
+}
+
+bool testTimeSeriesShape() {
+    GeneratorOptions options;
+    options.seed = 7;
+    options.sensorCount = 10;
+    options.outlierRate = 0.01;
+    DataGenerator generator(options);
+    ReadingBatch batch = generator.generate(200000);
+
+    std::vector<int64_t> lastTimestamp(options.sensorCount, 0);
+    size_t spikes = 0;
+    for (size_t row = 0; row < batch.size(); ++row) {
+        size_t sensor = row % options.sensorCount;
+        ASSERT(batch.sensorKeys()[row] == generator.sensorKeys()[sensor], "Rows cycle through the sensors");
+        ASSERT(batch.types()[row] == options.types[sensor % options.types.size()],
+               "Each sensor keeps one type");
+        ASSERT(batch.timestamps()[row] > lastTimestamp[sensor], "Timestamps rise per sensor");
+        ASSERT(row == 0 || batch.timestamps()[row] >= batch.timestamps()[row - 1],
+               "Timestamps never go backwards across the dataset");
+        lastTimestamp[sensor] = batch.timestamps()[row];
+        ASSERT(batch.isValid(row), "Generated readings are valid");
+
+        // Spikes land at least two ranges beyond the type's nominal range
+        double value = batch.values()[row];
+        const double upper[] = {100.0, 1000.0, 5000.0, 10000.0};
+        double span = upper[static_cast<size_t>(batch.types()[row])];
+        if (value < -2.0 * span || value > 3.0 * span) {
+            ++spikes;
+        }
+    }
+    double spikeRate = static_cast<double>(spikes) / batch.size();
+    ASSERT(spikeRate > 0.008 && spikeRate < 0.012, "Outliers are injected at about the requested rate");
+    return true;
+}
+
+bool testWriteFileRoundTrip() {
+    GeneratorOptions options;
+    options.seed = 11;
+    options.sensorCount = 5;
+    DataGenerator generator(options);
+    ReadingBatch expected = generator.generate(10000);
+
+    const char* archivePath = "test_generated.sdb";
+    const char* csvPath = "test_generated.csv";
+    ASSERT(generator.writeFile(archivePath, 10000, 3000) == 10000, "Archive row count");
+    ASSERT(generator.writeFile(csvPath, 10000, 3000) == 10000, "CSV row count");
+
+    DataIngester ingester;
+    ReadingBatch archived = ingester.readBinaryFile(archivePath);
+    ReadingBatch parsed = ingester.readBatchFromFile(csvPath);
+    std::remove(archivePath);
+    std::remove(csvPath);
+
+    ASSERT(sameBatch(archived, expected), "Chunked archive matches in-memory generation exactly");
+    ASSERT(parsed.size() == expected.size(), "Every CSV row parses");
+    ASSERT(parsed.timestamps() == expected.timestamps(), "CSV timestamps match");
+    ASSERT(parsed.sensorKeys() == expected.sensorKeys(), "CSV sensors match");
+    for (size_t row = 0; row < parsed.size(); ++row) {
+        double tolerance = 1e-5 * std::max(1.0, std::fabs(expected.values()[row]));
+        ASSERT(std::fabs(parsed.values()[row] - expected.values()[row]) <= tolerance,
+               "CSV values match to printed precision");
+    }
+    return true;
+}
+
+std::pair<int, int> runDataGeneratorTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Deterministic Across Threads", testDeterministicAcrossThreads);
+    runTest("Time Series Shape", testTimeSeriesShape);
+    runTest("Write File Round Trip", testWriteFileRoundTrip);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_DATA_GENERATOR_H
+#define TEST_DATA_GENERATOR_H
+
+#include <utility>
+
+std::pair<int, int> runDataGeneratorTests();
+
+#endif // TEST_DATA_GENERATOR_H
@@ -0,0 +1,263 @@
+#include "test_DataIngester.h"
+#include "DataIngester.h"
+#include "MappedFile.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+static const char* kTestCsvPath = "test_ingest.csv";
+
+static void writeTestCsv() {
+    std::ofstream file(kTestCsvPath, std::ios::binary);
+    file << "Sensor_ID,Type,Value,Timestamp\r\n"
+         << "S1,TEMPERATURE,22.5,1704067200000\r\n"
+         << "# comment line\n"
+         << "\n"
+         << "S2, PRESSURE ,1013.25,1704067201000,extra\n"
+         << "S3,DEPTH,not_a_number,1704067202000\n"
+         << "S4,SONAR,5000\n"
+         << ",DEPTH,1.0,1704067203000\n"
+         << "S1,TEMPERATURE,23.1,1704067204000";  // No trailing newline
+}
+
+bool testReadFromFile() {
+    writeTestCsv();
+    DataIngester ingester;
+    auto readings = ingester.readFromFile(kTestCsvPath);
+    std::remove(kTestCsvPath);
+
+    ASSERT(readings.size() == 3, "Should keep 3 valid rows");
+    ASSERT(readings[0].getSensorId() == "S1", "First sensor ID should be S1");
+    ASSERT(readings[1].getType() == SensorReading::SensorType::PRESSURE,
+           "Whitespace around type should be trimmed");
+    ASSERT(readings[2].getValue() == 23.1, "Last line without newline should be read");
+    ASSERT(ingester.getLastIngestStats().rowsAccepted == 3, "Should count 3 accepted rows");
+    ASSERT(ingester.getLastIngestStats().rowsRejected == 3, "Should count 3 rejected rows");
+    return true;
+}
+
+bool testParseCSVLineStatus() {
+    DataIngester ingester;
+    SensorReading reading;
+    using Status = DataIngester::ParseStatus;
+
+    ASSERT(ingester.parseCSVLine("S1,GYROSCOPE,-12.5,1704067200000", reading) == Status::OK,
+           "Well-formed record should parse");
+    ASSERT(reading.getType() == SensorReading::SensorType::GYROSCOPE, "Type should be parsed");
+    ASSERT(reading.getValue() == -12.5, "Value should be parsed");
+    ASSERT(reading.getTimestamp() == 1704067200000, "Timestamp should be parsed");
+
+    ASSERT(ingester.parseCSVLine("S1,DEPTH,+1e3,+42", reading) == Status::OK,
+           "Leading '+' and exponents should be accepted");
+    ASSERT(reading.getValue() == 1000.0, "Exponent value should be parsed");
+
+    ASSERT(ingester.parseCSVLine("S1,DEPTH,1.0", reading) == Status::MISSING_COLUMNS,
+           "Three columns should be rejected");
+    ASSERT(ingester.parseCSVLine("S1,DEPTH,1.0x,100", reading) == Status::INVALID_VALUE,
+           "Trailing garbage in value should be rejected");
+    ASSERT(ingester.parseCSVLine("S1,DEPTH,1.0,99999999999999999999", reading) ==
+           Status::INVALID_TIMESTAMP, "Out-of-range timestamp should be rejected");
+    ASSERT(ingester.parseCSVLine("S1,DEPTH,+-5,100", reading) == Status::INVALID_VALUE,
+           "A sign after '+' should be rejected");
+    ASSERT(ingester.parseCSVLine("S1,DEPTH,5,+-100", reading) == Status::INVALID_TIMESTAMP,
+           "A sign after '+' in the timestamp should be rejected");
+    return true;
+}
+
+bool testMappedMatchesStreamed() {
+    writeTestCsv();
+    DataIngester ingester;
+    ReadingBatch streamed = ingester.readBatchFromFile(kTestCsvPath);
+    ReadingBatch mapped = ingester.readBatchFromMappedFile(kTestCsvPath);
+    std::remove(kTestCsvPath);
+
+    ASSERT(mapped.size() == streamed.size(), "Mapped and streamed row counts should match");
+    for (size_t row = 0; row < mapped.size(); ++row) {
+        ASSERT(mapped.sensorKeys()[row] == streamed.sensorKeys()[row], "Sensor keys should match");
+        ASSERT(mapped.types()[row] == streamed.types()[row], "Types should match");
+        ASSERT(mapped.values()[row] == streamed.values()[row], "Values should match");
+        ASSERT(mapped.timestamps()[row] == streamed.timestamps()[row], "Timestamps should match");
+    }
+    return true;
+}
+
+bool testMappedReadsPipe() {
+#if defined(__unix__) || defined(__APPLE__)
+    // A pipe reports no size; its rows must still be read to the end
+    const char* fifoPath = "test_ingest.fifo";
+    std::remove(fifoPath);
+    ASSERT(::mkfifo(fifoPath, 0600) == 0, "Should create a FIFO");
+    writeTestCsv();
+    ASSERT(MappedFile::isRegularFile(kTestCsvPath), "A plain file is regular");
+    ASSERT(!MappedFile::isRegularFile(fifoPath), "A FIFO is not regular");
+    std::thread writer([fifoPath] {
+        std::ifstream source(kTestCsvPath, std::ios::binary);
+        std::ofstream fifo(fifoPath, std::ios::binary);
+        fifo << source.rdbuf();
+    });
+    DataIngester ingester;
+    ReadingBatch piped = ingester.readBatchFromMappedFile(fifoPath);
+    writer.join();
+    ReadingBatch streamed = ingester.readBatchFromFile(kTestCsvPath);
+    std::remove(fifoPath);
+    std::remove(kTestCsvPath);
+
+    ASSERT(piped.size() == 3, "Piped input should keep 3 valid rows");
+    ASSERT(sameBatch(piped, streamed), "Piped rows should match the file's");
+#endif
+    return true;
+}
+
+bool testBinaryRoundTrip() {
+    const char* archivePath = "test_ingest.sdb";
+    std::vector<SensorReading> readings = {
+        SensorReading("S1", SensorReading::SensorType::TEMPERATURE, 22.125, 1704067200000),
+        SensorReading("S2", SensorReading::SensorType::GYROSCOPE, -0.1, 1704067201000),
+        SensorReading("S1", SensorReading::SensorType::SONAR, 1e300, 1704067202000)
+    };
+    ReadingBatch batch = ReadingBatch::fromReadings(readings);
+
+    DataIngester ingester;
+    ASSERT(ingester.writeBinaryFile(batch, archivePath, 2), "Archive should be written");
+    ReadingBatch loaded = ingester.readBinaryFile(archivePath);
+    std::remove(archivePath);
+
+    ASSERT(loaded.size() == batch.size(), "Row count should survive round trip");
+    for (size_t row = 0; row < batch.size(); ++row) {
+        ASSERT(loaded.sensorId(row) == batch.sensorId(row), "Sensor ID should survive round trip");
+        ASSERT(loaded.types()[row] == batch.types()[row], "Type should survive round trip");
+        ASSERT(loaded.values()[row] == batch.values()[row], "Value should survive bit-exact");
+        ASSERT(loaded.timestamps()[row] == batch.timestamps()[row], "Timestamp should survive round trip");
+    }
+
+    writeTestCsv();
+    bool rejected = false;
+    try {
+        ingester.readBinaryFile(kTestCsvPath);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    std::remove(kTestCsvPath);
+    ASSERT(rejected, "A CSV file should be rejected as an archive");
+
+    // A header claiming more rows than the file holds is rejected before allocating
+    ASSERT(ingester.writeBinaryFile(ReadingBatch(), archivePath), "Empty archive should be written");
+    {
+        std::fstream file(archivePath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-static_cast<std::streamoff>(2 * sizeof(uint64_t)), std::ios::end);
+        uint64_t counts[2] = {uint64_t(1) << 40, 1};
+        file.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+    }
+    rejected = false;
+    try {
+        ingester.readBinaryFile(archivePath);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    std::remove(archivePath);
+    ASSERT(rejected, "An oversized row count should be rejected");
+    return true;
+}
+
+bool testFormatOf() {
+    using Format = DataIngester::FileFormat;
+    ASSERT(DataIngester::formatOf("data.sdb") == Format::BINARY_ARCHIVE, ".sdb is a binary archive");
+    ASSERT(DataIngester::formatOf("dir/data.sdc") == Format::COMPRESSED_ARCHIVE,
+           ".sdc is a compressed archive");
+    ASSERT(DataIngester::formatOf("data.csv") == Format::CSV, ".csv is CSV");
+    ASSERT(DataIngester::formatOf("sdb") == Format::CSV, "Extension needs its dot");
+    ASSERT(DataIngester::formatOf("data.sdb.csv") == Format::CSV, "Only the last extension counts");
+    ASSERT(DataIngester::formatOf("") == Format::CSV, "No path is CSV");
+    return true;
+}
+
+bool testStreamFromFile() {
+    writeTestCsv();
+    DataIngester ingester;
+    std::vector<size_t> batchSizes;
+    std::vector<double> values;
+    ingester.streamFromFile(kTestCsvPath, 2, [&](const ReadingBatch& batch) {
+        batchSizes.push_back(batch.size());
+        values.insert(values.end(), batch.values().begin(), batch.values().end());
+    });
+    std::remove(kTestCsvPath);
+
+    ASSERT(batchSizes.size() == 2, "3 rows in batches of 2 should give 2 batches");
+    ASSERT(batchSizes[0] == 2 && batchSizes[1] == 1, "Last batch should hold the remainder");
+    ASSERT(values.size() == 3 && values[2] == 23.1, "Rows should arrive in file order");
+    ASSERT(ingester.getLastIngestStats().rowsRejected == 3, "Rejected rows should be counted");
+    return true;
+}
+
+bool testParallelMatchesSequential() {
+    // Large enough to be split into several chunks
+    {
+        std::ofstream file(kTestCsvPath, std::ios::binary);
+        file << "sensor_id,type,value,timestamp\n";
+        for (int i = 0; i < 200000; ++i) {
+            file << "SENSOR_" << (i % 17) << ",PRESSURE," << i << ".25,"
+                 << (1704067200000LL + i) << "\n";
+            if (i % 1000 == 0) {
+                file << "bad,row\n";
+            }
+        }
+    }
+
+    DataIngester ingester;
+    ReadingBatch sequential = ingester.readBatchFromMappedFile(kTestCsvPath, 1);
+    ReadingBatch parallel = ingester.readBatchFromMappedFile(kTestCsvPath, 4);
+    auto parallelStats = ingester.getLastIngestStats();
+    auto shards = ingester.readShardsFromMappedFile(kTestCsvPath, 4);
+    std::remove(kTestCsvPath);
+
+    ASSERT(sequential.size() == 200000, "Sequential read should keep every valid row");
+    ASSERT(parallel.size() == sequential.size(), "Parallel read should keep every valid row");
+    ASSERT(parallelStats.rowsRejected == 200, "Rejected rows should be summed across chunks");
+    ASSERT(shards.size() > 1, "File should be split into several shards");
+    for (size_t row = 0; row < sequential.size(); ++row) {
+        ASSERT(parallel.timestamps()[row] == sequential.timestamps()[row],
+               "Parallel read should preserve file order");
+    }
+    return true;
+}
+
+std::pair<int, int> runDataIngesterTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Read From File", testReadFromFile);
+    runTest("Parse CSV Line Status", testParseCSVLineStatus);
+    runTest("Mapped Matches Streamed", testMappedMatchesStreamed);
+    runTest("Mapped Reads Pipe", testMappedReadsPipe);
+    runTest("Binary Round Trip", testBinaryRoundTrip);
+    runTest("Format Of", testFormatOf);
+    runTest("Stream From File", testStreamFromFile);
+    runTest("Parallel Matches Sequential", testParallelMatchesSequential);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_DATA_INGESTER_H
+#define TEST_DATA_INGESTER_H
+
+#include <utility>
+
+std::pair<int, int> runDataIngesterTests();
+
+#endif // TEST_DATA_INGESTER_H
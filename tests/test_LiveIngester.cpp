@@ -0,0 +1,137 @@
+#include "test_LiveIngester.h"
+#include "LiveIngester.h"
+#include "SpscRing.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+static const char* kLiveCsvPath = "test_live.csv";
+
+bool testRingOrderAndCapacity() {
+    SpscRing<int> ring(5);
+    ASSERT(ring.capacity() == 8, "Capacity rounds up to a power of two");
+
+    for (int round = 0; round < 3; ++round) {  // Wraps the indexes around the slots
+        for (int i = 0; i < 8; ++i) {
+            ASSERT(ring.tryPush(round * 100 + i), "Pushes succeed until the ring is full");
+        }
+        ASSERT(!ring.tryPush(-1), "Push fails on a full ring");
+        ASSERT(ring.size() == 8, "Size counts queued items");
+
+        int first = 0;
+        ASSERT(ring.tryPop(first) && first == round * 100, "Pop returns the oldest item");
+        int rest[16];
+        size_t count = ring.tryPopBulk(rest, 16);
+        ASSERT(count == 7, "Bulk pop takes everything queued");
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT(rest[i] == round * 100 + static_cast<int>(i) + 1, "Bulk pop keeps FIFO order");
+        }
+        ASSERT(ring.empty() && !ring.tryPop(first), "Pop fails on an empty ring");
+    }
+    return true;
+}
+
+bool testRingAcrossThreads() {
+    const size_t total = 1000000;
+    SpscRing<size_t> ring(64);
+
+    std::thread producer([&ring, total]() {
+        for (size_t i = 0; i < total; ++i) {
+            while (!ring.tryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    size_t expected = 0;
+    bool ordered = true;
+    size_t items[32];
+    while (expected < total) {
+        size_t count = ring.tryPopBulk(items, 32);
+        for (size_t i = 0; i < count; ++i) {
+            ordered = ordered && items[i] == expected;
+            ++expected;
+        }
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    ASSERT(ordered, "Every item arrives once and in order");
+    ASSERT(ring.empty(), "Ring is drained");
+    return true;
+}
+
+bool testLiveIngesterMatchesFileRead() {
+    std::ostringstream csv;
+    csv << "sensor_id,type,value,timestamp\r\n";
+    for (int i = 0; i < 5000; ++i) {
+        csv << "LIVE_" << (i % 7) << "," << (i % 2 ? "PRESSURE" : "DEPTH") << ","
+            << (i * 0.5) << "," << (1704067200000LL + i) << "\n";
+        if (i % 1000 == 0) {
+            csv << "LIVE_X,DEPTH,not_a_number,1704067200000\n"
+                << "# comment\n";
+        }
+    }
+    {
+        std::ofstream file(kLiveCsvPath);
+        file << csv.str();
+    }
+    DataIngester ingester;
+    ReadingBatch expected = ingester.readBatchFromFile(kLiveCsvPath);
+    std::remove(kLiveCsvPath);
+
+    // A tiny ring forces the reader to wait on the consumer
+    std::istringstream input(csv.str());
+    LiveIngester live(input, 16);
+    ReadingBatch received;
+    while (!live.finished()) {
+        if (live.poll(received, 10) == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    ASSERT(received.size() == expected.size(), "Every valid reading is received");
+    ASSERT(received.values() == expected.values(), "Values arrive in input order");
+    ASSERT(received.timestamps() == expected.timestamps(), "Timestamps arrive in input order");
+    ASSERT(received.sensorKeys() == expected.sensorKeys(), "Sensor keys match the file reader");
+    ASSERT(live.rowsAccepted() == expected.size(), "Accepted rows are counted");
+    ASSERT(live.rowsRejected() == ingester.getLastIngestStats().rowsRejected,
+           "Rejected rows match the file reader");
+    return true;
+}
+
+std::pair<int, int> runLiveIngesterTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Ring Order And Capacity", testRingOrderAndCapacity);
+    runTest("Ring Across Threads", testRingAcrossThreads);
+    runTest("Live Ingester Matches File Read", testLiveIngesterMatchesFileRead);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_LIVE_INGESTER_H
+#define TEST_LIVE_INGESTER_H
+
+#include <utility>
+
+std::pair<int, int> runLiveIngesterTests();
+
+#endif // TEST_LIVE_INGESTER_H
@@ -0,0 +1,111 @@
+#include "test_ProcessingArena.h"
+#include "ProcessingArena.h"
+#include "SensorDataProcessor.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+static ReadingBatch arenaBatch(size_t count, unsigned seed) {
+    RandomReadingsSpec spec;
+    spec.sensorPrefix = "ARENA_";
+    spec.typeCount = 4;
+    std::normal_distribution<double> value(20.0, 5.0);
+    return randomBatch(count, seed, spec, [&](std::mt19937& gen, size_t i) {
+        double v = value(gen);
+        return (i % 97 == 0) ? 1000.0 : v;  // Sprinkle outliers
+    });
+}
+
+static bool sameStats(const SensorStatistics& a, const SensorStatistics& b) {
+    return a.count == b.count && a.min == b.min && a.max == b.max &&
+           a.mean == b.mean && a.median == b.median;
+}
+
+bool testArenaRewinds() {
+    ProcessingArena arena(1 << 16);
+    std::pmr::memory_resource* resource = arena.resource();
+
+    void* first = resource->allocate(1000, alignof(double));
+    void* second = resource->allocate(1000, alignof(double));
+    ASSERT(first != second, "Allocations do not overlap");
+    ASSERT(arena.spillCount() == 0, "Allocations within capacity stay in the buffer");
+
+    arena.release();
+    void* reused = resource->allocate(1000, alignof(double));
+    ASSERT(reused == first, "release() rewinds to the start of the buffer");
+
+    void* spilled = resource->allocate(1 << 17, alignof(double));
+    ASSERT(spilled != nullptr && arena.spillCount() == 1, "Oversized requests spill to the heap");
+    arena.release();
+    ASSERT(resource->allocate(1000, alignof(double)) == first, "Spills are dropped on release");
+    return true;
+}
+
+bool testProcessorWithArenaMatchesDefault() {
+    ReadingBatch batch = arenaBatch(50000, 5);
+    ProcessingArena arena(batch.size() * 32);
+
+    for (size_t threads : {size_t(1), size_t(4)}) {
+        SensorDataProcessor plain;
+        SensorDataProcessor arenaBacked;
+        plain.setThreadCount(threads);
+        arenaBacked.setThreadCount(threads);
+        arenaBacked.setScratchResource(arena.resource());
+
+        OutlierOptions grouped;
+        grouped.grouping = OutlierGrouping::TYPE_AND_SENSOR;
+        for (const OutlierOptions& options : {OutlierOptions(), grouped}) {
+            plain.setOutlierOptions(options);
+            arenaBacked.setOutlierOptions(options);
+            ReadingBatch expected = plain.process(batch);
+            ReadingBatch got = arenaBacked.process(batch);
+            arena.release();
+            ASSERT(got.values() == expected.values(), "Arena-backed process() keeps the same rows");
+            ASSERT(got.sensorKeys() == expected.sensorKeys(), "Arena-backed process() keeps sensor keys");
+        }
+
+        ASSERT(sameStats(arenaBacked.calculateStatistics(batch), plain.calculateStatistics(batch)),
+               "Arena-backed overall statistics");
+        arena.release();
+        auto expectedGroups = plain.calculateGroupedStatistics(batch, GroupBy::TYPE_AND_SENSOR);
+        auto gotGroups = arenaBacked.calculateGroupedStatistics(batch, GroupBy::TYPE_AND_SENSOR);
+        arena.release();
+        ASSERT(gotGroups.size() == expectedGroups.size(), "Arena-backed group count");
+        for (size_t i = 0; i < gotGroups.size(); ++i) {
+            ASSERT(sameStats(gotGroups[i].stats, expectedGroups[i].stats), "Arena-backed group statistics");
+        }
+    }
+    ASSERT(arena.spillCount() == 0, "A run sized for the data never spills");
+    return true;
+}
+
+std::pair<int, int> runProcessingArenaTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Arena Rewinds", testArenaRewinds);
+    runTest("Processor With Arena Matches Default", testProcessorWithArenaMatchesDefault);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_PROCESSING_ARENA_H
+#define TEST_PROCESSING_ARENA_H
+
+#include <utility>
+
+std::pair<int, int> runProcessingArenaTests();
+
+#endif // TEST_PROCESSING_ARENA_H
@@ -0,0 +1,133 @@
+#include "test_Profiler.h"
+#include "Profiler.h"
+#include "DataIngester.h"
+#include "SensorDataProcessor.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+static const char* kProfileCsvPath = "test_profile.csv";
+
+static uint64_t counterValue(const char* name) {
+    return Profiler::instance().site(name, Profiler::Kind::COUNTER).total.load();
+}
+
+bool testScopedTimerFollowsEnabledFlag() {
+    Profiler& profiler = Profiler::instance();
+    Profiler::Site& site = profiler.site("test.stage", Profiler::Kind::STAGE);
+    ASSERT(&profiler.site("test.stage", Profiler::Kind::STAGE) == &site,
+           "A name resolves to the same site every time");
+    profiler.reset();
+
+    profiler.setEnabled(false);
+    { ScopedTimer timer(site); }
+    ASSERT(site.calls.load() == 0, "Nothing is recorded while profiling is disabled");
+
+    profiler.setEnabled(true);
+    { ScopedTimer timer(site); }
+    { ScopedTimer timer(site); }
+    profiler.setEnabled(false);
+    ASSERT(site.calls.load() == 2, "Each enabled scope is counted once");
+    return true;
+}
+
+bool testIngestAndProcessCounters() {
+    if (!Profiler::compiledIn()) {
+        return true;  // Macros compile to nothing; there is nothing to count
+    }
+
+    {
+        std::ofstream file(kProfileCsvPath);
+        file << "sensor_id,type,value,timestamp\n"
+             << "S1,TEMPERATURE,22.5,1704067200000\n"
+             << "S2,PRESSURE,bad,1704067201000\n"
+             << "S1,TEMPERATURE,23.0,1704067202000\n"
+             << "S1,TEMPERATURE,23.5,1704067203000\n"
+             << "S1,TEMPERATURE,24.0,1704067204000\n";
+    }
+
+    Profiler& profiler = Profiler::instance();
+    profiler.reset();
+    profiler.setEnabled(true);
+    DataIngester ingester;
+    ReadingBatch batch = ingester.readBatchFromMappedFile(kProfileCsvPath);
+    SensorDataProcessor processor;
+    ReadingBatch processed = processor.process(batch);
+    profiler.setEnabled(false);
+    std::remove(kProfileCsvPath);
+
+    ASSERT(counterValue("ingest.rowsParsed") == 4, "Parsed rows are counted");
+    ASSERT(counterValue("ingest.rowsRejected") == 1, "Rejected rows are counted");
+    ASSERT(counterValue("ingest.bytesRead") > 100, "Bytes read are counted");
+    ASSERT(counterValue("process.rowsIn") == 4, "Rows entering outlier removal are counted");
+    ASSERT(counterValue("process.rowsKept") == processed.size(), "Surviving rows are counted");
+    ASSERT(profiler.site("ingest.mmap", Profiler::Kind::STAGE).calls.load() == 1,
+           "The mapped read is timed once");
+    ASSERT(profiler.site("process", Profiler::Kind::STAGE).calls.load() == 1,
+           "process() is timed once");
+
+    uint64_t before = Profiler::allocationCount();
+    std::vector<double>* values = new std::vector<double>(16);
+    uint64_t after = Profiler::allocationCount();
+    delete values;
+    ASSERT(after >= before + 2, "Operator new calls are counted");
+    return true;
+}
+
+bool testReportFormats() {
+    Profiler& profiler = Profiler::instance();
+    Profiler::Site& site = profiler.site("test.report", Profiler::Kind::STAGE);
+    profiler.reset();
+    profiler.setEnabled(true);
+    { ScopedTimer timer(site); }
+    profiler.setEnabled(false);
+
+    std::ostringstream table;
+    profiler.writeTable(table);
+    ASSERT(table.str().find("test.report") != std::string::npos, "Table lists the stage");
+    ASSERT(table.str().find("peak RSS MB") != std::string::npos, "Table reports peak RSS");
+    ASSERT(table.str().find("test.stage") == std::string::npos, "Stages never entered are omitted");
+
+    std::ostringstream json;
+    profiler.writeJson(json);
+    const std::string text = json.str();
+    ASSERT(text.front() == '{' && text.find("\"stages\": [") != std::string::npos, "JSON has a stage array");
+    ASSERT(text.find("{\"name\": \"test.report\", \"calls\": 1") != std::string::npos,
+           "JSON records the stage and its call count");
+    ASSERT(text.find("\"peak_rss_bytes\"") != std::string::npos, "JSON reports peak RSS");
+    profiler.reset();
+    return true;
+}
+
+std::pair<int, int> runProfilerTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Scoped Timer Follows Enabled Flag", testScopedTimerFollowsEnabledFlag);
+    runTest("Ingest And Process Counters", testIngestAndProcessCounters);
+    runTest("Report Formats", testReportFormats);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_PROFILER_H
+#define TEST_PROFILER_H
+
+#include <utility>
+
+std::pair<int, int> runProfilerTests();
+
+#endif // TEST_PROFILER_H
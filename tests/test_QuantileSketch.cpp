@@ -0,0 +1,195 @@
+#include "test_QuantileSketch.h"
+#include "QuantileSketch.h"
+#include "StreamingStatistics.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+static std::vector<double> skewedValues(size_t count, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::lognormal_distribution<double> dist(3.0, 1.0);
+    std::vector<double> values(count);
+    for (auto& value : values) {
+        value = dist(gen);
+    }
+    return values;
+}
+
+// Largest normalized rank distance between the sketch's answers and the truth
+static double worstRankError(const QuantileSketch& sketch, std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    double worst = 0.0;
+    for (int percent = 1; percent < 100; ++percent) {
+        double q = percent / 100.0;
+        double estimate = sketch.quantile(q);
+        double below = std::lower_bound(values.begin(), values.end(), estimate) - values.begin();
+        double upTo = std::upper_bound(values.begin(), values.end(), estimate) - values.begin();
+        double target = q * values.size();
+        double distance = target < below ? below - target : (target > upTo ? target - upTo : 0.0);
+        worst = std::max(worst, distance / values.size());
+    }
+    return worst;
+}
+
+bool testRankErrorBound() {
+    QuantileSketch tiny;
+    double small[] = {4.0, 1.0, 3.0, 2.0};
+    tiny.add(small, 4);
+    ASSERT(tiny.quantile(0.5) == 2.5, "Uncompacted sketch gives the exact median");
+    ASSERT(tiny.quantile(0.0) == 1.0 && tiny.quantile(1.0) == 4.0, "Extremes are exact");
+    ASSERT(QuantileSketch().quantile(0.5) == 0.0, "Empty sketch reports zero");
+
+    auto values = skewedValues(200000, 5);
+    for (double epsilon : {0.05, 0.01}) {
+        QuantileSketch sketch(QuantileSketch::kForRankError(epsilon));
+        ASSERT(sketch.rankError() <= epsilon, "k chosen for the requested error");
+        sketch.add(values.data(), values.size());
+        ASSERT(sketch.count() == values.size(), "Every value counted");
+        ASSERT(sketch.retained() < 4 * sketch.k(), "Stored values bounded by k");
+        ASSERT(worstRankError(sketch, values) <= epsilon, "Quantiles within the rank error");
+    }
+    return true;
+}
+
+bool testMergeAcrossShards() {
+    auto values = skewedValues(120000, 9);
+    QuantileSketch whole;
+    whole.add(values.data(), values.size());
+
+    // Uneven shards merged pairwise, as threads or files would be
+    std::vector<QuantileSketch> shards(6);
+    size_t begin = 0;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        size_t end = (i + 1 == shards.size()) ? values.size() : begin + 2000 * (i + 1) * (i + 1);
+        shards[i].add(values.data() + begin, end - begin);
+        begin = end;
+    }
+    QuantileSketch merged;
+    for (const auto& shard : shards) {
+        merged.merge(shard);
+    }
+    ASSERT(merged.count() == values.size(), "Merged count matches");
+    ASSERT(merged.min() == whole.min() && merged.max() == whole.max(), "Merged extremes match");
+    ASSERT(worstRankError(merged, values) <= merged.rankError(), "Merged sketch within rank error");
+
+    QuantileSketch coarse(50);
+    coarse.merge(merged);
+    ASSERT(coarse.k() == 50, "Merge keeps the smaller k");
+    merged.merge(merged);
+    ASSERT(merged.count() == 2 * values.size(), "Self-merge doubles the count");
+    return true;
+}
+
+bool testSerializeRoundTrip() {
+    auto values = skewedValues(50000, 13);
+    QuantileSketch sketch(100);
+    sketch.add(values.data(), values.size());
+
+    std::stringstream buffer;
+    sketch.serialize(buffer);
+    std::string bytes = buffer.str();
+    QuantileSketch restored = QuantileSketch::deserialize(buffer);
+    ASSERT(restored.count() == sketch.count() && restored.k() == sketch.k(), "Header restored");
+    for (double q : {0.01, 0.5, 0.99}) {
+        ASSERT(restored.quantile(q) == sketch.quantile(q), "Quantiles restored exactly");
+    }
+
+    bool threw = false;
+    try {
+        std::stringstream truncated(bytes.substr(0, bytes.size() / 2));
+        QuantileSketch::deserialize(truncated);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSERT(threw, "Truncated sketch throws");
+
+    // Approximate statistics saved by two runs merge into the statistics of both
+    ReadingBatch batch;
+    for (size_t i = 0; i < values.size(); ++i) {
+        batch.append("SKETCH_" + std::to_string(i % 3),
+                     static_cast<SensorReading::SensorType>(i % 2), values[i],
+                     static_cast<int64_t>(i));
+    }
+    StreamingStatistics whole(200), first(200), second(200);
+    whole.add(batch);
+    first.add(batch.slice(0, 20000));
+    second.add(batch.slice(20000, batch.size()));
+    std::stringstream file1, file2;
+    first.writeSketches(file1);
+    second.writeSketches(file2);
+
+    StreamingStatistics combined(200);
+    combined.mergeSketches(file1);
+    combined.mergeSketches(file2);
+    SensorStatistics expected = whole.overall();
+    SensorStatistics actual = combined.overall();
+    ASSERT(actual.count == expected.count && actual.min == expected.min &&
+           actual.max == expected.max, "Merged files keep exact count and extremes");
+    ASSERT(std::abs(actual.mean - expected.mean) < 1e-9, "Merged files keep the exact mean");
+    ASSERT(combined.bySensorId().size() == 3 && combined.byType().size() == 2,
+           "Merged files keep every group");
+    ASSERT(worstRankError(combined.overallSummary().sketch(), values) <= 0.02,
+           "Merged file quantiles within rank error");
+
+    StreamingStatistics exact;
+    std::stringstream file3;
+    first.writeSketches(file3);
+    threw = false;
+    try {
+        exact.mergeSketches(file3);
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    ASSERT(threw, "Exact statistics refuse sketch files");
+
+    // A corrupt string length must not become a huge allocation
+    std::string header = file1.str().substr(0, 12);
+    std::stringstream corrupt;
+    corrupt.write(header.data(), static_cast<std::streamsize>(header.size()));
+    for (uint32_t word : {uint32_t(1), uint32_t(0xFFFFFFF0)}) {
+        corrupt.write(reinterpret_cast<const char*>(&word), sizeof(word));
+    }
+    std::string error;
+    try {
+        combined.mergeSketches(corrupt);
+    } catch (const std::runtime_error& e) {
+        error = e.what();
+    }
+    ASSERT(error == "Invalid sketch file", "Oversized string length is rejected before reading");
+    return true;
+}
+
+std::pair<int, int> runQuantileSketchTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Rank Error Bound", testRankErrorBound);
+    runTest("Merge Across Shards", testMergeAcrossShards);
+    runTest("Serialize Round Trip", testSerializeRoundTrip);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_QUANTILE_SKETCH_H
+#define TEST_QUANTILE_SKETCH_H
+
+#include <utility>
+
+std::pair<int, int> runQuantileSketchTests();
+
+#endif // TEST_QUANTILE_SKETCH_H
@@ -0,0 +1,147 @@
+#include "test_ReadingBatch.h"
+#include "ReadingBatch.h"
+#include "SensorDataProcessor.h"
+#include <iostream>
+#include <cmath>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+#define ASSERT_APPROX(a, b, epsilon, message) \
+    ASSERT(std::abs((a) - (b)) < epsilon, message)
+
+static std::vector<SensorReading> sampleReadings() {
+    return {
+        SensorReading("S1", SensorReading::SensorType::TEMPERATURE, 20.0, 1000),
+        SensorReading("S2", SensorReading::SensorType::PRESSURE, 1013.0, 2000),
+        SensorReading("S1", SensorReading::SensorType::TEMPERATURE, 25.0, 3000),
+        SensorReading("S3", SensorReading::SensorType::DEPTH, 100.0, 4000)
+    };
+}
+
+bool testBatchRoundTrip() {
+    auto readings = sampleReadings();
+    ReadingBatch batch = ReadingBatch::fromReadings(readings);
+    ASSERT(batch.size() == 4, "Batch should have 4 rows");
+    ASSERT(batch.sensorKeys()[0] == batch.sensorKeys()[2], "Same ID should share a key");
+
+    auto back = batch.toReadings();
+    ASSERT(back.size() == readings.size(), "Round trip should keep row count");
+    for (size_t i = 0; i < readings.size(); ++i) {
+        ASSERT(back[i].getSensorId() == readings[i].getSensorId(), "Sensor ID should survive round trip");
+        ASSERT(back[i].getType() == readings[i].getType(), "Type should survive round trip");
+        ASSERT(back[i].getValue() == readings[i].getValue(), "Value should survive round trip");
+        ASSERT(back[i].getTimestamp() == readings[i].getTimestamp(), "Timestamp should survive round trip");
+    }
+    return true;
+}
+
+bool testBatchFilters() {
+    SensorDataProcessor processor;
+    ReadingBatch batch = ReadingBatch::fromReadings(sampleReadings());
+
+    auto byType = processor.filterByType(batch, SensorReading::SensorType::TEMPERATURE);
+    ASSERT(byType.size() == 2, "Should filter to 2 temperature readings");
+
+    auto byId = processor.filterBySensorId(batch, "S1");
+    ASSERT(byId.size() == 2, "Should filter to 2 readings from S1");
+    ASSERT(byId.sensorId(1) == "S1", "Filtered rows should keep their sensor ID");
+
+    auto missing = processor.filterBySensorId(batch, "S9");
+    ASSERT(missing.empty(), "Unknown sensor ID should match nothing");
+
+    auto byRange = processor.filterByValueRange(batch, 22.0, 500.0);
+    ASSERT(byRange.size() == 2, "Should filter to 2 readings in range");
+    ASSERT(byRange.values()[0] == 25.0, "First filtered value should be 25.0");
+    return true;
+}
+
+bool testBatchStatisticsMatchVector() {
+    SensorDataProcessor processor;
+    auto readings = sampleReadings();
+    ReadingBatch batch = ReadingBatch::fromReadings(readings);
+
+    auto vectorStats = processor.calculateStatistics(readings);
+    auto batchStats = processor.calculateStatistics(batch);
+    ASSERT(vectorStats.count == batchStats.count, "Counts should match");
+    ASSERT(vectorStats.min == batchStats.min, "Min should match");
+    ASSERT(vectorStats.max == batchStats.max, "Max should match");
+    ASSERT_APPROX(vectorStats.mean, batchStats.mean, 1e-9, "Mean should match");
+    ASSERT(vectorStats.median == batchStats.median, "Median should match");
+
+    auto bySensor = processor.calculateStatisticsBySensorId(batch);
+    ASSERT(bySensor.size() == 3, "Should have stats for 3 sensors");
+    ASSERT(bySensor["S1"].count == 2, "S1 should have 2 readings");
+    ASSERT_APPROX(bySensor["S1"].median, 22.5, 1e-9, "S1 median should be 22.5");
+    return true;
+}
+
+bool testBatchNormalize() {
+    SensorDataProcessor processor;
+    ReadingBatch batch = ReadingBatch::fromReadings(sampleReadings());
+    processor.normalizeValues(batch);
+    ASSERT(batch.values()[0] == 0.0, "Minimum should normalize to 0");
+    ASSERT(batch.values()[1] == 1.0, "Maximum should normalize to 1");
+    return true;
+}
+
+bool testBatchProcessInPieces() {
+    SensorDataProcessor processor;
+    std::vector<SensorReading> readings;
+    for (int i = 0; i < 20; ++i) {
+        readings.emplace_back("S1", SensorReading::SensorType::TEMPERATURE, 20.0 + i, 1000 + i);
+    }
+    readings.emplace_back("S1", SensorReading::SensorType::TEMPERATURE, 500.0, 5000);
+    readings.emplace_back("", SensorReading::SensorType::TEMPERATURE, 21.0, 6000);
+    ReadingBatch batch = ReadingBatch::fromReadings(readings);
+    ReadingBatch whole = processor.process(batch);
+
+    // Fences from the valid values, then each half filtered on its own
+    std::vector<double> validValues;
+    for (size_t row = 0; row < batch.size(); ++row) {
+        if (batch.isValid(row)) {
+            validValues.push_back(batch.values()[row]);
+        }
+    }
+    OutlierBounds bounds = processor.calculateOutlierBounds(validValues);
+    ReadingBatch first = batch.slice(0, 11);
+    ReadingBatch second = batch.slice(11, batch.size());
+    ReadingBatch pieces = processor.process(first, bounds);
+    pieces.append(processor.process(second, bounds));
+
+    ASSERT(whole.size() == 20, "Outlier and invalid reading should be removed");
+    ASSERT(pieces.size() == whole.size(), "Batch-wise processing should keep the same rows");
+    for (size_t row = 0; row < whole.size(); ++row) {
+        ASSERT(pieces.values()[row] == whole.values()[row], "Rows should match in order");
+    }
+    return true;
+}
+
+std::pair<int, int> runReadingBatchTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Round Trip", testBatchRoundTrip);
+    runTest("Filters", testBatchFilters);
+    runTest("Statistics Match Vector API", testBatchStatisticsMatchVector);
+    runTest("Normalize", testBatchNormalize);
+    runTest("Process In Pieces", testBatchProcessInPieces);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_READING_BATCH_H
+#define TEST_READING_BATCH_H
+
+#include <utility>
+
+std::pair<int, int> runReadingBatchTests();
+
+#endif // TEST_READING_BATCH_H
@@ -0,0 +1,173 @@
+#include "test_ReadingIndex.h"
+#include "ReadingIndex.h"
+#include "SensorDataProcessor.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+static std::vector<SensorReading> indexReadings(size_t count, unsigned seed) {
+    RandomReadingsSpec spec;
+    spec.sensorPrefix = "IDX_";
+    spec.sensorCount = 25;
+    std::normal_distribution<double> value(100.0, 15.0);
+    return randomReadings(count, seed, spec, [&](std::mt19937& gen, size_t) { return value(gen); });
+}
+
+static bool sameGroups(const std::vector<GroupStatistics>& a, const std::vector<GroupStatistics>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].key.type != b[i].key.type || a[i].key.sensorKey != b[i].key.sensorKey ||
+            a[i].stats.count != b[i].stats.count || a[i].stats.min != b[i].stats.min ||
+            a[i].stats.max != b[i].stats.max || a[i].stats.mean != b[i].stats.mean ||
+            a[i].stats.median != b[i].stats.median) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool testIndexPostingLists() {
+    ReadingBatch batch = ReadingBatch::fromReadings(indexReadings(5000, 1));
+    ReadingIndex index(batch);
+    ASSERT(index.rowCount() == batch.size(), "Index row count");
+
+    size_t total = 0;
+    for (size_t key = 0; key < index.sensorKeyLimit(); ++key) {
+        PostingList rows = index.rowsOfSensor(static_cast<SensorReading::SensorKey>(key));
+        for (const uint32_t* row = rows.begin(); row != rows.end(); ++row) {
+            ASSERT(batch.sensorKeys()[*row] == key, "Posting row carries its sensor key");
+            ASSERT(row == rows.begin() || *(row - 1) < *row, "Posting lists are ascending");
+        }
+        total += rows.size();
+    }
+    ASSERT(total == batch.size(), "Sensor postings cover every row once");
+
+    total = 0;
+    for (int code = 0; code < 6; ++code) {
+        auto type = static_cast<SensorReading::SensorType>(code);
+        for (uint32_t row : index.rowsOfType(type)) {
+            ASSERT(batch.types()[row] == type, "Posting row carries its type");
+        }
+        total += index.rowsOfType(type).size();
+    }
+    ASSERT(total == batch.size(), "Type postings cover every row once");
+    ASSERT(index.rowsOfSensor(index.sensorKeyLimit() + 10).empty(), "Unknown key has no rows");
+    return true;
+}
+
+bool testIndexedFiltersMatchScans() {
+    std::vector<SensorReading> readings = indexReadings(20000, 2);
+    ReadingBatch batch = ReadingBatch::fromReadings(readings);
+    SensorDataProcessor processor;
+
+    ReadingIndex batchIndex(batch);
+    for (int code = 0; code < 6; ++code) {
+        auto type = static_cast<SensorReading::SensorType>(code);
+        ASSERT(sameBatch(processor.filterByType(batch, type, batchIndex),
+                         processor.filterByType(batch, type)),
+               "Indexed type filter matches the scan");
+    }
+    for (const char* id : {"IDX_0", "IDX_7", "IDX_24", "IDX_MISSING"}) {
+        ASSERT(sameBatch(processor.filterBySensorId(batch, id, batchIndex),
+                         processor.filterBySensorId(batch, id)),
+               "Indexed sensor filter matches the scan");
+    }
+
+    ReadingIndex readingsIndex(readings);
+    auto byType = processor.filterByType(readings, SensorReading::SensorType::SONAR, readingsIndex);
+    auto expected = processor.filterByType(readings, SensorReading::SensorType::SONAR);
+    ASSERT(byType.size() == expected.size(), "Indexed vector type filter size");
+    for (size_t i = 0; i < byType.size(); ++i) {
+        ASSERT(byType[i].getTimestamp() == expected[i].getTimestamp(), "Vector filter keeps row order");
+    }
+    ASSERT(processor.filterBySensorId(readings, "IDX_3", readingsIndex).size() ==
+           processor.filterBySensorId(readings, "IDX_3").size(), "Indexed vector sensor filter");
+    return true;
+}
+
+bool testIndexedGroupedStatistics() {
+    std::vector<SensorReading> readings = indexReadings(30000, 3);
+    ReadingBatch batch = ReadingBatch::fromReadings(readings);
+    SensorDataProcessor scanning;
+    SensorDataProcessor indexed;
+    indexed.setThreadCount(4);
+
+    ReadingIndex batchIndex(batch);
+    for (GroupBy groupBy : {GroupBy::TYPE, GroupBy::SENSOR, GroupBy::TYPE_AND_SENSOR}) {
+        ASSERT(sameGroups(indexed.calculateGroupedStatistics(batch, groupBy, batchIndex),
+                          scanning.calculateGroupedStatistics(batch, groupBy)),
+               "Indexed grouped statistics match the scan exactly");
+    }
+
+    ReadingIndex readingsIndex(readings);
+    ASSERT(sameGroups(indexed.calculateGroupedStatistics(readings, GroupBy::TYPE_AND_SENSOR, readingsIndex),
+                      scanning.calculateGroupedStatistics(readings, GroupBy::TYPE_AND_SENSOR)),
+           "Indexed vector grouped statistics match the scan");
+    return true;
+}
+
+bool testIndexRejectsOtherData() {
+    ReadingBatch batch = ReadingBatch::fromReadings(indexReadings(2000, 4));
+    ReadingIndex index(batch);
+    SensorDataProcessor processor;
+
+    ReadingBatch grown = batch;
+    grown.append(batch);
+    bool threw = false;
+    try {
+        processor.filterByType(grown, SensorReading::SensorType::DEPTH, index);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT(threw, "Index over a different row count is rejected");
+
+    threw = false;
+    try {
+        processor.calculateGroupedStatistics(batch, GroupBy::TIME_BUCKET, index);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT(threw, "The index has no time buckets");
+
+    batch.values()[0] += 1.0;  // Values may change under the index
+    ASSERT(sameGroups(processor.calculateGroupedStatistics(batch, GroupBy::SENSOR, index),
+                      processor.calculateGroupedStatistics(batch, GroupBy::SENSOR)),
+           "Index stays valid after value updates");
+    return true;
+}
+
+std::pair<int, int> runReadingIndexTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Posting Lists", testIndexPostingLists);
+    runTest("Indexed Filters Match Scans", testIndexedFiltersMatchScans);
+    runTest("Indexed Grouped Statistics", testIndexedGroupedStatistics);
+    runTest("Index Rejects Other Data", testIndexRejectsOtherData);
+
+    return {testsRun, testsPassed};
+}
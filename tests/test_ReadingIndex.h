@@ -0,0 +1,8 @@
+#ifndef TEST_READING_INDEX_H
+#define TEST_READING_INDEX_H
+
+#include <utility>
+
+std::pair<int, int> runReadingIndexTests();
+
+#endif // TEST_READING_INDEX_H
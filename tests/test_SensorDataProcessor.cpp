@@ -3,6 +3,10 @@
 #include "SensorReading.h"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <stdexcept>
 
 #define ASSERT(condition, message) \
     do { \
@@ -156,6 +160,283 @@ bool testProcess() {
     return true;
 }
 
+bool testProcessFusedMatchesStaged() {
+    SensorDataProcessor processor;
+    
+    // Enough rows to span several bitmap words, with invalid rows and outliers
+    std::vector<SensorReading> readings;
+    for (int i = 0; i < 150; ++i) {
+        std::string id = (i % 17 == 0) ? "" : "S" + std::to_string(i % 5);
+        double value = (i % 40 == 0) ? 1000.0 + i : 20.0 + (i % 9);
+        readings.emplace_back(id, SensorReading::SensorType::TEMPERATURE, value, 1000 + i);
+    }
+    
+    // Reference: the staged pipeline (copy valid, then remove outliers)
+    std::vector<SensorReading> valid;
+    for (const auto& r : readings) {
+        if (r.isValid()) {
+            valid.push_back(r);
+        }
+    }
+    auto expected = processor.removeOutliers(valid);
+    
+    auto copied = processor.process(readings);
+    ASSERT(copied.size() == expected.size(), "Fused process should keep the staged row count");
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT(copied[i].getTimestamp() == expected[i].getTimestamp(), "Fused process should keep row order");
+    }
+    
+    auto moved = processor.process(std::vector<SensorReading>(readings));
+    ASSERT(moved.size() == expected.size(), "Move overload should keep the same rows");
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT(moved[i].getTimestamp() == expected[i].getTimestamp(), "Compaction should keep row order");
+        ASSERT(moved[i].getSensorId() == expected[i].getSensorId(), "Compaction should move whole rows");
+    }
+    
+    ReadingBatch batch = ReadingBatch::fromReadings(readings);
+    ReadingBatch batchCopied = processor.process(batch);
+    ReadingBatch batchMoved = processor.process(ReadingBatch(batch));
+    ASSERT(batchCopied.size() == expected.size(), "Batch process should keep the same rows");
+    ASSERT(batchMoved.size() == expected.size(), "Batch compaction should keep the same rows");
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT(batchCopied.timestamps()[i] == expected[i].getTimestamp(), "Batch rows should match");
+        ASSERT(batchMoved.timestamps()[i] == expected[i].getTimestamp(), "Compacted rows should match");
+        ASSERT(batchMoved.sensorKeys()[i] == expected[i].getSensorKey(), "Compacted keys should match");
+    }
+    
+    return true;
+}
+
+static std::vector<SensorReading> mixedTypeReadings() {
+    // Temperatures near 22 and pressures near 1013, each with one spike that a
+    // single fence over the mixed values cannot see
+    std::vector<SensorReading> readings;
+    for (int i = 0; i < 40; ++i) {
+        readings.emplace_back("T1", SensorReading::SensorType::TEMPERATURE, 20.0 + (i % 5), 1000 + 2 * i);
+        readings.emplace_back("P1", SensorReading::SensorType::PRESSURE, 1010.0 + (i % 7), 1001 + 2 * i);
+    }
+    readings.emplace_back("T1", SensorReading::SensorType::TEMPERATURE, 90.0, 5000);
+    readings.emplace_back("P1", SensorReading::SensorType::PRESSURE, 900.0, 5001);
+    return readings;
+}
+
+static bool containsValue(const std::vector<SensorReading>& readings, double value) {
+    return std::any_of(readings.begin(), readings.end(),
+                       [value](const SensorReading& r) { return r.getValue() == value; });
+}
+
+bool testGroupedOutlierRemoval() {
+    SensorDataProcessor processor;
+    auto readings = mixedTypeReadings();
+    
+    auto global = processor.removeOutliers(readings);
+    ASSERT(containsValue(global, 90.0), "Global fence should miss the temperature spike");
+    ASSERT(containsValue(global, 900.0), "Global fence should miss the pressure spike");
+    
+    for (OutlierGrouping grouping : {OutlierGrouping::TYPE, OutlierGrouping::SENSOR,
+                                     OutlierGrouping::TYPE_AND_SENSOR}) {
+        OutlierOptions options;
+        options.grouping = grouping;
+        processor.setOutlierOptions(options);
+        auto grouped = processor.removeOutliers(readings);
+        ASSERT(grouped.size() == readings.size() - 2, "Per-group fences should drop exactly the spikes");
+        ASSERT(!containsValue(grouped, 90.0) && !containsValue(grouped, 900.0), "Spikes should be removed");
+        ASSERT(grouped.front().getTimestamp() == 1000 && grouped[1].getTimestamp() == 1001,
+               "Survivors should stay in input order");
+        
+        // Batch path and precomputed per-group fences agree with the vector path
+        ReadingBatch batch = ReadingBatch::fromReadings(readings);
+        ReadingBatch processed = processor.process(batch);
+        std::vector<std::vector<double>> groupValues;
+        for (const auto& r : readings) {
+            size_t group = SensorDataProcessor::outlierGroupOf(grouping, r.getType(), r.getSensorKey());
+            if (group >= groupValues.size()) {
+                groupValues.resize(group + 1);
+            }
+            groupValues[group].push_back(r.getValue());
+        }
+        std::vector<OutlierBounds> bounds;
+        for (auto& values : groupValues) {
+            bounds.push_back(processor.calculateOutlierBounds(values));
+        }
+        ReadingBatch streamed = processor.process(batch, bounds, grouping);
+        ASSERT(processed.size() == grouped.size(), "Batch process should match vector path");
+        ASSERT(streamed.values() == processed.values(), "Precomputed fences should match process()");
+    }
+    return true;
+}
+
+bool testMadOutliers() {
+    SensorDataProcessor processor;
+    OutlierOptions options;
+    options.method = OutlierMethod::MAD;
+    options.grouping = OutlierGrouping::TYPE;
+    processor.setOutlierOptions(options);
+    
+    auto filtered = processor.removeOutliers(mixedTypeReadings());
+    ASSERT(!containsValue(filtered, 90.0) && !containsValue(filtered, 900.0), "MAD should drop the spikes");
+    ASSERT(containsValue(filtered, 24.0) && containsValue(filtered, 1016.0), "MAD should keep normal readings");
+    
+    // Constant values have zero MAD and zero mean deviation: keep them all
+    std::vector<double> flat(10, 5.0);
+    OutlierBounds bounds = processor.calculateOutlierBounds(flat);
+    ASSERT(std::isinf(bounds.lower) && std::isinf(bounds.upper), "Zero spread should be unbounded");
+    
+    // The caller's values may be reordered but not replaced by deviations
+    std::vector<double> values = {10.0, 12.0, 11.0, 50.0, 9.0, 13.0};
+    std::vector<double> original = values;
+    bounds = processor.calculateOutlierBounds(values);
+    ASSERT(bounds.upper < 50.0 && bounds.lower > 0.0, "MAD fences should exclude the spike");
+    std::sort(values.begin(), values.end());
+    std::sort(original.begin(), original.end());
+    ASSERT(values == original, "MAD should leave the input values intact");
+    return true;
+}
+
+bool testRollingIqrOutliers() {
+    SensorDataProcessor processor;
+    
+    // A slow upward drift: global fences accept a mid-series spike that is
+    // far outside its neighbourhood
+    std::vector<SensorReading> readings;
+    for (int i = 0; i < 200; ++i) {
+        double value = (i == 50) ? 160.0 : i + (i % 3) * 0.5;
+        readings.emplace_back("D1", SensorReading::SensorType::DEPTH, value, 1000 + i);
+    }
+    ASSERT(containsValue(processor.removeOutliers(readings), 160.0), "Global IQR should keep the spike");
+    
+    OutlierOptions options;
+    options.method = OutlierMethod::ROLLING_IQR;
+    options.window = 21;
+    processor.setOutlierOptions(options);
+    auto rolling = processor.removeOutliers(readings);
+    ASSERT(!containsValue(rolling, 160.0), "Rolling IQR should drop the local spike");
+    ASSERT(rolling.size() == readings.size() - 1, "Rolling IQR should keep the drifting series");
+    
+    // A window covering the whole group gives the global fences
+    options.window = readings.size();
+    processor.setOutlierOptions(options);
+    auto wide = processor.removeOutliers(readings);
+    processor.setOutlierOptions(OutlierOptions());
+    ASSERT(wide.size() == processor.removeOutliers(readings).size(), "Full-width window should match IQR");
+    
+    bool threw = false;
+    options.window = 64;
+    processor.setOutlierOptions(options);
+    std::vector<double> values(10, 1.0);
+    try {
+        processor.calculateOutlierBounds(values);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT(threw, "Rolling IQR has no single pair of fences");
+    return true;
+}
+
+bool testRollingIqrDropsNonFinite() {
+    SensorDataProcessor processor;
+    OutlierOptions options;
+    options.method = OutlierMethod::ROLLING_IQR;
+    options.window = 11;
+    processor.setOutlierOptions(options);
+
+    // Every 7th value NaN and the last one infinite: the finite values are
+    // fenced as if the others were never there
+    std::vector<SensorReading> readings;
+    std::vector<SensorReading> finite;
+    for (int i = 0; i < 200; ++i) {
+        double value = (i % 7 == 0) ? std::nan("") : 20.0 + (i % 4) + (i == 100 ? 50.0 : 0.0);
+        if (i == 199) {
+            value = std::numeric_limits<double>::infinity();
+        }
+        readings.emplace_back("T1", SensorReading::SensorType::TEMPERATURE, value, 1000 + i);
+        if (std::isfinite(value)) {
+            finite.push_back(readings.back());
+        }
+    }
+
+    auto kept = processor.removeOutliers(readings);
+    auto expected = processor.removeOutliers(finite);
+    ASSERT(!expected.empty() && !containsValue(expected, 70.0), "Rolling IQR should still drop the spike");
+    ASSERT(kept.size() == expected.size(), "Non-finite values should be dropped without moving the windows");
+    for (size_t i = 0; i < kept.size(); ++i) {
+        ASSERT(kept[i].getTimestamp() == expected[i].getTimestamp(), "Same finite survivors");
+    }
+
+    auto batch = ReadingBatch::fromReadings(readings);
+    ASSERT(processor.removeOutliers(batch).size() == expected.size(), "Batch path should match");
+    return true;
+}
+
+bool testSelectionMatchesSortedReference() {
+    SensorDataProcessor processor;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 20);  // Small range forces duplicates
+    
+    for (size_t n = 1; n <= 64; ++n) {
+        std::vector<double> values(n);
+        for (auto& value : values) {
+            value = dist(gen) * 0.5;
+        }
+        std::vector<double> sorted(values);
+        std::sort(sorted.begin(), sorted.end());
+        
+        std::vector<double> scratch(values);
+        auto stats = processor.calculateValueStatistics(scratch);
+        double median = (n % 2 == 0) ? (sorted[n/2 - 1] + sorted[n/2]) / 2.0 : sorted[n/2];
+        ASSERT(stats.min == sorted.front(), "Min should match sorted reference");
+        ASSERT(stats.max == sorted.back(), "Max should match sorted reference");
+        ASSERT(stats.median == median, "Median should match sorted reference");
+        
+        if (n >= 4) {
+            size_t i1 = n / 4;
+            size_t i3 = (3 * n) / 4;
+            double q1 = (n % 4 == 0 || n % 4 == 1) ? sorted[i1] : (sorted[i1] + sorted[i1 + 1]) / 2.0;
+            double q3 = (n % 4 == 0 || n % 4 == 3) ? sorted[i3] : (sorted[i3] + sorted[i3 + 1]) / 2.0;
+            scratch = values;
+            OutlierBounds bounds = processor.calculateOutlierBounds(scratch);
+            ASSERT(bounds.lower == q1 - 1.5 * (q3 - q1), "Lower fence should match sorted reference");
+            ASSERT(bounds.upper == q3 + 1.5 * (q3 - q1), "Upper fence should match sorted reference");
+        }
+    }
+    
+    return true;
+}
+
+bool testGroupedStatistics() {
+    SensorDataProcessor processor;
+    
+    std::vector<SensorReading> readings = {
+        SensorReading("S1", SensorReading::SensorType::TEMPERATURE, 20.0, 1000),
+        SensorReading("S1", SensorReading::SensorType::PRESSURE, 1013.0, 1500),
+        SensorReading("S1", SensorReading::SensorType::TEMPERATURE, 24.0, 2500),
+        SensorReading("S2", SensorReading::SensorType::TEMPERATURE, 30.0, 3100),
+        SensorReading("S2", SensorReading::SensorType::TEMPERATURE, 32.0, -200)
+    };
+    
+    auto byPair = processor.calculateGroupedStatistics(readings, GroupBy::TYPE_AND_SENSOR);
+    ASSERT(byPair.size() == 3, "Should have 3 (sensor, type) groups");
+    ASSERT(byPair[0].key.sensorKey == readings[0].getSensorKey() &&
+           byPair[0].key.type == SensorReading::SensorType::TEMPERATURE,
+           "First group should be S1 TEMPERATURE");
+    ASSERT(byPair[0].stats.count == 2, "S1 TEMPERATURE should have 2 readings");
+    ASSERT_APPROX(byPair[0].stats.median, 22.0, 0.01, "S1 TEMPERATURE median should be 22.0");
+    
+    auto byBucket = processor.calculateGroupedStatistics(readings, GroupBy::TIME_BUCKET, 1000);
+    ASSERT(byBucket.size() == 4, "Should have 4 one-second buckets");
+    ASSERT(byBucket[0].key.bucketStart == -1000, "Negative timestamps should floor to their bucket");
+    ASSERT(byBucket[1].key.bucketStart == 1000 && byBucket[1].stats.count == 2,
+           "Bucket [1000, 2000) should hold 2 readings");
+    ASSERT(byBucket[3].key.bucketStart == 3000, "Buckets should be ordered by start");
+    
+    auto batchBySensor = processor.calculateGroupedStatistics(
+        ReadingBatch::fromReadings(readings), GroupBy::SENSOR);
+    ASSERT(batchBySensor.size() == 2, "Batch overload should give 2 sensor groups");
+    ASSERT(batchBySensor[1].stats.count == 2, "S2 should have 2 readings");
+    
+    return true;
+}
+
 std::pair<int, int> runSensorDataProcessorTests() {
     int testsRun = 0;
     int testsPassed = 0;
@@ -178,6 +459,13 @@ std::pair<int, int> runSensorDataProcessorTests() {
     runTest("Calculate Statistics By Type", testCalculateStatisticsByType);
     runTest("Remove Outliers", testRemoveOutliers);
     runTest("Process", testProcess);
+    runTest("Process Fused Matches Staged", testProcessFusedMatchesStaged);
+    runTest("Grouped Outlier Removal", testGroupedOutlierRemoval);
+    runTest("MAD Outliers", testMadOutliers);
+    runTest("Rolling IQR Outliers", testRollingIqrOutliers);
+    runTest("Rolling IQR Drops Non-Finite", testRollingIqrDropsNonFinite);
+    runTest("Selection Matches Sorted Reference", testSelectionMatchesSortedReference);
+    runTest("Grouped Statistics", testGroupedStatistics);
     
     return {testsRun, testsPassed};
 }
@@ -47,6 +47,15 @@ bool testStringToType() {
            "PRESSURE string should convert correctly");
     ASSERT(SensorReading::stringToType("DEPTH") == SensorReading::SensorType::DEPTH,
            "DEPTH string should convert correctly");
+
+    SensorReading::SensorType type;
+    ASSERT(SensorReading::parseType("SONAR", type) && type == SensorReading::SensorType::SONAR,
+           "parseType should accept SONAR");
+    ASSERT(SensorReading::parseType("ACCELEROMETER", type) &&
+           type == SensorReading::SensorType::ACCELEROMETER,
+           "parseType should accept ACCELEROMETER");
+    ASSERT(!SensorReading::parseType("DEPTHS", type), "parseType should reject unknown names");
+    ASSERT(!SensorReading::parseType("", type), "parseType should reject empty names");
     return true;
 }
 
@@ -77,6 +86,23 @@ bool testSetters() {
     return true;
 }
 
+bool testSensorIdInterning() {
+    SensorIdTable& table = SensorIdTable::global();
+    SensorIdTable::Key key = table.intern("SENSOR_INTERN");
+    ASSERT(table.intern("SENSOR_INTERN") == key, "Interning twice should return the same key");
+    ASSERT(table.resolve(key) == "SENSOR_INTERN", "Key should resolve to its ID");
+    ASSERT(table.intern("") == SensorIdTable::kEmptyKey, "Empty ID should map to the reserved key");
+
+    SensorReading a("SENSOR_INTERN", SensorReading::SensorType::DEPTH, 1.0, 1000);
+    SensorReading b(key, SensorReading::SensorType::DEPTH, 2.0, 2000);
+    ASSERT(a.getSensorKey() == b.getSensorKey(), "Readings with the same ID should share a key");
+    ASSERT(b.getSensorId() == "SENSOR_INTERN", "Key-constructed reading should resolve its ID");
+
+    SensorIdTable::Key missing;
+    ASSERT(!table.find("SENSOR_NEVER_SEEN", missing), "Lookup should not intern");
+    return true;
+}
+
 std::pair<int, int> runSensorReadingTests() {
     int testsRun = 0;
     int testsPassed = 0;
@@ -98,6 +124,7 @@ std::pair<int, int> runSensorReadingTests() {
     runTest("String To Type", testStringToType);
     runTest("Is Valid", testIsValid);
     runTest("Setters", testSetters);
+    runTest("Sensor ID Interning", testSensorIdInterning);
     
     return {testsRun, testsPassed};
 }
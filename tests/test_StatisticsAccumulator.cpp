@@ -0,0 +1,121 @@
+#include "test_StatisticsAccumulator.h"
+#include "StatisticsAccumulator.h"
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+#define ASSERT_APPROX(a, b, epsilon, message) \
+    ASSERT(std::abs((a) - (b)) < epsilon, message)
+
+static std::vector<double> sampleValues(size_t count, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::normal_distribution<double> dist(50.0, 10.0);
+    std::vector<double> values(count);
+    for (auto& value : values) {
+        value = dist(gen);
+    }
+    return values;
+}
+
+bool testAccumulatorMoments() {
+    auto values = sampleValues(1000, 7);
+    StatisticsAccumulator acc;
+    acc.add(values.data(), values.size());
+
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    double mean = sum / values.size();
+    double squares = 0.0;
+    for (double v : values) squares += (v - mean) * (v - mean);
+    double variance = squares / (values.size() - 1);
+
+    ASSERT(acc.count() == 1000, "Count should be 1000");
+    ASSERT(acc.min() == *std::min_element(values.begin(), values.end()), "Min should be exact");
+    ASSERT(acc.max() == *std::max_element(values.begin(), values.end()), "Max should be exact");
+    ASSERT_APPROX(acc.mean(), mean, 1e-9, "Mean should match two-pass mean");
+    ASSERT_APPROX(acc.variance(), variance, 1e-6, "Variance should match two-pass variance");
+    return true;
+}
+
+bool testAccumulatorSmallMedian() {
+    StatisticsAccumulator empty;
+    ASSERT(empty.count() == 0 && empty.median() == 0.0, "Empty accumulator should report zeros");
+
+    StatisticsAccumulator acc;
+    acc.add(30.0);
+    acc.add(10.0);
+    acc.add(20.0);
+    ASSERT(acc.median() == 20.0, "Median of three values should be exact");
+    acc.add(40.0);
+    ASSERT(acc.median() == 25.0, "Median of four values should be exact");
+    ASSERT(acc.toStatistics().count == 4, "Snapshot should carry the count");
+    return true;
+}
+
+bool testAccumulatorMedianEstimate() {
+    auto values = sampleValues(20000, 11);
+    StatisticsAccumulator acc;
+    acc.add(values.data(), values.size());
+
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    double exact = values[values.size() / 2];
+    ASSERT_APPROX(acc.median(), exact, 0.5, "Streaming median should be close to exact median");
+    return true;
+}
+
+bool testAccumulatorMerge() {
+    auto values = sampleValues(10000, 3);
+    StatisticsAccumulator whole;
+    whole.add(values.data(), values.size());
+
+    // Uneven shards, including a tiny one the sketch still holds exactly
+    StatisticsAccumulator a, b, c;
+    a.add(values.data(), 3);
+    b.add(values.data() + 3, 6000);
+    c.add(values.data() + 6003, values.size() - 6003);
+    StatisticsAccumulator merged;
+    merged.merge(a);
+    merged.merge(b);
+    merged.merge(c);
+
+    ASSERT(merged.count() == whole.count(), "Merged count should match");
+    ASSERT(merged.min() == whole.min(), "Merged min should match");
+    ASSERT(merged.max() == whole.max(), "Merged max should match");
+    ASSERT_APPROX(merged.mean(), whole.mean(), 1e-9, "Merged mean should match");
+    ASSERT_APPROX(merged.variance(), whole.variance(), 1e-6, "Merged variance should match");
+    ASSERT_APPROX(merged.median(), whole.median(), 0.5, "Merged median should be close");
+    return true;
+}
+
+std::pair<int, int> runStatisticsAccumulatorTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Moments", testAccumulatorMoments);
+    runTest("Small Median", testAccumulatorSmallMedian);
+    runTest("Median Estimate", testAccumulatorMedianEstimate);
+    runTest("Merge", testAccumulatorMerge);
+
+    return {testsRun, testsPassed};
+}
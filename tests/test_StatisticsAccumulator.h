@@ -0,0 +1,8 @@
+#ifndef TEST_STATISTICS_ACCUMULATOR_H
+#define TEST_STATISTICS_ACCUMULATOR_H
+
+#include <utility>
+
+std::pair<int, int> runStatisticsAccumulatorTests();
+
+#endif // TEST_STATISTICS_ACCUMULATOR_H
@@ -0,0 +1,239 @@
+#include "test_StreamingSelector.h"
+#include "StreamingSelector.h"
+#include "StreamingStatistics.h"
+#include "SensorDataProcessor.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+#define ASSERT_APPROX(a, b, epsilon, message) \
+    ASSERT(std::abs((a) - (b)) < epsilon, message)
+
+// Replays the values of each group in order
+static StreamingSelector::Source replayGroups(const std::vector<std::vector<double>>& groups,
+                                              size_t& replays) {
+    return [&groups, &replays](const StreamingSelector::Sink& sink) {
+        ++replays;
+        for (size_t i = 0; ; ++i) {
+            bool any = false;
+            for (size_t group = 0; group < groups.size(); ++group) {
+                if (i < groups[group].size()) {
+                    sink(group, groups[group][i]);
+                    any = true;
+                }
+            }
+            if (!any) {
+                break;
+            }
+        }
+    };
+}
+
+bool testSelectionMatchesNthElement() {
+    std::mt19937 gen(17);
+    std::normal_distribution<double> normal(20.0, 5.0);
+    std::uniform_int_distribution<int> small(-3, 3);
+    std::vector<std::vector<double>> groups(4);
+    for (size_t i = 0; i < 200000; ++i) {
+        groups[0].push_back(normal(gen));
+        if (i % 2 == 0) {
+            groups[1].push_back(small(gen));  // Heavy duplicates
+        }
+        if (i % 50 == 0) {
+            groups[2].push_back(std::ldexp(normal(gen), small(gen) * 100));  // Wide exponents
+        }
+    }
+    groups[2].push_back(-0.0);
+    groups[3] = {42.0};
+
+    std::vector<StreamingSelector::Request> requests;
+    for (size_t group = 0; group < groups.size(); ++group) {
+        size_t n = groups[group].size();
+        for (uint64_t rank : {uint64_t(0), uint64_t(n / 4), uint64_t(n / 2), uint64_t(n - 1)}) {
+            requests.push_back(StreamingSelector::Request{group, rank});
+        }
+    }
+
+    for (size_t memoryBytes : {StreamingSelector::kMinMemoryBytes, size_t(64) << 20}) {
+        StreamingSelector selector(memoryBytes);
+        size_t replays = 0;
+        std::vector<double> selected = selector.select(replayGroups(groups, replays), requests);
+        ASSERT(selector.passCount() == replays, "Every pass is one replay");
+        ASSERT(replays >= 2, "At least one histogram and one collection pass");
+        for (size_t r = 0; r < requests.size(); ++r) {
+            std::vector<double> values = groups[requests[r].group];
+            std::nth_element(values.begin(), values.begin() + requests[r].rank, values.end());
+            ASSERT(selected[r] == values[requests[r].rank], "Selection matches nth_element");
+        }
+    }
+    return true;
+}
+
+bool testSelectionErrors() {
+    bool threw = false;
+    try {
+        StreamingSelector tooSmall(StreamingSelector::kMinMemoryBytes - 1);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT(threw, "A budget below the minimum is rejected");
+
+    std::vector<std::vector<double>> groups = {{1.0, 2.0, 3.0}};
+    size_t replays = 0;
+    StreamingSelector selector(StreamingSelector::kMinMemoryBytes);
+    threw = false;
+    try {
+        selector.select(replayGroups(groups, replays), {StreamingSelector::Request{0, 3}});
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    ASSERT(threw, "A rank past the group's values is rejected");
+
+    std::vector<StreamingSelector::Request> tooMany(100000, StreamingSelector::Request{0, 0});
+    threw = false;
+    try {
+        selector.select(replayGroups(groups, replays), tooMany);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    ASSERT(threw, "More requests than the budget holds are rejected");
+    return true;
+}
+
+bool testStreamedOutlierBoundsMatch() {
+    std::mt19937 gen(5);
+    std::normal_distribution<double> value(100.0, 10.0);
+    std::vector<std::vector<double>> groups(5);
+    for (size_t i = 0; i < 30000; ++i) {
+        groups[i % 3].push_back((i % 101 == 0) ? 1000.0 : value(gen));
+    }
+    groups[3] = {1.0, 2.0, 3.0};              // Too few for fences
+    groups[4] = std::vector<double>(10, 7.0);  // Zero MAD: mean deviation fallback
+    groups[4].push_back(9.0);
+    std::vector<size_t> counts;
+    for (const auto& group : groups) {
+        counts.push_back(group.size());
+    }
+
+    for (OutlierMethod method : {OutlierMethod::IQR, OutlierMethod::MAD}) {
+        OutlierOptions options;
+        options.method = method;
+        SensorDataProcessor processor;
+        processor.setOutlierOptions(options);
+        size_t replays = 0;
+        std::vector<OutlierBounds> streamed = processor.calculateOutlierBounds(
+            replayGroups(groups, replays), counts, StreamingSelector::kMinMemoryBytes);
+        ASSERT(streamed.size() == groups.size(), "One pair of fences per group");
+        for (size_t group = 0; group < groups.size(); ++group) {
+            std::vector<double> values = groups[group];
+            OutlierBounds expected = processor.calculateOutlierBounds(values);
+            if (std::isinf(expected.lower)) {
+                ASSERT(streamed[group].lower == expected.lower &&
+                       streamed[group].upper == expected.upper, "Unbounded groups stay unbounded");
+                continue;
+            }
+            ASSERT_APPROX(streamed[group].lower, expected.lower, 1e-9, "Streamed lower fence");
+            ASSERT_APPROX(streamed[group].upper, expected.upper, 1e-9, "Streamed upper fence");
+        }
+    }
+
+    OutlierOptions rolling;
+    rolling.method = OutlierMethod::ROLLING_IQR;
+    SensorDataProcessor processor;
+    processor.setOutlierOptions(rolling);
+    bool threw = false;
+    size_t replays = 0;
+    try {
+        processor.calculateOutlierBounds(replayGroups(groups, replays), counts,
+                                         StreamingSelector::kMinMemoryBytes);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT(threw, "Rolling IQR has no streamed fences");
+    return true;
+}
+
+bool testExactStreamingStatistics() {
+    RandomReadingsSpec spec;
+    spec.sensorPrefix = "SEL_";
+    spec.sensorCount = 7;
+    std::normal_distribution<double> value(50.0, 12.0);
+    ReadingBatch batch = randomBatch(40000, 9, spec, [&](std::mt19937& gen, size_t) {
+        return value(gen);
+    });
+
+    StreamingStatistics stats;
+    const size_t batchRows = 3000;
+    auto replay = [&](const StreamingStatistics::BatchSink& sink) {
+        for (size_t begin = 0; begin < batch.size(); begin += batchRows) {
+            sink(batch.slice(begin, std::min(batch.size(), begin + batchRows)));
+        }
+    };
+    replay([&stats](const ReadingBatch& part) { stats.add(part); });
+
+    bool threw = false;
+    try {
+        stats.overall();
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    ASSERT(threw, "Exact statistics need resolved medians");
+    ASSERT(stats.resolveMedians(replay, StreamingSelector::kMinMemoryBytes) >= 2,
+           "Medians are selected over several replays");
+
+    SensorDataProcessor processor;
+    auto same = [](const SensorStatistics& a, const SensorStatistics& b) {
+        return a.count == b.count && a.min == b.min && a.max == b.max &&
+               a.median == b.median && std::abs(a.mean - b.mean) < 1e-9;
+    };
+    ASSERT(same(stats.overall(), processor.calculateStatistics(batch)), "Exact overall statistics");
+    auto byType = stats.byType();
+    auto expectedByType = processor.calculateStatisticsByType(batch);
+    ASSERT(byType.size() == expectedByType.size(), "One entry per type");
+    for (const auto& pair : expectedByType) {
+        ASSERT(same(byType[pair.first], pair.second), "Exact per-type statistics");
+    }
+    auto bySensor = stats.bySensorId();
+    auto expectedBySensor = processor.calculateStatisticsBySensorId(batch);
+    ASSERT(bySensor.size() == expectedBySensor.size(), "One entry per sensor");
+    for (const auto& pair : expectedBySensor) {
+        ASSERT(same(bySensor[pair.first], pair.second), "Exact per-sensor statistics");
+    }
+    return true;
+}
+
+std::pair<int, int> runStreamingSelectorTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Selection Matches nth_element", testSelectionMatchesNthElement);
+    runTest("Selection Errors", testSelectionErrors);
+    runTest("Streamed Outlier Bounds Match", testStreamedOutlierBoundsMatch);
+    runTest("Exact Streaming Statistics", testExactStreamingStatistics);
+
+    return {testsRun, testsPassed};
+}
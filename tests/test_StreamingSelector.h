@@ -0,0 +1,8 @@
+#ifndef TEST_STREAMING_SELECTOR_H
+#define TEST_STREAMING_SELECTOR_H
+
+#include <utility>
+
+std::pair<int, int> runStreamingSelectorTests();
+
+#endif // TEST_STREAMING_SELECTOR_H
@@ -0,0 +1,133 @@
+#include "test_ThreadPool.h"
+#include "ThreadPool.h"
+#include "SensorDataProcessor.h"
+#include <iostream>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include <random>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+bool testPoolCoversEveryIndex() {
+    ThreadPool pool(4);
+    ASSERT(pool.size() == 4, "Pool should report the requested thread count");
+
+    std::vector<int> hits(10007, 0);
+    pool.parallelFor(hits.size(), 100, [&hits](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            hits[i]++;
+        }
+    });
+    for (int hit : hits) {
+        ASSERT(hit == 1, "Every index should be visited exactly once");
+    }
+    return true;
+}
+
+bool testPoolNestedAndReused() {
+    ThreadPool pool(3);
+    std::atomic<size_t> total(0);
+    for (int round = 0; round < 5; ++round) {
+        pool.parallelFor(8, 1, [&](size_t, size_t) {
+            // Nested calls from inside a task must not deadlock
+            pool.parallelFor(100, 10, [&](size_t begin, size_t end) {
+                total += end - begin;
+            });
+        });
+    }
+    ASSERT(total == 5 * 8 * 100, "Nested loops should all complete");
+    return true;
+}
+
+bool testPoolPropagatesException() {
+    ThreadPool pool(2);
+    bool caught = false;
+    try {
+        pool.parallelFor(100, 1, [](size_t begin, size_t) {
+            if (begin == 57) {
+                throw std::runtime_error("chunk failed");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    ASSERT(caught, "Chunk exception should reach the caller");
+
+    size_t count = 0;
+    pool.parallelFor(1, 5, [&count](size_t begin, size_t end) { count += end - begin; });
+    ASSERT(count == 1, "Pool should stay usable after an exception");
+    return true;
+}
+
+bool testProcessorParallelMatchesSerial() {
+    // More rows than one chunk so the parallel paths actually split
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+    ReadingBatch batch;
+    const char* ids[] = {"P1", "P2", "P3", "P4", ""};
+    for (size_t i = 0; i < 300000; ++i) {
+        double value = (i % 997 == 0) ? 1e6 : dist(gen);
+        batch.append(ids[i % 5], static_cast<SensorReading::SensorType>(i % 4),
+                     value, static_cast<int64_t>(1000 + i));
+    }
+
+    SensorDataProcessor serial;
+    SensorDataProcessor parallel;
+    parallel.setThreadCount(4);
+
+    ReadingBatch a = serial.process(batch);
+    ReadingBatch b = parallel.process(batch);
+    ASSERT(a.size() == b.size(), "Parallel process should keep the same rows");
+    ASSERT(a.values() == b.values() && a.timestamps() == b.timestamps(), "Parallel rows should match");
+
+    auto filteredA = serial.filterBySensorId(batch, "P2");
+    auto filteredB = parallel.filterBySensorId(batch, "P2");
+    ASSERT(filteredA.values() == filteredB.values(), "Parallel ID filter should match");
+
+    auto groupsA = serial.calculateGroupedStatistics(a, GroupBy::TYPE_AND_SENSOR);
+    auto groupsB = parallel.calculateGroupedStatistics(b, GroupBy::TYPE_AND_SENSOR);
+    ASSERT(groupsA.size() == groupsB.size(), "Group counts should match");
+    for (size_t i = 0; i < groupsA.size(); ++i) {
+        ASSERT(groupsA[i].stats.mean == groupsB[i].stats.mean, "Group means should be bit-identical");
+        ASSERT(groupsA[i].stats.median == groupsB[i].stats.median, "Group medians should match");
+    }
+
+    auto statsA = serial.calculateStatistics(a);
+    auto statsB = parallel.calculateStatistics(b);
+    ASSERT(statsA.mean == statsB.mean, "Overall mean should be bit-identical");
+
+    serial.normalizeValues(a);
+    parallel.normalizeValues(b);
+    ASSERT(a.values() == b.values(), "Parallel normalize should match");
+    return true;
+}
+
+std::pair<int, int> runThreadPoolTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Covers Every Index", testPoolCoversEveryIndex);
+    runTest("Nested And Reused", testPoolNestedAndReused);
+    runTest("Propagates Exception", testPoolPropagatesException);
+    runTest("Processor Parallel Matches Serial", testProcessorParallelMatchesSerial);
+
+    return {testsRun, testsPassed};
+}
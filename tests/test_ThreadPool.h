@@ -0,0 +1,8 @@
+#ifndef TEST_THREAD_POOL_H
+#define TEST_THREAD_POOL_H
+
+#include <utility>
+
+std::pair<int, int> runThreadPoolTests();
+
+#endif // TEST_THREAD_POOL_H
@@ -0,0 +1,176 @@
+#include "test_TimeIndexedStore.h"
+#include "TimeIndexedStore.h"
+#include "DataIngester.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+#define ASSERT_APPROX(a, b, epsilon, message) \
+    ASSERT(std::abs((a) - (b)) < epsilon, message)
+
+static ReadingBatch shuffledBatch(size_t count, unsigned seed, int64_t firstTimestamp) {
+    RandomReadingsSpec spec;
+    spec.sensorPrefix = "STORE_";
+    spec.sensorCount = 2;
+    spec.typeCount = 1;
+    spec.firstTimestamp = firstTimestamp;
+    spec.step = 20;
+    spec.randomStep = true;
+    spec.shuffled = true;
+    std::uniform_real_distribution<double> value(-50.0, 50.0);
+    return randomBatch(count, seed, spec, [&](std::mt19937& gen, size_t) { return value(gen); });
+}
+
+// Linear reference for a [t0, t1) query
+static std::vector<double> valuesInRange(const ReadingBatch& batch, int64_t t0, int64_t t1) {
+    std::vector<double> values;
+    for (size_t row = 0; row < batch.size(); ++row) {
+        if (batch.timestamps()[row] >= t0 && batch.timestamps()[row] < t1) {
+            values.push_back(batch.values()[row]);
+        }
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+static bool isTimeOrdered(const TimeIndexedStore& store) {
+    const auto& timestamps = store.readings().timestamps();
+    return std::is_sorted(timestamps.begin(), timestamps.end());
+}
+
+bool testStoreRangeScan() {
+    ReadingBatch batch = shuffledBatch(10000, 4, 1000);
+    TimeIndexedStore store(batch, 256);
+    ASSERT(store.size() == batch.size(), "Store keeps every reading");
+    ASSERT(store.blocks().size() == (batch.size() + 255) / 256, "Rows cut into fixed blocks");
+    ASSERT(isTimeOrdered(store), "Store is ordered by timestamp");
+
+    const int64_t last = store.readings().timestamps().back();
+    const std::vector<std::pair<int64_t, int64_t>> ranges = {
+        {1000, 1500}, {5000, 5001}, {20000, 60000}, {0, last + 1}, {last, last + 1},
+        {last + 1, last + 100}, {3000, 3000}, {4000, 2000}
+    };
+    for (const auto& range : ranges) {
+        ReadingBatch scanned = store.rangeScan(range.first, range.second);
+        std::vector<double> got(scanned.values().begin(), scanned.values().end());
+        std::sort(got.begin(), got.end());
+        ASSERT(got == valuesInRange(batch, range.first, range.second), "Range scan matches a linear filter");
+        for (int64_t timestamp : scanned.timestamps()) {
+            ASSERT(timestamp >= range.first && timestamp < range.second, "Scanned rows are in range");
+        }
+    }
+    return true;
+}
+
+bool testStoreRangeStatistics() {
+    ReadingBatch batch = shuffledBatch(8000, 9, 0);
+    TimeIndexedStore store(batch, 100);
+    SensorDataProcessor processor;
+
+    const std::vector<std::pair<int64_t, int64_t>> ranges = {
+        {0, 100}, {1234, 56789}, {0, 1000000}, {70000, 70010}
+    };
+    for (const auto& range : ranges) {
+        std::vector<double> expectedValues = valuesInRange(batch, range.first, range.second);
+        SensorStatistics expected = processor.calculateValueStatistics(expectedValues);
+        SensorStatistics got = store.rangeStatistics(range.first, range.second);
+        ASSERT(got.count == expected.count, "Range count");
+        ASSERT(got.min == expected.min, "Range min");
+        ASSERT(got.max == expected.max, "Range max");
+        ASSERT(got.median == expected.median, "Range median");
+        ASSERT_APPROX(got.mean, expected.mean, 1e-9, "Range mean");
+    }
+    ASSERT(store.rangeStatistics(-10, -1).count == 0, "Empty range has no readings");
+    return true;
+}
+
+bool testStoreAppendAndValueFilter() {
+    ReadingBatch first = shuffledBatch(3000, 21, 0);
+    ReadingBatch later = shuffledBatch(2000, 22, 1000000);
+    ReadingBatch overlapping = shuffledBatch(1000, 23, 20000);
+
+    TimeIndexedStore store(64);
+    store.append(first);
+    store.append(later);  // Strictly after: tail append
+    store.append(overlapping);  // Interleaves: merge
+    ASSERT(store.size() == 6000, "Every appended reading is kept");
+    ASSERT(isTimeOrdered(store), "Appends keep timestamp order");
+
+    size_t rowsInBlocks = 0;
+    for (size_t b = 0; b < store.blocks().size(); ++b) {
+        const TimeBlock& block = store.blocks()[b];
+        ASSERT(block.begin == rowsInBlocks, "Blocks are contiguous");
+        ASSERT(block.minTimestamp == store.readings().timestamps()[block.begin], "Block start time");
+        ASSERT(block.maxTimestamp == store.readings().timestamps()[block.end - 1], "Block end time");
+        rowsInBlocks = block.end;
+    }
+    ASSERT(rowsInBlocks == store.size(), "Blocks cover every row");
+
+    ReadingBatch all;
+    all.append(first);
+    all.append(later);
+    all.append(overlapping);
+    ReadingBatch filtered = store.rangeScan(10000, 1050000, 10.0, 20.0);
+    size_t expected = 0;
+    for (size_t row = 0; row < all.size(); ++row) {
+        int64_t timestamp = all.timestamps()[row];
+        double value = all.values()[row];
+        if (timestamp >= 10000 && timestamp < 1050000 && value >= 10.0 && value <= 20.0) {
+            ++expected;
+        }
+    }
+    ASSERT(filtered.size() == expected, "Value-filtered scan matches a linear filter");
+    for (double value : filtered.values()) {
+        ASSERT(value >= 10.0 && value <= 20.0, "Filtered values are in range");
+    }
+    return true;
+}
+
+bool testStoreLoadsFromIngester() {
+    const char* archivePath = "test_store.sdb";
+    ReadingBatch batch = shuffledBatch(500, 31, 1704067200000);
+    DataIngester ingester;
+    ASSERT(ingester.writeBinaryFile(batch, archivePath, 128), "Archive should be written");
+    TimeIndexedStore store = ingester.readTimeIndexedFile(archivePath, 1, 50);
+    std::remove(archivePath);
+
+    ASSERT(store.size() == batch.size(), "Store loads every archived reading");
+    ASSERT(store.blocks().size() == 10, "Store uses the requested block size");
+    ASSERT(isTimeOrdered(store), "Loaded store is ordered by timestamp");
+    return true;
+}
+
+std::pair<int, int> runTimeIndexedStoreTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Range Scan", testStoreRangeScan);
+    runTest("Range Statistics", testStoreRangeStatistics);
+    runTest("Append And Value Filter", testStoreAppendAndValueFilter);
+    runTest("Loads From Ingester", testStoreLoadsFromIngester);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_TIME_INDEXED_STORE_H
+#define TEST_TIME_INDEXED_STORE_H
+
+#include <utility>
+
+std::pair<int, int> runTimeIndexedStoreTests();
+
+#endif // TEST_TIME_INDEXED_STORE_H
@@ -0,0 +1,219 @@
+#include "test_TimeSeriesCodec.h"
+#include "TimeSeriesCodec.h"
+#include "DataIngester.h"
+#include "CompressedArchive.h"
+#include "DataGenerator.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+static bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+static bool roundTrips(const std::vector<int64_t>& timestamps, const std::vector<double>& values,
+                       size_t* encodedBytes = nullptr) {
+    std::vector<uint8_t> encoded;
+    TimeSeriesCodec::encodeBlock(timestamps.data(), values.data(), values.size(), encoded);
+    if (encodedBytes) {
+        *encodedBytes = encoded.size();
+    }
+    if (TimeSeriesCodec::maxRows(encoded.size()) < values.size()) {
+        return false;
+    }
+    std::vector<int64_t> decodedTimestamps(values.size());
+    std::vector<double> decodedValues(values.size());
+    TimeSeriesCodec::decodeBlock(encoded.data(), encoded.size(), values.size(),
+                                 decodedTimestamps.data(), decodedValues.data());
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (decodedTimestamps[i] != timestamps[i] || !sameBits(decodedValues[i], values[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool testBlockRoundTrip() {
+    // Regular sampling with repeated and slowly changing values stays tiny
+    std::vector<int64_t> timestamps;
+    std::vector<double> values;
+    for (int i = 0; i < 1000; ++i) {
+        timestamps.push_back(1704067200000 + i * 1000);
+        values.push_back(20.0 + (i / 100) * 0.5);
+    }
+    size_t bytes = 0;
+    ASSERT(roundTrips(timestamps, values, &bytes), "Regular stream round trips");
+    ASSERT(bytes < 300, "Regular stream costs about two bits per row");
+
+    // Jitter in every delta-of-delta bucket, and arbitrary value bit patterns
+    std::mt19937_64 gen(11);
+    const int64_t jitter[] = {0, 1, -63, 64, -255, 256, -2047, 2048, 5000, -1000000};
+    timestamps.clear();
+    values.clear();
+    int64_t t = -5;
+    for (int i = 0; i < 2000; ++i) {
+        t += 10 + jitter[gen() % std::size(jitter)];
+        timestamps.push_back(t);
+        uint64_t bits = gen();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        values.push_back(i % 7 == 0 ? values.empty() ? 1.0 : values.back() : value);
+    }
+    ASSERT(roundTrips(timestamps, values), "Jittered stream round trips");
+
+    // Extremes: wrapping timestamp deltas and special doubles
+    timestamps = {std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(),
+                  0, std::numeric_limits<int64_t>::max(), 1};
+    values = {0.0, -0.0, std::numeric_limits<double>::infinity(),
+              std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::max()};
+    ASSERT(roundTrips(timestamps, values), "Extreme values round trip");
+    ASSERT(roundTrips({42}, {3.5}), "Single row round trips");
+
+    // A truncated block is reported, not read past
+    std::vector<uint8_t> encoded;
+    TimeSeriesCodec::encodeBlock(timestamps.data(), values.data(), values.size(), encoded);
+    std::vector<int64_t> outTimestamps(values.size());
+    std::vector<double> outValues(values.size());
+    bool threw = false;
+    try {
+        TimeSeriesCodec::decodeBlock(encoded.data(), encoded.size() / 2, values.size(),
+                                     outTimestamps.data(), outValues.data());
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSERT(threw, "Truncated block throws");
+    return true;
+}
+
+bool testArchiveRoundTrip() {
+    GeneratorOptions options;
+    options.seed = 5;
+    options.sensorCount = 7;
+    DataGenerator generator(options);
+    ReadingBatch batch = generator.generate(20000);
+    batch.append("CODEC_ONLY", SensorReading::SensorType::GYROSCOPE, -12.25, 99);
+
+    const char* path = "test_codec.sdc";
+    DataIngester ingester;
+    ASSERT(ingester.writeCompressedFile(batch, path, 500), "Archive written");
+
+    CompressedArchiveReader reader(path);
+    ASSERT(reader.rowCount() == batch.size(), "Row count recorded");
+    ASSERT(reader.fileSize() < batch.size() * 16, "Archive smaller than raw columns");
+
+    // Every block is one stream, within block limits and summarised correctly
+    size_t rows = 0;
+    for (size_t i = 0; i < reader.blocks().size(); ++i) {
+        const auto& block = reader.blocks()[i];
+        ASSERT(block.rows > 0 && block.rows <= 500, "Block within size limit");
+        ReadingBatch decoded;
+        reader.decodeBlock(i, decoded);
+        ASSERT(decoded.size() == block.rows, "Block decodes its rows");
+        for (size_t row = 0; row < decoded.size(); ++row) {
+            ASSERT(decoded.sensorKeys()[row] == block.sensorKey &&
+                   decoded.types()[row] == block.type, "Block holds one stream");
+            ASSERT(decoded.timestamps()[row] >= block.minTimestamp &&
+                   decoded.timestamps()[row] <= block.maxTimestamp &&
+                   decoded.values()[row] >= block.minValue &&
+                   decoded.values()[row] <= block.maxValue, "Block summary covers rows");
+        }
+        rows += decoded.size();
+    }
+    ASSERT(rows == batch.size(), "Blocks cover every row");
+
+    // Per stream, rows come back in their original order with exact values
+    ReadingBatch serial = ingester.readCompressedFile(path, 1);
+    ReadingBatch parallel = reader.readAll(4);
+    ASSERT(serial.size() == batch.size() && parallel.size() == batch.size(), "All rows read");
+    auto streamOrder = [](const ReadingBatch& readings) {
+        std::vector<std::vector<std::pair<int64_t, double>>> streams;
+        for (size_t row = 0; row < readings.size(); ++row) {
+            size_t slot = readings.sensorKeys()[row] * 6 + static_cast<size_t>(readings.types()[row]);
+            if (slot >= streams.size()) {
+                streams.resize(slot + 1);
+            }
+            streams[slot].emplace_back(readings.timestamps()[row], readings.values()[row]);
+        }
+        return streams;
+    };
+    auto expected = streamOrder(batch);
+    ASSERT(streamOrder(serial) == expected, "Streams round trip in order");
+    ASSERT(streamOrder(parallel) == expected, "Parallel decode matches");
+    std::remove(path);
+
+    // Streaming through the generator produces the same archive contents
+    generator.writeFile(path, 20000, 3000);
+    ReadingBatch streamed = ingester.readCompressedFile(path);
+    batch.resize(20000);
+    ASSERT(streamOrder(streamed) == streamOrder(batch), "Generator writes .sdc");
+    std::remove(path);
+
+    bool threw = false;
+    try {
+        CompressedArchiveReader missing("test_codec_missing.sdc");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSERT(threw, "Missing archive throws");
+
+    // A directory entry claiming more rows than its block could hold is
+    // rejected when the archive is opened, before anything is allocated
+    ReadingBatch single;
+    single.append("CODEC_ONLY", SensorReading::SensorType::GYROSCOPE, 1.5, 7);
+    ASSERT(ingester.writeCompressedFile(single, path), "Single-row archive written");
+    {
+        // Footer tail: row count, block count, one 53-byte entry (row count
+        // at byte 5), footer offset, magic. Keep the totals consistent.
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        uint64_t totalRows = UINT32_MAX;
+        uint32_t rows = UINT32_MAX;
+        file.seekp(-(12 + 53 + 16), std::ios::end);
+        file.write(reinterpret_cast<const char*>(&totalRows), sizeof(totalRows));
+        file.seekp(-(12 + 53 - 5), std::ios::end);
+        file.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+    }
+    threw = false;
+    try {
+        CompressedArchiveReader corrupt(path);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    std::remove(path);
+    ASSERT(threw, "Oversized block row count throws");
+    return true;
+}
+
+std::pair<int, int> runTimeSeriesCodecTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Block Round Trip", testBlockRoundTrip);
+    runTest("Archive Round Trip", testArchiveRoundTrip);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_TIME_SERIES_CODEC_H
+#define TEST_TIME_SERIES_CODEC_H
+
+#include <utility>
+
+std::pair<int, int> runTimeSeriesCodecTests();
+
+#endif // TEST_TIME_SERIES_CODEC_H
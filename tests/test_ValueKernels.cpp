@@ -0,0 +1,159 @@
+#include "test_ValueKernels.h"
+#include "ValueKernels.h"
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <random>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+#define ASSERT_APPROX(a, b, epsilon, message) \
+    ASSERT(std::abs((a) - (b)) < epsilon, message)
+
+using ValueKernels::Isa;
+
+static const Isa kAllIsas[] = {Isa::SCALAR, Isa::SSE2, Isa::AVX2};
+
+// Odd length so every implementation runs its tail loop
+static std::vector<double> kernelValues() {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-100.0, 100.0);
+    std::vector<double> values(1003);
+    for (auto& value : values) {
+        value = dist(gen);
+    }
+    return values;
+}
+
+bool testKernelsMinMaxAndSum() {
+    auto values = kernelValues();
+    Isa original = ValueKernels::activeIsa();
+    ValueKernels::setIsa(Isa::SCALAR);
+    auto reference = ValueKernels::minMax(values.data(), values.size());
+    double referenceSum = ValueKernels::sum(values.data(), values.size());
+
+    bool ok = true;
+    for (Isa isa : kAllIsas) {
+        if (!ValueKernels::setIsa(isa)) {
+            continue;
+        }
+        for (size_t count : {size_t(1), size_t(7), values.size()}) {
+            auto expected = ValueKernels::minMax(values.data(), count);
+            ValueKernels::setIsa(Isa::SCALAR);
+            auto scalar = ValueKernels::minMax(values.data(), count);
+            ValueKernels::setIsa(isa);
+            ok = ok && expected.min == scalar.min && expected.max == scalar.max;
+        }
+        auto extremes = ValueKernels::minMax(values.data(), values.size());
+        ok = ok && extremes.min == reference.min && extremes.max == reference.max;
+        ok = ok && std::abs(ValueKernels::sum(values.data(), values.size()) - referenceSum) < 1e-9;
+    }
+    ValueKernels::setIsa(original);
+    ASSERT(ok, "Every implementation should match scalar min/max/sum");
+
+    // NaN anywhere, including first and in every lane position, is skipped
+    const double nan = std::nan("");
+    for (size_t i = 0; i < values.size(); i += 5) {
+        values[i] = nan;
+    }
+    values[1] = nan;
+    for (Isa isa : kAllIsas) {
+        if (!ValueKernels::setIsa(isa)) {
+            continue;
+        }
+        auto extremes = ValueKernels::minMax(values.data(), values.size());
+        ok = ok && !std::isnan(extremes.min) && !std::isnan(extremes.max);
+        ok = ok && extremes.min >= reference.min && extremes.max <= reference.max;
+        auto allNan = ValueKernels::minMax(values.data(), 2);
+        ok = ok && std::isnan(allNan.min) && std::isnan(allNan.max);
+        ValueKernels::setIsa(Isa::SCALAR);
+        auto scalar = ValueKernels::minMax(values.data(), values.size());
+        ok = ok && extremes.min == scalar.min && extremes.max == scalar.max;
+    }
+    ValueKernels::setIsa(original);
+    ASSERT(ok, "Every implementation should skip NaN alike");
+    return true;
+}
+
+bool testKernelsRangeSelection() {
+    auto values = kernelValues();
+    Isa original = ValueKernels::activeIsa();
+
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i] >= -10.0 && values[i] <= 25.0) {
+            expected.push_back(i);
+        }
+    }
+
+    bool ok = true;
+    for (Isa isa : kAllIsas) {
+        if (!ValueKernels::setIsa(isa)) {
+            continue;
+        }
+        std::vector<uint64_t> mask((values.size() + 63) / 64);
+        size_t bits = ValueKernels::rangeMask(values.data(), values.size(),
+                                              -10.0, 25.0, mask.data());
+        ok = ok && bits == expected.size();
+        for (size_t row : expected) {
+            ok = ok && ((mask[row / 64] >> (row % 64)) & 1);
+        }
+    }
+    ValueKernels::setIsa(original);
+    ASSERT(ok, "Every implementation should select the same rows");
+    return true;
+}
+
+bool testKernelsNormalize() {
+    auto values = kernelValues();
+    Isa original = ValueKernels::activeIsa();
+
+    std::vector<double> expected(values);
+    for (auto& value : expected) {
+        value = (value + 100.0) / 200.0;
+    }
+
+    bool ok = true;
+    for (Isa isa : kAllIsas) {
+        if (!ValueKernels::setIsa(isa)) {
+            continue;
+        }
+        std::vector<double> normalized(values);
+        ValueKernels::normalize(normalized.data(), normalized.size(), -100.0, 200.0);
+        ok = ok && normalized == expected;
+    }
+    ValueKernels::setIsa(original);
+    ASSERT(ok, "Every implementation should normalize bit-identically");
+    ASSERT(ValueKernels::setIsa(Isa::SCALAR), "Scalar kernels should always be available");
+    ValueKernels::setIsa(original);
+    return true;
+}
+
+std::pair<int, int> runValueKernelsTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    std::cout << "  (dispatching to " << ValueKernels::isaName(ValueKernels::activeIsa()) << ")\n";
+    runTest("Min/Max And Sum", testKernelsMinMaxAndSum);
+    runTest("Range Selection", testKernelsRangeSelection);
+    runTest("Normalize", testKernelsNormalize);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_VALUE_KERNELS_H
+#define TEST_VALUE_KERNELS_H
+
+#include <utility>
+
+std::pair<int, int> runValueKernelsTests();
+
+#endif // TEST_VALUE_KERNELS_H
@@ -0,0 +1,197 @@
+#include "test_WindowAggregator.h"
+#include "WindowAggregator.h"
+#include "SensorDataProcessor.h"
+#include "ReadingBatch.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+#define ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "FAIL: " << message << "\n"; \
+            return false; \
+        } \
+    } while(0)
+
+#define ASSERT_APPROX(a, b, epsilon, message) \
+    ASSERT(std::abs((a) - (b)) < epsilon, message)
+
+static ReadingBatch windowBatch(size_t count, unsigned seed, bool shuffled) {
+    RandomReadingsSpec spec;
+    spec.sensorPrefix = "WIN_";
+    spec.sensorCount = 3;
+    spec.typeCount = 3;
+    spec.firstTimestamp = 1000000;
+    spec.step = 40;
+    spec.randomStep = true;
+    spec.shuffled = shuffled;
+    std::uniform_real_distribution<double> value(0.0, 100.0);
+    return randomBatch(count, seed, spec, [&](std::mt19937& gen, size_t) { return value(gen); });
+}
+
+// Recompute one window from scratch for comparison
+static SensorStatistics bruteForceWindow(const ReadingBatch& batch, int64_t start, int64_t end,
+                                         SensorReading::SensorKey key,
+                                         SensorReading::SensorType type) {
+    std::vector<double> values;
+    for (size_t row = 0; row < batch.size(); ++row) {
+        if (batch.sensorKeys()[row] == key && batch.types()[row] == type &&
+            batch.timestamps()[row] >= start && batch.timestamps()[row] < end) {
+            values.push_back(batch.values()[row]);
+        }
+    }
+    SensorDataProcessor processor;
+    return processor.calculateValueStatistics(values);
+}
+
+bool testWindowTumblingMatchesBuckets() {
+    ReadingBatch batch = windowBatch(5000, 3, true);
+    WindowAggregator aggregator(60000, 60000, GroupBy::TIME_BUCKET);
+    aggregator.add(batch);
+    auto windows = aggregator.flush();
+
+    SensorDataProcessor processor;
+    auto buckets = processor.calculateGroupedStatistics(batch, GroupBy::TIME_BUCKET, 60000);
+    ASSERT(windows.size() == buckets.size(), "One window per non-empty bucket");
+    for (size_t i = 0; i < windows.size(); ++i) {
+        ASSERT(windows[i].windowStart == buckets[i].key.bucketStart, "Window start matches bucket");
+        ASSERT(windows[i].windowEnd == buckets[i].key.bucketStart + 60000, "Window end");
+        ASSERT(windows[i].stats.count == buckets[i].stats.count, "Window count");
+        ASSERT(windows[i].stats.min == buckets[i].stats.min, "Window min");
+        ASSERT(windows[i].stats.max == buckets[i].stats.max, "Window max");
+        ASSERT(windows[i].stats.median == buckets[i].stats.median, "Window median");
+        ASSERT_APPROX(windows[i].stats.mean, buckets[i].stats.mean, 1e-9, "Window mean");
+    }
+    return true;
+}
+
+bool testWindowHoppingMatchesBruteForce() {
+    ReadingBatch batch = windowBatch(3000, 11, false);
+    // 1500 does not divide 4000, so panes are 500 ms wide
+    WindowAggregator aggregator(4000, 1500, GroupBy::TYPE_AND_SENSOR);
+    aggregator.add(batch);
+    auto windows = aggregator.flush();
+    ASSERT(!windows.empty(), "Hopping windows emitted");
+
+    size_t covered = 0;
+    for (size_t i = 0; i < windows.size(); ++i) {
+        const auto& window = windows[i];
+        ASSERT(window.windowStart % 1500 == 0, "Windows start on the hop");
+        ASSERT(window.windowEnd - window.windowStart == 4000, "Windows span the window size");
+        if (i > 0) {
+            ASSERT(windows[i - 1].windowStart <= window.windowStart, "Windows ordered by start");
+        }
+        SensorStatistics expected = bruteForceWindow(batch, window.windowStart, window.windowEnd,
+                                                     window.key.sensorKey, window.key.type);
+        ASSERT(window.stats.count == expected.count, "Hopping count");
+        ASSERT(window.stats.min == expected.min, "Hopping min");
+        ASSERT(window.stats.max == expected.max, "Hopping max");
+        ASSERT(window.stats.median == expected.median, "Hopping median");
+        ASSERT_APPROX(window.stats.mean, expected.mean, 1e-9, "Hopping mean");
+        covered += window.stats.count;
+    }
+    // Each reading falls in 2 or 3 of the overlapping windows
+    ASSERT(covered >= 2 * batch.size() && covered <= 3 * batch.size(), "Readings counted per overlap");
+    return true;
+}
+
+bool testWindowIncrementalEmission() {
+    ReadingBatch batch = windowBatch(4000, 5, false);
+
+    WindowAggregator whole(2000, 500);
+    whole.add(batch);
+    auto expected = whole.flush();
+
+    WindowAggregator incremental(2000, 500);
+    std::vector<WindowStatistics> emitted;
+    for (size_t row = 0; row < batch.size(); ++row) {
+        int64_t timestamp = batch.timestamps()[row];
+        incremental.add(batch.sensorKeys()[row], batch.types()[row], batch.values()[row], timestamp);
+        for (const auto& window : incremental.takeClosed()) {
+            ASSERT(window.windowEnd <= timestamp, "Only closed windows are emitted");
+            emitted.push_back(window);
+        }
+    }
+    size_t beforeFlush = emitted.size();
+    ASSERT(beforeFlush > 0, "Windows emitted while streaming");
+    for (const auto& window : incremental.flush()) {
+        emitted.push_back(window);
+    }
+    ASSERT(incremental.lateCount() == 0, "In-order input has no late readings");
+    ASSERT(emitted.size() == expected.size(), "Streaming emits the same windows");
+
+    auto order = [](const WindowStatistics& a, const WindowStatistics& b) {
+        if (a.windowStart != b.windowStart) return a.windowStart < b.windowStart;
+        if (a.key.sensorKey != b.key.sensorKey) return a.key.sensorKey < b.key.sensorKey;
+        return a.key.type < b.key.type;
+    };
+    std::sort(emitted.begin(), emitted.end(), order);
+    for (size_t i = 0; i < emitted.size(); ++i) {
+        ASSERT(emitted[i].windowStart == expected[i].windowStart, "Same window start");
+        ASSERT(emitted[i].stats.count == expected[i].stats.count, "Same window count");
+        ASSERT(emitted[i].stats.median == expected[i].stats.median, "Same window median");
+        ASSERT_APPROX(emitted[i].stats.mean, expected[i].stats.mean, 1e-9, "Same window mean");
+    }
+    return true;
+}
+
+bool testWindowLateReadings() {
+    const auto type = SensorReading::SensorType::TEMPERATURE;
+    ReadingBatch ids;
+    ids.append("WIN_LATE", type, 0.0, 1);
+    SensorReading::SensorKey key = ids.sensorKeys()[0];
+
+    WindowAggregator aggregator(1000, 1000, GroupBy::TYPE_AND_SENSOR, 500);
+    aggregator.add(key, type, 1.0, 100);
+    aggregator.add(key, type, 2.0, 1400);
+    ASSERT(aggregator.takeClosed().empty(), "Lateness holds the first window open");
+    aggregator.add(key, type, 3.0, 900);  // Still within the allowed lateness
+    aggregator.add(key, type, 4.0, 1600);
+    auto closed = aggregator.takeClosed();
+    ASSERT(closed.size() == 1, "First window closes once the watermark passes it");
+    ASSERT(closed[0].windowStart == 0 && closed[0].stats.count == 2, "Late-but-allowed reading kept");
+    ASSERT_APPROX(closed[0].stats.mean, 2.0, 1e-12, "First window mean");
+
+    aggregator.add(key, type, 5.0, 200);  // Its window has been emitted
+    ASSERT(aggregator.lateCount() == 1, "Reading for an emitted window is late");
+    auto rest = aggregator.flush();
+    ASSERT(rest.size() == 1 && rest[0].stats.count == 2, "Second window on flush");
+    ASSERT(rest[0].stats.min == 2.0 && rest[0].stats.max == 4.0, "Second window range");
+
+    bool threw = false;
+    try {
+        WindowAggregator invalid(1000, 2000);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT(threw, "Hop larger than the window is rejected");
+    return true;
+}
+
+std::pair<int, int> runWindowAggregatorTests() {
+    int testsRun = 0;
+    int testsPassed = 0;
+
+    auto runTest = [&](const std::string& name, bool (*test)()) {
+        testsRun++;
+        std::cout << "  " << name << "... ";
+        if (test()) {
+            std::cout << "PASS\n";
+            testsPassed++;
+        } else {
+            std::cout << "FAIL\n";
+        }
+    };
+
+    runTest("Tumbling Matches Buckets", testWindowTumblingMatchesBuckets);
+    runTest("Hopping Matches Brute Force", testWindowHoppingMatchesBruteForce);
+    runTest("Incremental Emission", testWindowIncrementalEmission);
+    runTest("Late Readings", testWindowLateReadings);
+
+    return {testsRun, testsPassed};
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_WINDOW_AGGREGATOR_H
+#define TEST_WINDOW_AGGREGATOR_H
+
+#include <utility>
+
+std::pair<int, int> runWindowAggregatorTests();
+
+#endif // TEST_WINDOW_AGGREGATOR_H
@@ -0,0 +1,73 @@
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+#include "SensorReading.h"
+#include "ReadingBatch.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Shape of a seeded random dataset for tests
+ *
+ * Each row draws its timestamp step (if random), then a sensor and a type
+ * uniformly, then its value from the caller's value function.
+ */
+struct RandomReadingsSpec {
+    std::string sensorPrefix = "TEST_";  // Sensor IDs are prefix + index
+    int sensorCount = 10;
+    int typeCount = SensorReading::kTypeCount;  // Types are drawn from the first typeCount codes
+    int64_t firstTimestamp = 1704067200000;
+    int64_t step = 1;                    // Milliseconds between rows
+    bool randomStep = false;             // Draw each step from [0, step] instead
+    bool shuffled = false;               // Shuffle the rows after generating them
+};
+
+/**
+ * @brief Generate @p count readings; @p value(gen, row) gives each value
+ */
+template <typename ValueFn>
+std::vector<SensorReading> randomReadings(size_t count, unsigned seed,
+                                          const RandomReadingsSpec& spec, ValueFn value) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int64_t> step(0, spec.step);
+    std::uniform_int_distribution<int> sensor(0, spec.sensorCount - 1);
+    std::uniform_int_distribution<int> type(0, spec.typeCount - 1);
+
+    std::vector<SensorReading> readings;
+    readings.reserve(count);
+    int64_t timestamp = spec.firstTimestamp;
+    for (size_t i = 0; i < count; ++i) {
+        if (spec.randomStep) {
+            timestamp += step(gen);
+        } else {
+            timestamp = spec.firstTimestamp + static_cast<int64_t>(i) * spec.step;
+        }
+        std::string sensorId = spec.sensorPrefix + std::to_string(sensor(gen));
+        auto sensorType = static_cast<SensorReading::SensorType>(type(gen));
+        double v = value(gen, i);
+        readings.emplace_back(sensorId, sensorType, v, timestamp);
+    }
+    if (spec.shuffled) {
+        std::shuffle(readings.begin(), readings.end(), gen);
+    }
+    return readings;
+}
+
+template <typename ValueFn>
+ReadingBatch randomBatch(size_t count, unsigned seed,
+                         const RandomReadingsSpec& spec, ValueFn value) {
+    return ReadingBatch::fromReadings(randomReadings(count, seed, spec, value));
+}
+
+/**
+ * @brief Whether two batches hold the same rows in the same order
+ */
+inline bool sameBatch(const ReadingBatch& a, const ReadingBatch& b) {
+    return a.values() == b.values() && a.timestamps() == b.timestamps() &&
+           a.types() == b.types() && a.sensorKeys() == b.sensorKeys();
+}
+
+#endif // TEST_HELPERS_H
@@ -2,6 +2,22 @@
 #include <cassert>
 #include "test_SensorReading.h"
 #include "test_SensorDataProcessor.h"
+#include "test_ReadingBatch.h"
+#include "test_DataIngester.h"
+#include "test_StatisticsAccumulator.h"
+#include "test_ValueKernels.h"
+#include "test_ThreadPool.h"
+#include "test_WindowAggregator.h"
+#include "test_TimeIndexedStore.h"
+#include "test_ReadingIndex.h"
+#include "test_ProcessingArena.h"
+#include "test_Profiler.h"
+#include "test_LiveIngester.h"
+#include "test_DataGenerator.h"
+#include "test_CsvWriter.h"
+#include "test_TimeSeriesCodec.h"
+#include "test_QuantileSketch.h"
+#include "test_StreamingSelector.h"
 
 /**
  * Simple test framework for unit tests
@@ -24,6 +40,102 @@ int main() {
     testsRun += processorResults.first;
     testsPassed += processorResults.second;
     
+    // Run ReadingBatch tests
+    std::cout << "\n=== ReadingBatch Tests ===\n";
+    auto batchResults = runReadingBatchTests();
+    testsRun += batchResults.first;
+    testsPassed += batchResults.second;
+    
+    // Run DataIngester tests
+    std::cout << "\n=== DataIngester Tests ===\n";
+    auto ingesterResults = runDataIngesterTests();
+    testsRun += ingesterResults.first;
+    testsPassed += ingesterResults.second;
+    
+    // Run StatisticsAccumulator tests
+    std::cout << "\n=== StatisticsAccumulator Tests ===\n";
+    auto accumulatorResults = runStatisticsAccumulatorTests();
+    testsRun += accumulatorResults.first;
+    testsPassed += accumulatorResults.second;
+    
+    // Run ValueKernels tests
+    std::cout << "\n=== ValueKernels Tests ===\n";
+    auto kernelResults = runValueKernelsTests();
+    testsRun += kernelResults.first;
+    testsPassed += kernelResults.second;
+    
+    // Run ThreadPool tests
+    std::cout << "\n=== ThreadPool Tests ===\n";
+    auto poolResults = runThreadPoolTests();
+    testsRun += poolResults.first;
+    testsPassed += poolResults.second;
+    
+    // Run WindowAggregator tests
+    std::cout << "\n=== WindowAggregator Tests ===\n";
+    auto windowResults = runWindowAggregatorTests();
+    testsRun += windowResults.first;
+    testsPassed += windowResults.second;
+    
+    // Run TimeIndexedStore tests
+    std::cout << "\n=== TimeIndexedStore Tests ===\n";
+    auto storeResults = runTimeIndexedStoreTests();
+    testsRun += storeResults.first;
+    testsPassed += storeResults.second;
+    
+    // Run ReadingIndex tests
+    std::cout << "\n=== ReadingIndex Tests ===\n";
+    auto indexResults = runReadingIndexTests();
+    testsRun += indexResults.first;
+    testsPassed += indexResults.second;
+    
+    // Run ProcessingArena tests
+    std::cout << "\n=== ProcessingArena Tests ===\n";
+    auto arenaResults = runProcessingArenaTests();
+    testsRun += arenaResults.first;
+    testsPassed += arenaResults.second;
+    
+    // Run Profiler tests
+    std::cout << "\n=== Profiler Tests ===\n";
+    auto profilerResults = runProfilerTests();
+    testsRun += profilerResults.first;
+    testsPassed += profilerResults.second;
+    
+    // Run LiveIngester tests
+    std::cout << "\n=== LiveIngester Tests ===\n";
+    auto liveResults = runLiveIngesterTests();
+    testsRun += liveResults.first;
+    testsPassed += liveResults.second;
+    
+    // Run DataGenerator tests
+    std::cout << "\n=== DataGenerator Tests ===\n";
+    auto generatorResults = runDataGeneratorTests();
+    testsRun += generatorResults.first;
+    testsPassed += generatorResults.second;
+    
+    // Run CsvWriter tests
+    std::cout << "\n=== CsvWriter Tests ===\n";
+    auto csvResults = runCsvWriterTests();
+    testsRun += csvResults.first;
+    testsPassed += csvResults.second;
+    
+    // Run TimeSeriesCodec tests
+    std::cout << "\n=== TimeSeriesCodec Tests ===\n";
+    auto codecResults = runTimeSeriesCodecTests();
+    testsRun += codecResults.first;
+    testsPassed += codecResults.second;
+    
+    // Run QuantileSketch tests
+    std::cout << "\n=== QuantileSketch Tests ===\n";
+    auto sketchResults = runQuantileSketchTests();
+    testsRun += sketchResults.first;
+    testsPassed += sketchResults.second;
+    
+    // Run StreamingSelector tests
+    std::cout << "\n=== StreamingSelector Tests ===\n";
+    auto selectorResults = runStreamingSelectorTests();
+    testsRun += selectorResults.first;
+    testsPassed += selectorResults.second;
+    
     // Summary
     std::cout << "\n=== Test Summary ===\n";
     std::cout << "Tests run: " << testsRun << "\n";